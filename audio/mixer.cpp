@@ -22,6 +22,7 @@
 
 #include "gui/EventRecorder.h"
 
+#include "common/config-manager.h"
 #include "common/util.h"
 #include "common/textconsole.h"
 
@@ -43,7 +44,7 @@ namespace Audio {
  */
 class Channel {
 public:
-	Channel(Mixer *mixer, Mixer::SoundType type, AudioStream *stream, DisposeAfterUse::Flag autofreeStream, bool reverseStereo, int id, bool permanent);
+	Channel(Mixer *mixer, Mixer::SoundType type, AudioStream *stream, DisposeAfterUse::Flag autofreeStream, bool reverseStereo, int id, bool permanent, bool highQuality);
 	~Channel();
 
 	/**
@@ -178,10 +179,15 @@ private:
 #pragma mark -
 
 MixerImpl::MixerImpl(uint sampleRate)
-	: _mutex(), _sampleRate(sampleRate), _mixerReady(false), _handleSeed(0), _soundTypeSettings() {
+	: _mutex(), _sampleRate(sampleRate), _highQualityResampling(false), _mixerReady(false), _handleSeed(0), _soundTypeSettings() {
 
 	assert(sampleRate > 0);
 
+	// The polyphase resampler sounds noticeably better than linear
+	// interpolation when low rate samples are played, at some CPU cost
+	if (ConfMan.hasKey("audio_resampler", Common::ConfigManager::kApplicationDomain))
+		_highQualityResampling = (ConfMan.get("audio_resampler", Common::ConfigManager::kApplicationDomain) == "polyphase");
+
 	for (int i = 0; i != NUM_CHANNELS; i++)
 		_channels[i] = 0;
 }
@@ -265,7 +271,7 @@ void MixerImpl::playStream(
 #endif
 
 	// Create the channel
-	Channel *chan = new Channel(this, type, stream, autofreeStream, reverseStereo, id, permanent);
+	Channel *chan = new Channel(this, type, stream, autofreeStream, reverseStereo, id, permanent, _highQualityResampling);
 	chan->setVolume(volume);
 	chan->setBalance(balance);
 	insertChannel(handle, chan);
@@ -512,7 +518,7 @@ int MixerImpl::getVolumeForSoundType(SoundType type) const {
 #pragma mark -
 
 Channel::Channel(Mixer *mixer, Mixer::SoundType type, AudioStream *stream,
-				 DisposeAfterUse::Flag autofreeStream, bool reverseStereo, int id, bool permanent)
+				 DisposeAfterUse::Flag autofreeStream, bool reverseStereo, int id, bool permanent, bool highQuality)
 	: _type(type), _mixer(mixer), _id(id), _permanent(permanent), _volume(Mixer::kMaxChannelVolume),
 	  _balance(0), _pauseLevel(0), _samplesConsumed(0), _samplesDecoded(0), _mixerTimeStamp(0),
 	  _pauseStartTime(0), _pauseTime(0), _converter(0), _volL(0), _volR(0),
@@ -521,7 +527,7 @@ Channel::Channel(Mixer *mixer, Mixer::SoundType type, AudioStream *stream,
 	assert(stream);
 
 	// Get a rate converter instance
-	_converter = makeRateConverter(_stream->getRate(), mixer->getOutputRate(), _stream->isStereo(), reverseStereo);
+	_converter = makeRateConverter(_stream->getRate(), mixer->getOutputRate(), _stream->isStereo(), reverseStereo, highQuality);
 }
 
 Channel::~Channel() {
@@ -65,6 +65,7 @@ private:
 	Common::Mutex _mutex;
 
 	const uint _sampleRate;
+	bool _highQualityResampling;
 	bool _mixerReady;
 	uint32 _handleSeed;
 
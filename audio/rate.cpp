@@ -28,13 +28,30 @@
  * improvements over the original code were made.
  */
 
+#if defined(__SSE2__) && !defined(OUTPUT_UNSIGNED_AUDIO)
+#define USE_SSE2_MIXING
+#include <emmintrin.h>
+#elif (defined(__ARM_NEON) || defined(__ARM_NEON__)) && !defined(OUTPUT_UNSIGNED_AUDIO)
+#define USE_NEON_MIXING
+#include <arm_neon.h>
+#endif
+
 #include "audio/audiostream.h"
 #include "audio/rate.h"
 #include "audio/mixer.h"
+#include "common/algorithm.h"
+#include "common/array.h"
+#include "common/debug.h"
 #include "common/frac.h"
+#include "common/math.h"
+#include "common/ptr.h"
 #include "common/textconsole.h"
 #include "common/util.h"
 
+namespace Common {
+DECLARE_SINGLETON(Audio::PolyphaseFilterBankCache);
+}
+
 namespace Audio {
 
 
@@ -57,6 +74,173 @@ enum {
 	FRAC_HALF_LOW = (1L << (FRAC_BITS_LOW-1))
 };
 
+#pragma mark -
+
+/*
+ * Mixing of converted samples into the output buffer. The SIMD versions
+ * produce exactly the same result as the scalar ones: the products are
+ * computed in 32 bits and divided by kMaxMixerVolume rounding towards
+ * zero, and the final addition saturates like clampedAdd() does.
+ */
+
+static void mixStereoScalar(st_sample_t *obuf, const st_sample_t *ibuf, st_size_t osamp, st_volume_t vol_l, st_volume_t vol_r) {
+	for (; osamp > 0; osamp--) {
+		clampedAdd(obuf[0], (*ibuf++ * (int)vol_l) / Audio::Mixer::kMaxMixerVolume);
+		clampedAdd(obuf[1], (*ibuf++ * (int)vol_r) / Audio::Mixer::kMaxMixerVolume);
+		obuf += 2;
+	}
+}
+
+static void mixMonoScalar(st_sample_t *obuf, const st_sample_t *ibuf, st_size_t osamp, st_volume_t vol_l, st_volume_t vol_r) {
+	for (; osamp > 0; osamp--) {
+		const st_sample_t in = *ibuf++;
+		clampedAdd(obuf[0], (in * (int)vol_l) / Audio::Mixer::kMaxMixerVolume);
+		clampedAdd(obuf[1], (in * (int)vol_r) / Audio::Mixer::kMaxMixerVolume);
+		obuf += 2;
+	}
+}
+
+#if defined(USE_SSE2_MIXING)
+
+static inline __m128i scaleSamplesSSE2(__m128i in, __m128i vol) {
+	const __m128i lo = _mm_mullo_epi16(in, vol);
+	const __m128i hi = _mm_mulhi_epi16(in, vol);
+	__m128i p0 = _mm_unpacklo_epi16(lo, hi);
+	__m128i p1 = _mm_unpackhi_epi16(lo, hi);
+
+	// Divide by kMaxMixerVolume (256), rounding towards zero
+	const __m128i bias = _mm_set1_epi32(Audio::Mixer::kMaxMixerVolume - 1);
+	p0 = _mm_srai_epi32(_mm_add_epi32(p0, _mm_and_si128(_mm_srai_epi32(p0, 31), bias)), 8);
+	p1 = _mm_srai_epi32(_mm_add_epi32(p1, _mm_and_si128(_mm_srai_epi32(p1, 31), bias)), 8);
+
+	return _mm_packs_epi32(p0, p1);
+}
+
+static void mixStereoSIMD(st_sample_t *obuf, const st_sample_t *ibuf, st_size_t osamp, st_volume_t vol_l, st_volume_t vol_r) {
+	const __m128i vol = _mm_set_epi16(vol_r, vol_l, vol_r, vol_l, vol_r, vol_l, vol_r, vol_l);
+
+	for (; osamp >= 4; osamp -= 4) {
+		const __m128i in = _mm_loadu_si128((const __m128i *)ibuf);
+		const __m128i out = _mm_loadu_si128((const __m128i *)obuf);
+		_mm_storeu_si128((__m128i *)obuf, _mm_adds_epi16(out, scaleSamplesSSE2(in, vol)));
+		ibuf += 8;
+		obuf += 8;
+	}
+
+	mixStereoScalar(obuf, ibuf, osamp, vol_l, vol_r);
+}
+
+static void mixMonoSIMD(st_sample_t *obuf, const st_sample_t *ibuf, st_size_t osamp, st_volume_t vol_l, st_volume_t vol_r) {
+	const __m128i vol = _mm_set_epi16(vol_r, vol_l, vol_r, vol_l, vol_r, vol_l, vol_r, vol_l);
+
+	for (; osamp >= 8; osamp -= 8) {
+		const __m128i in = _mm_loadu_si128((const __m128i *)ibuf);
+		const __m128i out0 = _mm_loadu_si128((const __m128i *)obuf);
+		const __m128i out1 = _mm_loadu_si128((const __m128i *)(obuf + 8));
+		_mm_storeu_si128((__m128i *)obuf, _mm_adds_epi16(out0, scaleSamplesSSE2(_mm_unpacklo_epi16(in, in), vol)));
+		_mm_storeu_si128((__m128i *)(obuf + 8), _mm_adds_epi16(out1, scaleSamplesSSE2(_mm_unpackhi_epi16(in, in), vol)));
+		ibuf += 8;
+		obuf += 16;
+	}
+
+	mixMonoScalar(obuf, ibuf, osamp, vol_l, vol_r);
+}
+
+#elif defined(USE_NEON_MIXING)
+
+static inline int16x4_t scaleSamplesNEON(int16x4_t in, int16x4_t vol) {
+	int32x4_t p = vmull_s16(in, vol);
+
+	// Divide by kMaxMixerVolume (256), rounding towards zero
+	p = vaddq_s32(p, vandq_s32(vshrq_n_s32(p, 31), vdupq_n_s32(Audio::Mixer::kMaxMixerVolume - 1)));
+	return vqmovn_s32(vshrq_n_s32(p, 8));
+}
+
+static void mixStereoSIMD(st_sample_t *obuf, const st_sample_t *ibuf, st_size_t osamp, st_volume_t vol_l, st_volume_t vol_r) {
+	const int16x4_t vol = vreinterpret_s16_u32(vdup_n_u32(vol_l | (vol_r << 16)));
+
+	for (; osamp >= 4; osamp -= 4) {
+		const int16x8_t in = vld1q_s16(ibuf);
+		const int16x8_t scaled = vcombine_s16(scaleSamplesNEON(vget_low_s16(in), vol), scaleSamplesNEON(vget_high_s16(in), vol));
+		vst1q_s16(obuf, vqaddq_s16(vld1q_s16(obuf), scaled));
+		ibuf += 8;
+		obuf += 8;
+	}
+
+	mixStereoScalar(obuf, ibuf, osamp, vol_l, vol_r);
+}
+
+static void mixMonoSIMD(st_sample_t *obuf, const st_sample_t *ibuf, st_size_t osamp, st_volume_t vol_l, st_volume_t vol_r) {
+	const int16x4_t vol = vreinterpret_s16_u32(vdup_n_u32(vol_l | (vol_r << 16)));
+
+	for (; osamp >= 4; osamp -= 4) {
+		const int16x4x2_t in = vzip_s16(vld1_s16(ibuf), vld1_s16(ibuf));
+		const int16x8_t scaled = vcombine_s16(scaleSamplesNEON(in.val[0], vol), scaleSamplesNEON(in.val[1], vol));
+		vst1q_s16(obuf, vqaddq_s16(vld1q_s16(obuf), scaled));
+		ibuf += 4;
+		obuf += 8;
+	}
+
+	mixMonoScalar(obuf, ibuf, osamp, vol_l, vol_r);
+}
+
+#endif
+
+#if defined(USE_SSE2_MIXING) || defined(USE_NEON_MIXING)
+static bool s_simdMixing = true;
+#endif
+
+bool setSimdMixing(bool enable) {
+#if defined(USE_SSE2_MIXING) || defined(USE_NEON_MIXING)
+	s_simdMixing = enable;
+	return true;
+#else
+	return false;
+#endif
+}
+
+void mixStereoSamples(st_sample_t *obuf, const st_sample_t *ibuf, st_size_t osamp, st_volume_t vol_l, st_volume_t vol_r) {
+#if defined(USE_SSE2_MIXING) || defined(USE_NEON_MIXING)
+	// Larger volumes could overflow the intermediate 16 bit results
+	if (s_simdMixing && vol_l <= Audio::Mixer::kMaxMixerVolume && vol_r <= Audio::Mixer::kMaxMixerVolume) {
+		mixStereoSIMD(obuf, ibuf, osamp, vol_l, vol_r);
+		return;
+	}
+#endif
+	mixStereoScalar(obuf, ibuf, osamp, vol_l, vol_r);
+}
+
+void mixMonoSamples(st_sample_t *obuf, const st_sample_t *ibuf, st_size_t osamp, st_volume_t vol_l, st_volume_t vol_r) {
+#if defined(USE_SSE2_MIXING) || defined(USE_NEON_MIXING)
+	if (s_simdMixing && vol_l <= Audio::Mixer::kMaxMixerVolume && vol_r <= Audio::Mixer::kMaxMixerVolume) {
+		mixMonoSIMD(obuf, ibuf, osamp, vol_l, vol_r);
+		return;
+	}
+#endif
+	mixMonoScalar(obuf, ibuf, osamp, vol_l, vol_r);
+}
+
+
+#pragma mark -
+
+/**
+ * Mix converted samples, which are stored in the same channel order as the
+ * input stream, into the output buffer. For reversed stereo streams the
+ * samples are swapped in place first.
+ */
+template<bool stereo, bool reverseStereo>
+static inline void mixConvertedSamples(st_sample_t *obuf, st_sample_t *ibuf, st_size_t osamp, st_volume_t vol_l, st_volume_t vol_r) {
+	if (!stereo) {
+		mixMonoSamples(obuf, ibuf, osamp, vol_l, vol_r);
+	} else if (reverseStereo) {
+		for (st_size_t i = 0; i < osamp * 2; i += 2)
+			SWAP(ibuf[i], ibuf[i + 1]);
+		mixStereoSamples(obuf, ibuf, osamp, vol_r, vol_l);
+	} else {
+		mixStereoSamples(obuf, ibuf, osamp, vol_l, vol_r);
+	}
+}
+
 /**
  * Audio rate converter based on simple resampling. Used when no
  * interpolation is required.
@@ -70,6 +254,9 @@ protected:
 	const st_sample_t *inPtr;
 	int inLen;
 
+	/** converted samples waiting to be mixed into the output buffer */
+	st_sample_t outBuf[INTERMEDIATE_BUFFER_SIZE];
+
 	/** position of how far output is ahead of input */
 	/** Holds what would have been opos-ipos */
 	long opos;
@@ -114,6 +301,7 @@ SimpleRateConverter<stereo, reverseStereo>::SimpleRateConverter(st_rate_t inrate
 template<bool stereo, bool reverseStereo>
 int SimpleRateConverter<stereo, reverseStereo>::flow(AudioStream &input, st_sample_t *obuf, st_size_t osamp, st_volume_t vol_l, st_volume_t vol_r) {
 	st_sample_t *ostart, *oend;
+	st_sample_t *outPtr = outBuf;
 
 	ostart = obuf;
 	oend = obuf + osamp * 2;
@@ -126,8 +314,11 @@ int SimpleRateConverter<stereo, reverseStereo>::flow(AudioStream &input, st_samp
 			if (inLen == 0) {
 				inPtr = inBuf;
 				inLen = input.readBuffer(inBuf, ARRAYSIZE(inBuf));
-				if (inLen <= 0)
+				if (inLen <= 0) {
+					const st_size_t staged = (outPtr - outBuf) / (stereo ? 2 : 1);
+					mixConvertedSamples<stereo, reverseStereo>(obuf - staged * 2, outBuf, staged, vol_l, vol_r);
 					return (obuf - ostart) / 2;
+				}
 			}
 			inLen -= (stereo ? 2 : 1);
 			opos--;
@@ -136,21 +327,25 @@ int SimpleRateConverter<stereo, reverseStereo>::flow(AudioStream &input, st_samp
 			}
 		} while (opos >= 0);
 
-		st_sample_t out0, out1;
-		out0 = *inPtr++;
-		out1 = (stereo ? *inPtr++ : out0);
+		*outPtr++ = *inPtr++;
+		if (stereo)
+			*outPtr++ = *inPtr++;
 
 		// Increment output position
 		opos += opos_inc;
 
-		// output left channel
-		clampedAdd(obuf[reverseStereo    ], (out0 * (int)vol_l) / Audio::Mixer::kMaxMixerVolume);
-
-		// output right channel
-		clampedAdd(obuf[reverseStereo ^ 1], (out1 * (int)vol_r) / Audio::Mixer::kMaxMixerVolume);
-
 		obuf += 2;
+
+		// Mix the converted samples once the intermediate buffer is full
+		if (outPtr == outBuf + ARRAYSIZE(outBuf)) {
+			const st_size_t staged = ARRAYSIZE(outBuf) / (stereo ? 2 : 1);
+			mixConvertedSamples<stereo, reverseStereo>(obuf - staged * 2, outBuf, staged, vol_l, vol_r);
+			outPtr = outBuf;
+		}
 	}
+
+	const st_size_t staged = (outPtr - outBuf) / (stereo ? 2 : 1);
+	mixConvertedSamples<stereo, reverseStereo>(obuf - staged * 2, outBuf, staged, vol_l, vol_r);
 	return (obuf - ostart) / 2;
 }
 
@@ -172,6 +367,9 @@ protected:
 	const st_sample_t *inPtr;
 	int inLen;
 
+	/** converted samples waiting to be mixed into the output buffer */
+	st_sample_t outBuf[INTERMEDIATE_BUFFER_SIZE];
+
 	/** fractional position of the output stream in input stream unit */
 	frac_t opos;
 
@@ -223,6 +421,7 @@ LinearRateConverter<stereo, reverseStereo>::LinearRateConverter(st_rate_t inrate
 template<bool stereo, bool reverseStereo>
 int LinearRateConverter<stereo, reverseStereo>::flow(AudioStream &input, st_sample_t *obuf, st_size_t osamp, st_volume_t vol_l, st_volume_t vol_r) {
 	st_sample_t *ostart, *oend;
+	st_sample_t *outPtr = outBuf;
 
 	ostart = obuf;
 	oend = obuf + osamp * 2;
@@ -235,8 +434,11 @@ int LinearRateConverter<stereo, reverseStereo>::flow(AudioStream &input, st_samp
 			if (inLen == 0) {
 				inPtr = inBuf;
 				inLen = input.readBuffer(inBuf, ARRAYSIZE(inBuf));
-				if (inLen <= 0)
+				if (inLen <= 0) {
+					const st_size_t staged = (outPtr - outBuf) / (stereo ? 2 : 1);
+					mixConvertedSamples<stereo, reverseStereo>(obuf - staged * 2, outBuf, staged, vol_l, vol_r);
 					return (obuf - ostart) / 2;
+				}
 			}
 			inLen -= (stereo ? 2 : 1);
 			ilast0 = icur0;
@@ -252,24 +454,26 @@ int LinearRateConverter<stereo, reverseStereo>::flow(AudioStream &input, st_samp
 		// still space in the output buffer.
 		while (opos < (frac_t)FRAC_ONE_LOW && obuf < oend) {
 			// interpolate
-			st_sample_t out0, out1;
-			out0 = (st_sample_t)(ilast0 + (((icur0 - ilast0) * opos + FRAC_HALF_LOW) >> FRAC_BITS_LOW));
-			out1 = (stereo ?
-						  (st_sample_t)(ilast1 + (((icur1 - ilast1) * opos + FRAC_HALF_LOW) >> FRAC_BITS_LOW)) :
-						  out0);
-
-			// output left channel
-			clampedAdd(obuf[reverseStereo    ], (out0 * (int)vol_l) / Audio::Mixer::kMaxMixerVolume);
-
-			// output right channel
-			clampedAdd(obuf[reverseStereo ^ 1], (out1 * (int)vol_r) / Audio::Mixer::kMaxMixerVolume);
+			*outPtr++ = (st_sample_t)(ilast0 + (((icur0 - ilast0) * opos + FRAC_HALF_LOW) >> FRAC_BITS_LOW));
+			if (stereo)
+				*outPtr++ = (st_sample_t)(ilast1 + (((icur1 - ilast1) * opos + FRAC_HALF_LOW) >> FRAC_BITS_LOW));
 
 			obuf += 2;
 
 			// Increment output position
 			opos += opos_inc;
+
+			// Mix the converted samples once the intermediate buffer is full
+			if (outPtr == outBuf + ARRAYSIZE(outBuf)) {
+				const st_size_t staged = ARRAYSIZE(outBuf) / (stereo ? 2 : 1);
+				mixConvertedSamples<stereo, reverseStereo>(obuf - staged * 2, outBuf, staged, vol_l, vol_r);
+				outPtr = outBuf;
+			}
 		}
 	}
+
+	const st_size_t staged = (outPtr - outBuf) / (stereo ? 2 : 1);
+	mixConvertedSamples<stereo, reverseStereo>(obuf - staged * 2, outBuf, staged, vol_l, vol_r);
 	return (obuf - ostart) / 2;
 }
 
@@ -293,11 +497,8 @@ public:
 	virtual int flow(AudioStream &input, st_sample_t *obuf, st_size_t osamp, st_volume_t vol_l, st_volume_t vol_r) {
 		assert(input.isStereo() == stereo);
 
-		st_sample_t *ptr;
 		st_size_t len;
 
-		st_sample_t *ostart = obuf;
-
 		if (stereo)
 			osamp *= 2;
 
@@ -313,36 +514,237 @@ public:
 
 		// Read up to 'osamp' samples into our temporary buffer
 		len = input.readBuffer(_buffer, osamp);
+		if ((int)len <= 0)
+			return 0;
 
 		// Mix the data into the output buffer
-		ptr = _buffer;
-		for (; len > 0; len -= (stereo ? 2 : 1)) {
-			st_sample_t out0, out1;
-			out0 = *ptr++;
-			out1 = (stereo ? *ptr++ : out0);
+		len /= (stereo ? 2 : 1);
+		mixConvertedSamples<stereo, reverseStereo>(obuf, _buffer, len, vol_l, vol_r);
+		return len;
+	}
+
+	virtual int drain(st_sample_t *obuf, st_size_t osamp, st_volume_t vol) {
+		return ST_SUCCESS;
+	}
+};
 
-			// output left channel
-			clampedAdd(obuf[reverseStereo    ], (out0 * (int)vol_l) / Audio::Mixer::kMaxMixerVolume);
 
-			// output right channel
-			clampedAdd(obuf[reverseStereo ^ 1], (out1 * (int)vol_r) / Audio::Mixer::kMaxMixerVolume);
+#pragma mark -
 
-			obuf += 2;
+
+/**
+ * Filter bank of a polyphase resampler converting from inRate to outRate.
+ *
+ * Conceptually, the input is upsampled by inserting (phases - 1) zeros
+ * between consecutive samples, low-pass filtered by a windowed sinc, and
+ * every step-th sample is kept. Only the filter taps which hit non-zero
+ * input samples are evaluated, which splits the filter into 'phases'
+ * sub-filters of 'taps' coefficients each.
+ */
+struct PolyphaseFilterBank {
+	enum {
+		/** Number of taps per phase when upsampling */
+		kBaseTaps = 16,
+		/** Number of fractional bits of the coefficients */
+		kCoeffBits = 14,
+		/** Upper limit of phases * taps, to bound the memory usage */
+		kMaxCoeffs = 1 << 16
+	};
+
+	st_rate_t inRate, outRate;
+	uint phases;
+	uint step;
+	uint taps;
+
+	/**
+	 * Coefficients of each phase, ordered to be applied from the oldest to
+	 * the newest input sample.
+	 */
+	Common::Array<int16> coeffs;
+
+	PolyphaseFilterBank(st_rate_t inrate, st_rate_t outrate, uint phases_, uint step_);
+};
+
+PolyphaseFilterBank::PolyphaseFilterBank(st_rate_t inrate, st_rate_t outrate, uint phases_, uint step_)
+	: inRate(inrate), outRate(outrate), phases(phases_), step(step_) {
+	// When downsampling, the cutoff frequency is lowered and the filter
+	// has to be proportionally longer to keep the same transition band.
+	taps = kBaseTaps * ((step + phases - 1) / phases);
+	coeffs.resize(phases * taps);
+
+	const uint length = phases * taps;
+	const double center = (length - 1) / 2.0;
+	// Cutoff in cycles per upsampled sample, slightly below the lower Nyquist
+	// frequency to leave room for the transition band.
+	const double cutoff = 0.45 / MAX(phases, step);
+
+	Common::Array<double> proto(taps);
+	for (uint p = 0; p < phases; p++) {
+		double sum = 0.0;
+
+		for (uint k = 0; k < taps; k++) {
+			const double n = p + k * phases;
+			const double x = n - center;
+			const double sinc = (x == 0.0) ? 2.0 * cutoff : sin(2.0 * M_PI * cutoff * x) / (M_PI * x);
+			// Blackman window
+			const double w = 0.42 - 0.5 * cos(2.0 * M_PI * n / (length - 1)) + 0.08 * cos(4.0 * M_PI * n / (length - 1));
+			proto[k] = sinc * w;
+			sum += proto[k];
 		}
-		return (obuf - ostart) / 2;
+
+		// Normalize each phase to unity gain, which avoids any ripple of
+		// constant signals caused by the coefficient quantization.
+		for (uint k = 0; k < taps; k++)
+			coeffs[p * taps + (taps - 1 - k)] = (int16)floor(proto[k] / sum * (1 << kCoeffBits) + 0.5);
 	}
+}
 
-	virtual int drain(st_sample_t *obuf, st_size_t osamp, st_volume_t vol) {
+PolyphaseFilterBankCache::~PolyphaseFilterBankCache() {
+}
+
+Common::SharedPtr<PolyphaseFilterBank> PolyphaseFilterBankCache::getFilterBank(st_rate_t inrate, st_rate_t outrate) {
+	for (uint i = 0; i < _banks.size(); i++) {
+		if (_banks[i]->inRate == inrate && _banks[i]->outRate == outrate)
+			return _banks[i];
+	}
+
+	const uint divisor = Common::gcd<uint>(inrate, outrate);
+	const uint phases = outrate / divisor;
+	const uint step = inrate / divisor;
+	const uint taps = PolyphaseFilterBank::kBaseTaps * ((step + phases - 1) / phases);
+	if (phases > PolyphaseFilterBank::kMaxCoeffs || taps > PolyphaseFilterBank::kMaxCoeffs || phases * taps > PolyphaseFilterBank::kMaxCoeffs)
+		return Common::SharedPtr<PolyphaseFilterBank>();
+
+	Common::SharedPtr<PolyphaseFilterBank> bank(new PolyphaseFilterBank(inrate, outrate, phases, step));
+	_banks.push_back(bank);
+	return bank;
+}
+
+/**
+ * Audio rate converter based on a polyphase windowed-sinc filter.
+ *
+ * Much better quality than linear interpolation, especially when upsampling
+ * low rate samples, at the cost of evaluating a few dozen filter taps per
+ * output sample. Only rate pairs which lead to a filter bank of reasonable
+ * size are supported, see PolyphaseFilterBankCache::getFilterBank().
+ */
+template<bool stereo, bool reverseStereo>
+class PolyphaseRateConverter : public RateConverter {
+protected:
+	st_sample_t inBuf[INTERMEDIATE_BUFFER_SIZE];
+	const st_sample_t *inPtr;
+	int inLen;
+
+	/** converted samples waiting to be mixed into the output buffer */
+	st_sample_t outBuf[INTERMEDIATE_BUFFER_SIZE];
+
+	Common::SharedPtr<PolyphaseFilterBank> _bank;
+
+	/**
+	 * Last input samples of each channel. Every sample is stored twice,
+	 * taps entries apart, so that the newest taps samples are always
+	 * contiguous, starting at _histPos.
+	 */
+	Common::Array<st_sample_t> _history[2];
+	uint _histPos;
+
+	/** phase of the next output sample */
+	uint _phase;
+
+	inline st_sample_t applyFilter(const st_sample_t *hist, const int16 *coeffs) const {
+		int acc = 1 << (PolyphaseFilterBank::kCoeffBits - 1);
+		for (uint k = 0; k < _bank->taps; k++)
+			acc += hist[k] * coeffs[k];
+		acc >>= PolyphaseFilterBank::kCoeffBits;
+		return (st_sample_t)CLIP<int>(acc, ST_SAMPLE_MIN, ST_SAMPLE_MAX);
+	}
+
+public:
+	PolyphaseRateConverter(const Common::SharedPtr<PolyphaseFilterBank> &bank);
+	int flow(AudioStream &input, st_sample_t *obuf, st_size_t osamp, st_volume_t vol_l, st_volume_t vol_r);
+	int drain(st_sample_t *obuf, st_size_t osamp, st_volume_t vol) {
 		return ST_SUCCESS;
 	}
 };
 
+template<bool stereo, bool reverseStereo>
+PolyphaseRateConverter<stereo, reverseStereo>::PolyphaseRateConverter(const Common::SharedPtr<PolyphaseFilterBank> &bank)
+	: _bank(bank), _histPos(0), _phase(bank->phases) {
+	_history[0].resize(_bank->taps * 2);
+	if (stereo)
+		_history[1].resize(_bank->taps * 2);
+
+	inLen = 0;
+}
+
+template<bool stereo, bool reverseStereo>
+int PolyphaseRateConverter<stereo, reverseStereo>::flow(AudioStream &input, st_sample_t *obuf, st_size_t osamp, st_volume_t vol_l, st_volume_t vol_r) {
+	st_sample_t *ostart, *oend;
+	st_sample_t *outPtr = outBuf;
+	const uint taps = _bank->taps;
+
+	ostart = obuf;
+	oend = obuf + osamp * 2;
+
+	while (obuf < oend) {
+
+		// Feed the input samples which precede the next output sample
+		while (_phase >= _bank->phases) {
+			// Check if we have to refill the buffer
+			if (inLen == 0) {
+				inPtr = inBuf;
+				inLen = input.readBuffer(inBuf, ARRAYSIZE(inBuf));
+				if (inLen <= 0) {
+					const st_size_t staged = (outPtr - outBuf) / (stereo ? 2 : 1);
+					mixConvertedSamples<stereo, reverseStereo>(obuf - staged * 2, outBuf, staged, vol_l, vol_r);
+					return (obuf - ostart) / 2;
+				}
+			}
+			inLen -= (stereo ? 2 : 1);
+			_history[0][_histPos] = _history[0][_histPos + taps] = *inPtr++;
+			if (stereo)
+				_history[1][_histPos] = _history[1][_histPos + taps] = *inPtr++;
+			if (++_histPos == taps)
+				_histPos = 0;
+			_phase -= _bank->phases;
+		}
+
+		const int16 *coeffs = &_bank->coeffs[_phase * taps];
+		*outPtr++ = applyFilter(&_history[0][_histPos], coeffs);
+		if (stereo)
+			*outPtr++ = applyFilter(&_history[1][_histPos], coeffs);
+
+		obuf += 2;
+
+		// Increment output position
+		_phase += _bank->step;
+
+		// Mix the converted samples once the intermediate buffer is full
+		if (outPtr == outBuf + ARRAYSIZE(outBuf)) {
+			const st_size_t staged = ARRAYSIZE(outBuf) / (stereo ? 2 : 1);
+			mixConvertedSamples<stereo, reverseStereo>(obuf - staged * 2, outBuf, staged, vol_l, vol_r);
+			outPtr = outBuf;
+		}
+	}
+
+	const st_size_t staged = (outPtr - outBuf) / (stereo ? 2 : 1);
+	mixConvertedSamples<stereo, reverseStereo>(obuf - staged * 2, outBuf, staged, vol_l, vol_r);
+	return (obuf - ostart) / 2;
+}
+
 
 #pragma mark -
 
 template<bool stereo, bool reverseStereo>
-RateConverter *makeRateConverter(st_rate_t inrate, st_rate_t outrate) {
+RateConverter *makeRateConverter(st_rate_t inrate, st_rate_t outrate, bool highQuality) {
 	if (inrate != outrate) {
+		if (highQuality) {
+			Common::SharedPtr<PolyphaseFilterBank> bank = PolyphaseFilterBankCache::instance().getFilterBank(inrate, outrate);
+			if (bank)
+				return new PolyphaseRateConverter<stereo, reverseStereo>(bank);
+			debug(1, "makeRateConverter: No polyphase filter for %d Hz to %d Hz, using linear interpolation", inrate, outrate);
+		}
+
 		if ((inrate % outrate) == 0 && (inrate < 65536)) {
 			return new SimpleRateConverter<stereo, reverseStereo>(inrate, outrate);
 		} else {
@@ -356,14 +758,14 @@ RateConverter *makeRateConverter(st_rate_t inrate, st_rate_t outrate) {
 /**
  * Create and return a RateConverter object for the specified input and output rates.
  */
-RateConverter *makeRateConverter(st_rate_t inrate, st_rate_t outrate, bool stereo, bool reverseStereo) {
+RateConverter *makeRateConverter(st_rate_t inrate, st_rate_t outrate, bool stereo, bool reverseStereo, bool highQuality) {
 	if (stereo) {
 		if (reverseStereo)
-			return makeRateConverter<true, true>(inrate, outrate);
+			return makeRateConverter<true, true>(inrate, outrate, highQuality);
 		else
-			return makeRateConverter<true, false>(inrate, outrate);
+			return makeRateConverter<true, false>(inrate, outrate, highQuality);
 	} else
-		return makeRateConverter<false, false>(inrate, outrate);
+		return makeRateConverter<false, false>(inrate, outrate, highQuality);
 }
 
 } // End of namespace Audio
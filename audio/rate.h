@@ -24,6 +24,9 @@
 #define AUDIO_RATE_H
 
 #include "common/scummsys.h"
+#include "common/array.h"
+#include "common/ptr.h"
+#include "common/singleton.h"
 
 namespace Audio {
 /**
@@ -72,6 +75,38 @@ static inline void clampedAdd(int16& a, int b) {
 #endif
 }
 
+/**
+ * Mix interleaved stereo samples into an interleaved stereo output buffer,
+ * scaling them by the given volumes and clamping the result.
+ *
+ * @param obuf  Output buffer, @p osamp sample pairs.
+ * @param ibuf  Input buffer, @p osamp sample pairs.
+ * @param osamp Number of sample pairs to mix.
+ * @param vol_l Volume applied to the left channel.
+ * @param vol_r Volume applied to the right channel.
+ */
+void mixStereoSamples(st_sample_t *obuf, const st_sample_t *ibuf, st_size_t osamp, st_volume_t vol_l, st_volume_t vol_r);
+
+/**
+ * Mix mono samples into both channels of an interleaved stereo output buffer,
+ * scaling them by the given volumes and clamping the result.
+ *
+ * @param obuf  Output buffer, @p osamp sample pairs.
+ * @param ibuf  Input buffer, @p osamp samples.
+ * @param osamp Number of samples to mix.
+ * @param vol_l Volume applied to the left channel.
+ * @param vol_r Volume applied to the right channel.
+ */
+void mixMonoSamples(st_sample_t *obuf, const st_sample_t *ibuf, st_size_t osamp, st_volume_t vol_l, st_volume_t vol_r);
+
+/**
+ * Select whether the mixing functions above use the SIMD implementation
+ * available for the current CPU. SIMD is used by default when available.
+ *
+ * @return true if a SIMD implementation is available, false otherwise.
+ */
+bool setSimdMixing(bool enable);
+
 class RateConverter {
 public:
 	RateConverter() {}
@@ -85,7 +120,41 @@ public:
 	virtual int drain(st_sample_t *obuf, st_size_t osamp, st_volume_t vol) = 0;
 };
 
-RateConverter *makeRateConverter(st_rate_t inrate, st_rate_t outrate, bool stereo, bool reverseStereo = false);
+/**
+ * Create a rate converter for the given input and output rates.
+ *
+ * @param highQuality Resample through a polyphase windowed-sinc filter instead
+ *                    of linear interpolation when the rates differ. This costs
+ *                    more CPU time. The filter banks are computed once per pair
+ *                    of rates and shared between converters, so converters of
+ *                    this kind must only be created from one thread at a time.
+ */
+RateConverter *makeRateConverter(st_rate_t inrate, st_rate_t outrate, bool stereo, bool reverseStereo = false, bool highQuality = false);
+
+struct PolyphaseFilterBank;
+
+/**
+ * Filter banks of the polyphase rate converters, shared between all the
+ * converters for the same pair of rates. The banks are kept until the cache
+ * is destroyed, converters which are still alive keep their own reference.
+ */
+class PolyphaseFilterBankCache : public Common::Singleton<PolyphaseFilterBankCache> {
+public:
+	~PolyphaseFilterBankCache();
+
+	/**
+	 * Return the filter bank for the given rates, or a null pointer if the
+	 * rates would need an unreasonably large one.
+	 */
+	Common::SharedPtr<PolyphaseFilterBank> getFilterBank(st_rate_t inrate, st_rate_t outrate);
+
+private:
+	friend class Common::Singleton<SingletonBaseType>;
+	PolyphaseFilterBankCache() {}
+
+	Common::Array<Common::SharedPtr<PolyphaseFilterBank> > _banks;
+};
+
 /** @} */
 } // End of namespace Audio
 
@@ -173,6 +173,20 @@ public:
 	 */
 	virtual bool isWritable() const = 0;
 
+	/**
+	 * Retrieves the size and last modification time of the file referred by
+	 * this path, without opening it.
+	 *
+	 * Backends which cannot query this information cheaply keep the default
+	 * implementation, which reports failure.
+	 *
+	 * @param size    set to the size of the file in bytes
+	 * @param modTime set to the last modification time, in seconds since the epoch
+	 *
+	 * @return bool true if the information could be retrieved, false otherwise.
+	 */
+	virtual bool getFileStats(int64 &size, int64 &modTime) const { return false; }
+
 
 	/**
 	 * Creates a SeekableReadStream instance corresponding to the file
@@ -78,6 +78,17 @@ bool POSIXFilesystemNode::isWritable() const {
 	return retVal;
 }
 
+bool POSIXFilesystemNode::getFileStats(int64 &size, int64 &modTime) const {
+	struct stat st;
+
+	if (stat(_path.c_str(), &st) != 0 || S_ISDIR(st.st_mode))
+		return false;
+
+	size = st.st_size;
+	modTime = st.st_mtime;
+	return true;
+}
+
 void POSIXFilesystemNode::setFlags() {
 	struct stat st;
 
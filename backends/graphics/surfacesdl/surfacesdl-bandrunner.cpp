@@ -0,0 +1,118 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#include "common/scummsys.h"
+
+#if defined(SDL_BACKEND)
+
+#include "backends/graphics/surfacesdl/surfacesdl-bandrunner.h"
+#include "common/util.h"
+
+SdlScalerBandRunner::SdlScalerBandRunner() : _numThreads(0), _mutex(nullptr), _start(nullptr), _done(nullptr),
+	_quit(false), _func(nullptr), _data(nullptr), _count(0), _nextBand(0) {
+#if SDL_VERSION_ATLEAST(2, 0, 0)
+	const int cpus = SDL_GetCPUCount();
+	if (cpus <= 1)
+		return;
+
+	_mutex = SDL_CreateMutex();
+	_start = SDL_CreateSemaphore(0);
+	_done = SDL_CreateSemaphore(0);
+	if (!_mutex || !_start || !_done)
+		return;
+
+	const uint numThreads = MIN<uint>(cpus - 1, kMaxThreads);
+	while (_numThreads < numThreads) {
+		_threads[_numThreads] = SDL_CreateThread(&threadProc, "ScummVM scaler", this);
+		if (!_threads[_numThreads])
+			break;
+		++_numThreads;
+	}
+#endif
+}
+
+SdlScalerBandRunner::~SdlScalerBandRunner() {
+	_quit = true;
+	for (uint i = 0; i < _numThreads; ++i)
+		SDL_SemPost(_start);
+	for (uint i = 0; i < _numThreads; ++i)
+		SDL_WaitThread(_threads[i], nullptr);
+
+	if (_done)
+		SDL_DestroySemaphore(_done);
+	if (_start)
+		SDL_DestroySemaphore(_start);
+	if (_mutex)
+		SDL_DestroyMutex(_mutex);
+}
+
+void SdlScalerBandRunner::run(BandFunc func, void *data, uint count) {
+	if (!_numThreads) {
+		for (uint band = 0; band < count; ++band)
+			func(data, band);
+		return;
+	}
+
+	_func = func;
+	_data = data;
+	_count = count;
+	_nextBand = 0;
+
+	// Only wake up as many workers as there are bands left for them
+	const uint workers = MIN(_numThreads, count - 1);
+	for (uint i = 0; i < workers; ++i)
+		SDL_SemPost(_start);
+
+	runBands();
+
+	for (uint i = 0; i < workers; ++i)
+		SDL_SemWait(_done);
+}
+
+void SdlScalerBandRunner::runBands() {
+	while (true) {
+		SDL_LockMutex(_mutex);
+		const uint band = _nextBand++;
+		SDL_UnlockMutex(_mutex);
+
+		if (band >= _count)
+			break;
+		_func(_data, band);
+	}
+}
+
+int SdlScalerBandRunner::threadProc(void *data) {
+	SdlScalerBandRunner *runner = (SdlScalerBandRunner *)data;
+
+	while (true) {
+		SDL_SemWait(runner->_start);
+		if (runner->_quit)
+			break;
+
+		runner->runBands();
+		SDL_SemPost(runner->_done);
+	}
+
+	return 0;
+}
+
+#endif
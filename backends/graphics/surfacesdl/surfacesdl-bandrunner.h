@@ -0,0 +1,65 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#ifndef BACKENDS_GRAPHICS_SURFACESDL_BANDRUNNER_H
+#define BACKENDS_GRAPHICS_SURFACESDL_BANDRUNNER_H
+
+#include "graphics/scalerplugin.h"
+
+#include "backends/platform/sdl/sdl-sys.h"
+
+/**
+ * Runs the bands of a scale operation on a pool of SDL threads. The
+ * calling thread scales bands as well, so a pool of N workers scales
+ * N + 1 bands in parallel.
+ */
+class SdlScalerBandRunner : public ScalerBandRunner {
+public:
+	SdlScalerBandRunner();
+	virtual ~SdlScalerBandRunner();
+
+	virtual uint getBandCount() const override { return _numThreads + 1; }
+	virtual void run(BandFunc func, void *data, uint count) override;
+
+private:
+	enum {
+		kMaxThreads = 7
+	};
+
+	static int threadProc(void *data);
+	void runBands();
+
+	SDL_Thread *_threads[kMaxThreads];
+	uint _numThreads;
+
+	SDL_mutex *_mutex;
+	SDL_sem *_start;
+	SDL_sem *_done;
+	bool _quit;
+
+	BandFunc _func;
+	void *_data;
+	uint _count;
+	uint _nextBand;
+};
+
+#endif
@@ -24,8 +24,10 @@
 
 #if defined(SDL_BACKEND)
 #include "backends/graphics/surfacesdl/surfacesdl-graphics.h"
+#include "backends/graphics/surfacesdl/surfacesdl-bandrunner.h"
 #include "backends/events/sdl/sdl-events.h"
 #include "common/config-manager.h"
+#include "common/debug.h"
 #include "common/mutex.h"
 #include "common/textconsole.h"
 #include "common/translation.h"
@@ -126,6 +128,8 @@ SurfaceSdlGraphicsManager::SurfaceSdlGraphicsManager(SdlEventSource *sdlEventSou
 	_paletteDirtyStart(0), _paletteDirtyEnd(0),
 	_screenIsLocked(false),
 	_displayDisabled(false),
+	_numDirtyRects(0),
+	_dirtyTileColumns(0), _dirtyTileRows(0), _useDirtyTiles(false),
 #ifdef USE_SDL_DEBUG_FOCUSRECT
 	_enableFocusRectDebugCode(false), _enableFocusRect(false), _focusRect(),
 #endif
@@ -152,6 +156,7 @@ SurfaceSdlGraphicsManager::SurfaceSdlGraphicsManager(SdlEventSource *sdlEventSou
 #endif
 
 	_scalerPlugin = NULL;
+	_scalerBandRunner = new SdlScalerBandRunner();
 	_maxExtraPixels = ScalerMan.getMaxExtraPixels();
 
 	_videoMode.fullscreen = ConfMan.getBool("fullscreen");
@@ -162,10 +167,23 @@ SurfaceSdlGraphicsManager::SurfaceSdlGraphicsManager(SdlEventSource *sdlEventSou
 
 	_videoMode.scalerIndex = getDefaultScaler();
 	_videoMode.scaleFactor = getDefaultScaleFactor();
+
+	resetUpdateStats();
+}
+
+void SurfaceSdlGraphicsManager::resetUpdateStats() {
+	memset(&_updateStats, 0, sizeof(_updateStats));
 }
 
 SurfaceSdlGraphicsManager::~SurfaceSdlGraphicsManager() {
+	debug(1, "SurfaceSdlGraphicsManager: Scaled %llu pixels in %llu rects over %u updates, %u full redraws, %u dirty tile fallbacks",
+		(unsigned long long)_updateStats.scaledPixels, (unsigned long long)_updateStats.scaledRects,
+		_updateStats.frames, _updateStats.fullRedraws, _updateStats.tileFallbacks);
+
 	unloadGFXMode();
+	if (_scalerPlugin)
+		_scalerPlugin->setBandRunner(nullptr);
+	delete _scalerBandRunner;
 	if (_mouseOrigSurface) {
 		SDL_FreeSurface(_mouseOrigSurface);
 		if (_mouseOrigSurface == _mouseSurface) {
@@ -609,11 +627,14 @@ void SurfaceSdlGraphicsManager::setGraphicsModeIntern() {
 #endif
 		) {
 		Graphics::PixelFormat format = convertSDLPixelFormat(_hwScreen->format);
-		if (_scalerPlugin)
+		if (_scalerPlugin) {
 			_scalerPlugin->deinitialize();
+			_scalerPlugin->setBandRunner(nullptr);
+		}
 
 		_scalerPlugin = &_scalerPlugins[_videoMode.scalerIndex]->get<ScalerPluginObject>();
 		_scalerPlugin->initialize(format);
+		_scalerPlugin->setBandRunner(_scalerBandRunner);
 	}
 
 	_scalerPlugin->setFactor(_videoMode.scaleFactor);
@@ -1159,6 +1180,14 @@ void SurfaceSdlGraphicsManager::internUpdateScreen() {
 	updateOSD();
 #endif
 
+	// Turn the dirty tiles into rects, unless we redraw everything anyway
+	if (_useDirtyTiles) {
+		_updateStats.tileFallbacks++;
+		if (!_forceRedraw)
+			convertDirtyTiles(width, height);
+		_useDirtyTiles = false;
+	}
+
 	// Force a full redraw if requested.
 	// If _useOldSrc, the scaler will do its own partial updates.
 	if (_forceRedraw) {
@@ -1191,6 +1220,9 @@ void SurfaceSdlGraphicsManager::internUpdateScreen() {
 		srcPitch = srcSurf->pitch;
 		dstPitch = _hwScreen->pitch;
 
+		_updateStats.lastScaledPixels = 0;
+		_updateStats.lastScaledRects = 0;
+
 		for (r = _dirtyRectList; r != lastRect; ++r) {
 			int dst_x = r->x + _currentShakeXOffset;
 			int dst_y = r->y + _currentShakeYOffset;
@@ -1220,6 +1252,9 @@ void SurfaceSdlGraphicsManager::internUpdateScreen() {
 
 				_scalerPlugin->scale((byte *)srcSurf->pixels + (r->x + _maxExtraPixels) * 2 + (r->y + _maxExtraPixels) * srcPitch, srcPitch,
 					(byte *)_hwScreen->pixels + dst_x * 2 + dst_y * dstPitch, dstPitch, r->w, dst_h, r->x, r->y);
+
+				_updateStats.lastScaledPixels += r->w * dst_h;
+				_updateStats.lastScaledRects++;
 			}
 
 			r->x = dst_x;
@@ -1235,6 +1270,14 @@ void SurfaceSdlGraphicsManager::internUpdateScreen() {
 		SDL_UnlockSurface(srcSurf);
 		SDL_UnlockSurface(_hwScreen);
 
+		_updateStats.frames++;
+		if (_forceRedraw)
+			_updateStats.fullRedraws++;
+		_updateStats.scaledPixels += _updateStats.lastScaledPixels;
+		_updateStats.scaledRects += _updateStats.lastScaledRects;
+		debug(9, "SurfaceSdlGraphicsManager::internUpdateScreen: Scaled %u pixels in %u rects%s",
+			_updateStats.lastScaledPixels, _updateStats.lastScaledRects, _forceRedraw ? " (full redraw)" : "");
+
 		// Readjust the dirty rect list in case we are doing a full update.
 		// This is necessary if shaking is active.
 		if (_forceRedraw) {
@@ -1497,11 +1540,6 @@ void SurfaceSdlGraphicsManager::addDirtyRect(int x, int y, int w, int h, bool re
 	if (_forceRedraw)
 		return;
 
-	if (_numDirtyRects == NUM_DIRTY_RECT) {
-		_forceRedraw = true;
-		return;
-	}
-
 	int height, width;
 
 	if (!_overlayVisible && !realCoordinates) {
@@ -1552,16 +1590,146 @@ void SurfaceSdlGraphicsManager::addDirtyRect(int x, int y, int w, int h, bool re
 		return;
 	}
 
-	if (w > 0 && h > 0) {
-		SDL_Rect *r = &_dirtyRectList[_numDirtyRects++];
+	if (w <= 0 || h <= 0)
+		return;
+
+	if (_useDirtyTiles && !realCoordinates) {
+		markDirtyTiles(x, y, w, h);
+		return;
+	}
+
+	// Merge the rect into an existing one, as long as the merged rect
+	// does not cover more pixels than both rects separately
+	for (int i = 0; i < _numDirtyRects; ++i) {
+		SDL_Rect *r = &_dirtyRectList[i];
+		const int left = MIN<int>(x, r->x);
+		const int top = MIN<int>(y, r->y);
+		const int right = MAX<int>(x + w, r->x + r->w);
+		const int bottom = MAX<int>(y + h, r->y + r->h);
+
+		if ((right - left) * (bottom - top) <= w * h + r->w * r->h) {
+			r->x = left;
+			r->y = top;
+			r->w = right - left;
+			r->h = bottom - top;
+			return;
+		}
+	}
+
+	if (_numDirtyRects == NUM_DIRTY_RECT) {
+		// Rects in real coordinates are added after scaling, when it is
+		// too late to switch to tiles
+		if (realCoordinates) {
+			_forceRedraw = true;
+			return;
+		}
+
+		_dirtyTileColumns = (width + kDirtyTileSize - 1) / kDirtyTileSize;
+		_dirtyTileRows = (height + kDirtyTileSize - 1) / kDirtyTileSize;
+		_dirtyTiles.resize(_dirtyTileColumns * _dirtyTileRows);
+		memset(_dirtyTiles.data(), 0, _dirtyTiles.size());
+		_useDirtyTiles = true;
+
+		for (int i = 0; i < _numDirtyRects; ++i)
+			markDirtyTiles(_dirtyRectList[i].x, _dirtyRectList[i].y, _dirtyRectList[i].w, _dirtyRectList[i].h);
+		_numDirtyRects = 0;
+
+		markDirtyTiles(x, y, w, h);
+		return;
+	}
+
+	SDL_Rect *r = &_dirtyRectList[_numDirtyRects++];
+
+	r->x = x;
+	r->y = y;
+	r->w = w;
+	r->h = h;
+}
+
+void SurfaceSdlGraphicsManager::markDirtyTiles(int x, int y, int w, int h) {
+	const int lastColumn = MIN((x + w - 1) / kDirtyTileSize, _dirtyTileColumns - 1);
+	const int lastRow = MIN((y + h - 1) / kDirtyTileSize, _dirtyTileRows - 1);
 
-		r->x = x;
-		r->y = y;
-		r->w = w;
-		r->h = h;
+	for (int row = y / kDirtyTileSize; row <= lastRow; ++row) {
+		byte *tile = &_dirtyTiles[row * _dirtyTileColumns];
+		for (int column = x / kDirtyTileSize; column <= lastColumn; ++column)
+			tile[column] = 1;
 	}
 }
 
+void SurfaceSdlGraphicsManager::convertDirtyTiles(int width, int height) {
+	_numDirtyRects = 0;
+
+	int previousRowStart = 0;
+	for (int row = 0; row < _dirtyTileRows; ++row) {
+		const byte *tiles = &_dirtyTiles[row * _dirtyTileColumns];
+		const int rowStart = _numDirtyRects;
+		const int y = row * kDirtyTileSize;
+		if (y >= height)
+			break;
+
+		int column = 0;
+		while (column < _dirtyTileColumns) {
+			if (!tiles[column]) {
+				++column;
+				continue;
+			}
+
+			// Find the run of dirty tiles starting at this column
+			const int start = column;
+			while (column < _dirtyTileColumns && tiles[column])
+				++column;
+
+			const int x = start * kDirtyTileSize;
+			const int w = MIN(column * kDirtyTileSize, width) - x;
+			const int h = MIN(y + kDirtyTileSize, height) - y;
+			if (w <= 0)
+				continue;
+
+			// Extend the same run of the previous row when possible
+			bool merged = false;
+			for (int i = previousRowStart; i < rowStart; ++i) {
+				SDL_Rect *r = &_dirtyRectList[i];
+				if (r->x == x && r->w == w && r->y + r->h == y) {
+					r->h += h;
+					merged = true;
+					break;
+				}
+			}
+			if (merged)
+				continue;
+
+			if (_numDirtyRects == NUM_DIRTY_RECT) {
+				_forceRedraw = true;
+				return;
+			}
+
+			SDL_Rect *r = &_dirtyRectList[_numDirtyRects++];
+			r->x = x;
+			r->y = y;
+			r->w = w;
+			r->h = h;
+		}
+
+		previousRowStart = rowStart;
+	}
+
+#ifdef USE_ASPECT
+	// Tile boundaries do not follow the stretching pattern
+	if (_videoMode.aspectRatioCorrection && !_overlayVisible) {
+		for (int i = 0; i < _numDirtyRects; ++i) {
+			SDL_Rect *r = &_dirtyRectList[i];
+			int x = r->x, y = r->y, w = r->w, h = r->h;
+			makeRectStretchable(x, y, w, h, _videoMode.filtering);
+			r->x = x;
+			r->y = y;
+			r->w = w;
+			r->h = h;
+		}
+	}
+#endif
+}
+
 int16 SurfaceSdlGraphicsManager::getHeight() const {
 	return _videoMode.screenHeight;
 }
@@ -28,6 +28,7 @@
 #include "graphics/pixelformat.h"
 #include "graphics/scaler.h"
 #include "graphics/scalerplugin.h"
+#include "common/array.h"
 #include "common/events.h"
 #include "common/mutex.h"
 
@@ -138,6 +139,20 @@ public:
 	virtual void notifyVideoExpose() override;
 	virtual void notifyResize(const int width, const int height) override;
 
+	/** Statistics about the dirty rects and the scaling of the screen updates */
+	struct UpdateStats {
+		uint32 frames;			// updates which scaled the screen
+		uint32 fullRedraws;		// updates which redrew the whole screen
+		uint32 tileFallbacks;	// updates whose dirty rects overflowed into tiles
+		uint32 lastScaledPixels;	// pixels scaled by the last update
+		uint32 lastScaledRects;		// rects scaled by the last update
+		uint64 scaledPixels;	// pixels scaled since the stats were reset
+		uint64 scaledRects;		// rects scaled since the stats were reset
+	};
+
+	const UpdateStats &getUpdateStats() const { return _updateStats; }
+	void resetUpdateStats();
+
 protected:
 #ifdef USE_OSD
 	/** Surface containing the OSD message */
@@ -326,6 +341,7 @@ protected:
 
 	const PluginList &_scalerPlugins;
 	ScalerPluginObject *_scalerPlugin;
+	ScalerBandRunner *_scalerBandRunner;
 	uint _maxExtraPixels;
 	uint _extraPixels;
 
@@ -343,6 +359,17 @@ protected:
 	SDL_Rect _dirtyRectList[NUM_DIRTY_RECT];
 	int _numDirtyRects;
 
+	// Once the dirty rect list is full, dirty areas are recorded in a bitmap of
+	// tiles instead, which is turned back into rects before scaling
+	enum {
+		kDirtyTileSize = 16
+	};
+	Common::Array<byte> _dirtyTiles;
+	int _dirtyTileColumns, _dirtyTileRows;
+	bool _useDirtyTiles;
+
+	UpdateStats _updateStats;
+
 	struct MousePos {
 		// The size and hotspot of the original cursor image.
 		int16 w, h;
@@ -405,6 +432,8 @@ protected:
 #endif
 
 	virtual void addDirtyRect(int x, int y, int w, int h, bool realCoordinates = false);
+	void markDirtyTiles(int x, int y, int w, int h);
+	void convertDirtyTiles(int width, int height);
 
 	virtual void drawMouse();
 	virtual void undrawMouse();
@@ -142,6 +142,7 @@ MODULE_OBJS += \
 	events/sdl/legacy-sdl-events.o \
 	events/sdl/sdl-events.o \
 	graphics/sdl/sdl-graphics.o \
+	graphics/surfacesdl/surfacesdl-bandrunner.o \
 	graphics/surfacesdl/surfacesdl-graphics.o \
 	graphics3d/openglsdl/openglsdl-graphics3d.o \
 	mixer/sdl/sdl-mixer.o \
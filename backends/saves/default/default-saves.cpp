@@ -44,7 +44,7 @@
 #include "common/config-manager.h"
 #include "common/zlib.h"
 
-#include <errno.h>	// for removeSavefile()
+#include <errno.h>	// for removeSavefile() and renameSavefile()
 
 #if defined(USE_CLOUD) && defined(USE_LIBCURL)
 const char *DefaultSaveFileManager::TIMESTAMPS_FILENAME = "timestamps";
@@ -224,6 +224,84 @@ Common::ErrorCode DefaultSaveFileManager::removeFile(const Common::String &filep
 	return Common::kUnknownError;
 }
 
+bool DefaultSaveFileManager::renameSavefile(const Common::String &oldFilename, const Common::String &newFilename, bool compress) {
+	// Renaming the file keeps its data as it is, which is only what copying
+	// it would give when the data is already stored as requested
+#if defined(USE_ZLIB)
+	const bool storeCompressed = compress;
+#else
+	const bool storeCompressed = false;
+#endif
+	if (isCompressed(oldFilename) != storeCompressed)
+		return SaveFileManager::renameSavefile(oldFilename, newFilename, compress);
+
+	// Assure the savefile name cache is up-to-date.
+	const Common::String savePathName = getSavePath();
+	assureCached(savePathName);
+	if (getError().getCode() != Common::kNoError)
+		return false;
+
+	for (Common::StringArray::const_iterator i = _lockedFiles.begin(), end = _lockedFiles.end(); i != end; ++i) {
+		if (oldFilename == *i || newFilename == *i) {
+			return false; //file is locked
+		}
+	}
+
+	SaveFileCache::const_iterator file = _saveFileCache.find(oldFilename);
+	if (file == _saveFileCache.end())
+		return false;
+	const Common::FSNode oldNode = file->_value;
+
+	// Replace the existing file, if any
+	Common::FSNode newNode;
+	file = _saveFileCache.find(newFilename);
+	if (file == _saveFileCache.end()) {
+		const Common::FSNode savePath(savePathName);
+		newNode = savePath.getChild(newFilename);
+	} else {
+		newNode = file->_value;
+	}
+
+	// Some systems can't replace files while renaming, or rename across
+	// file systems, so the file is copied then
+	if (renameFile(oldNode.getPath(), newNode.getPath()) != Common::kNoError)
+		return SaveFileManager::renameSavefile(oldFilename, newFilename, compress);
+
+#if defined(USE_CLOUD) && defined(USE_LIBCURL)
+	// Update files' timestamps
+	Common::HashMap<Common::String, uint32> timestamps = loadTimestamps();
+	timestamps.erase(oldFilename);
+	timestamps[newFilename] = INVALID_TIMESTAMP;
+	saveTimestamps(timestamps);
+#endif
+
+	_saveFileCache.erase(oldFilename);
+	_saveFileCache[newFilename] = Common::FSNode(newNode.getPath());
+	return true;
+}
+
+Common::ErrorCode DefaultSaveFileManager::renameFile(const Common::String &oldFilepath, const Common::String &newFilepath) {
+	if (rename(oldFilepath.c_str(), newFilepath.c_str()) == 0)
+		return Common::kNoError;
+	if (errno == EACCES)
+		return Common::kWritePermissionDenied;
+	if (errno == ENOENT)
+		return Common::kPathDoesNotExist;
+	return Common::kUnknownError;
+}
+
+bool DefaultSaveFileManager::isCompressed(const Common::String &filename) {
+	Common::InSaveFile *file = openRawFile(filename);
+	if (!file)
+		return false;
+
+	const uint16 header = file->readUint16BE();
+	const bool compressed = !file->err() && !file->eos() &&
+		(header == 0x1F8B || ((header & 0x0F00) == 0x0800 && header % 31 == 0));
+	delete file;
+	return compressed;
+}
+
 bool DefaultSaveFileManager::exists(const Common::String &filename) {
 	// Assure the savefile name cache is up-to-date.
 	assureCached(getSavePath());
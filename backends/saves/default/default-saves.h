@@ -44,6 +44,7 @@ public:
 	Common::InSaveFile *openForLoading(const Common::String &filename) override;
 	Common::OutSaveFile *openForSaving(const Common::String &filename, bool compress = true) override;
 	bool removeSavefile(const Common::String &filename) override;
+	bool renameSavefile(const Common::String &oldFilename, const Common::String &newFilename, bool compress = true) override;
 	bool exists(const Common::String &filename) override;
 
 #ifdef USE_LIBCURL
@@ -77,6 +78,18 @@ protected:
 	 */
 	virtual Common::ErrorCode removeFile(const Common::String &filepath);
 
+	/**
+	 * Renames the given file, replacing the file with the new name if it
+	 * exists. This is called from renameSavefile() with the full file paths.
+	 */
+	virtual Common::ErrorCode renameFile(const Common::String &oldFilepath, const Common::String &newFilepath);
+
+	/**
+	 * Checks whether the given save file is compressed, the same way
+	 * openForLoading() does.
+	 */
+	bool isCompressed(const Common::String &filename);
+
 	/**
 	 * Assure that the given save path is cached.
 	 *
@@ -59,6 +59,7 @@
 
 #include "audio/mididrv.h"
 #include "audio/musicplugin.h"  /* for music manager */
+#include "audio/rate.h"
 
 #include "graphics/cursorman.h"
 #include "graphics/fontman.h"
@@ -731,6 +732,7 @@ extern "C" int scummvm_main(int argc, const char * const argv[]) {
 	Common::MainTranslationManager::destroy();
 #endif
 	MusicManager::destroy();
+	Audio::PolyphaseFilterBankCache::destroy();
 	Graphics::CursorManager::destroy();
 	Graphics::FontManager::destroy();
 #ifdef USE_FREETYPE2
@@ -127,6 +127,10 @@ bool FSNode::isWritable() const {
 	return _realNode && _realNode->isWritable();
 }
 
+bool FSNode::getFileStats(int64 &size, int64 &modTime) const {
+	return _realNode && _realNode->getFileStats(size, modTime);
+}
+
 SeekableReadStream *FSNode::createReadStream() const {
 	if (_realNode == nullptr)
 		return nullptr;
@@ -224,6 +224,20 @@ public:
 	 */
 	bool isWritable() const;
 
+	/**
+	 * Retrieve the size and last modification time of the file referred by
+	 * this node without opening it.
+	 *
+	 * Not all backends support this. Callers must be prepared to handle
+	 * a false return value, e.g. by opening the file instead.
+	 *
+	 * @param size    Set to the size of the file in bytes.
+	 * @param modTime Set to the last modification time, in seconds since the epoch.
+	 *
+	 * @return True if the information could be retrieved, false otherwise.
+	 */
+	bool getFileStats(int64 &size, int64 &modTime) const;
+
 	/**
 	 * Create a SeekableReadStream instance corresponding to the file
 	 * referred by this node. This assumes that the node actually refers
@@ -27,6 +27,7 @@
 #include "common/md5.h"
 #include "common/config-manager.h"
 #include "common/punycode.h"
+#include "common/savefile.h"
 #include "common/system.h"
 #include "common/textconsole.h"
 #include "common/translation.h"
@@ -364,6 +365,7 @@ Common::Error AdvancedMetaEngineDetection::createInstance(OSystem *syst, Engine
 
 	// Run the detector on this
 	ADDetectedGames matches = detectGame(files.begin()->getParent(), allFiles, language, platform, extra);
+	MD5Man.flushPersistent();
 
 	if (cleanupPirated(matches))
 		return Common::kNoGameDataFoundError;
@@ -466,7 +468,7 @@ void AdvancedMetaEngineDetection::composeFileHashMap(FileMap &allFiles, const Co
 			if (!matched)
 				continue;
 
-			if (!file->getChildren(files, Common::FSNode::kListAll))
+			if (!MD5Man.getChildren(*file, files))
 				continue;
 
 			composeFileHashMap(allFiles, files, depth - 1, tstr);
@@ -486,6 +488,143 @@ namespace Common {
 	DECLARE_SINGLETON(MD5CacheManager);
 }
 
+#define MD5CACHE_FILENAME "scummvm-md5cache.txt"
+#define MD5CACHE_HEADER "SCUMMVM-MD5CACHE 1"
+
+void MD5CacheManager::loadPersistent() {
+	_persistentLoaded = true;
+	_persistentMap.clear();
+	_persistentDirty = false;
+
+	Common::InSaveFile *loadFile = g_system->getSavefileManager()->openRawFile(MD5CACHE_FILENAME);
+	if (!loadFile)
+		return;
+
+	if (loadFile->readLine() != MD5CACHE_HEADER) {
+		warning("MD5CacheManager: Ignoring outdated or corrupt " MD5CACHE_FILENAME);
+		delete loadFile;
+		return;
+	}
+
+	// Each line is "<statSize> <statModTime> <size> <md5> <key>". The key
+	// comes last, since it contains the file path which may contain spaces.
+	while (!loadFile->eos() && !loadFile->err()) {
+		Common::String line = loadFile->readLine();
+		if (line.empty())
+			continue;
+
+		long long statSize, statModTime, size;
+		char md5[33];
+		int keyPos = 0;
+		if (sscanf(line.c_str(), "%lld %lld %lld %32s %n", &statSize, &statModTime, &size, md5, &keyPos) != 4 || keyPos == 0) {
+			warning("MD5CacheManager: Malformed line in " MD5CACHE_FILENAME);
+			continue;
+		}
+
+		PersistentEntry &entry = _persistentMap[line.c_str() + keyPos];
+		entry.statSize = statSize;
+		entry.statModTime = statModTime;
+		entry.size = size;
+		entry.md5 = md5;
+	}
+
+	delete loadFile;
+	debugC(2, kDebugGlobalDetection, "Read %u entries from " MD5CACHE_FILENAME, _persistentMap.size());
+}
+
+bool MD5CacheManager::getPersistent(const Common::String &key, const Common::FSNode &node, Common::String &md5, int64 &size) {
+	if (!_persistentLoaded)
+		loadPersistent();
+
+	PersistentHashMap::iterator it = _persistentMap.find(key);
+	if (it == _persistentMap.end()) {
+		_statMisses++;
+		return false;
+	}
+
+	int64 statSize, statModTime;
+	if (!node.getFileStats(statSize, statModTime)) {
+		_statUnsupported++;
+		return false;
+	}
+
+	if (it->_value.statSize != statSize || it->_value.statModTime != statModTime) {
+		// The file changed since it was hashed, forget about it
+		_persistentMap.erase(it);
+		_persistentDirty = true;
+		_statStale++;
+		return false;
+	}
+
+	md5 = it->_value.md5;
+	size = it->_value.size;
+	_statHits++;
+	return true;
+}
+
+void MD5CacheManager::setPersistent(const Common::String &key, const Common::FSNode &node, const Common::String &md5, int64 size) {
+	if (!_persistentLoaded)
+		loadPersistent();
+
+	PersistentEntry entry;
+	if (!node.getFileStats(entry.statSize, entry.statModTime))
+		return;
+
+	entry.size = size;
+	entry.md5 = md5;
+	_persistentMap.setVal(key, entry);
+	_persistentDirty = true;
+}
+
+void MD5CacheManager::flushPersistent() {
+	if (!_persistentDirty)
+		return;
+
+	Common::OutSaveFile *saveFile = g_system->getSavefileManager()->openForSaving(MD5CACHE_FILENAME, false);
+	if (!saveFile) {
+		warning("MD5CacheManager: Failed to open " MD5CACHE_FILENAME " for writing");
+		return;
+	}
+
+	saveFile->writeString(MD5CACHE_HEADER "\n");
+	for (PersistentHashMap::const_iterator it = _persistentMap.begin(); it != _persistentMap.end(); ++it) {
+		saveFile->writeString(Common::String::format("%lld %lld %lld %s %s\n",
+			(long long)it->_value.statSize, (long long)it->_value.statModTime,
+			(long long)it->_value.size, it->_value.md5.c_str(), it->_key.c_str()));
+	}
+	saveFile->finalize();
+	delete saveFile;
+
+	_persistentDirty = false;
+	debugC(2, kDebugGlobalDetection, "Wrote %u entries to " MD5CACHE_FILENAME, _persistentMap.size());
+}
+
+void MD5CacheManager::invalidatePersistent() {
+	_persistentMap.clear();
+	_persistentLoaded = true;
+	_persistentDirty = false;
+	g_system->getSavefileManager()->removeSavefile(MD5CACHE_FILENAME);
+}
+
+bool MD5CacheManager::getChildren(const Common::FSNode &dir, Common::FSList &files) {
+	DirListHashMap::const_iterator it = _dirListHashMap.find(dir.getPath());
+	if (it != _dirListHashMap.end()) {
+		files = it->_value;
+		return true;
+	}
+
+	if (!dir.getChildren(files, Common::FSNode::kListAll))
+		return false;
+
+	_dirListHashMap.setVal(dir.getPath(), files);
+	return true;
+}
+
+void MD5CacheManager::dumpStatistics() const {
+	debug(1, "MD5 cache: %u entries, %u hits, %u misses, %u stale, %u unsupported",
+		_persistentMap.size(), _statHits, _statMisses, _statStale, _statUnsupported);
+}
+
 static char flagsToMD5Prefix(uint32 flags) {
 	if (flags & ADGF_MACRESFORK) {
 		if (flags & ADGF_TAILMD5)
@@ -509,11 +648,28 @@ bool AdvancedMetaEngineDetection::getFileProperties(const FileMap &allFiles, con
 		return true;
 	}
 
+	// Resource forks may live in a different file than the one in the file
+	// map, so only plain files are considered for the persistent cache.
+	Common::String persistentName;
+	if (!(game.flags & ADGF_MACRESFORK) && allFiles.contains(fname)) {
+		const Common::FSNode &node = allFiles[fname];
+		persistentName = Common::String::format("%c:%d:%s", flagsToMD5Prefix(game.flags), _md5Bytes, node.getPath().c_str());
+
+		if (MD5Man.getPersistent(persistentName, node, fileProps.md5, fileProps.size)) {
+			MD5Man.setMD5(hashname, fileProps.md5);
+			MD5Man.setSize(hashname, fileProps.size);
+			return true;
+		}
+	}
+
 	bool res = getFilePropertiesIntern(_md5Bytes, allFiles, game, fname, fileProps);
 
 	if (res) {
 		MD5Man.setMD5(hashname, fileProps.md5);
 		MD5Man.setSize(hashname, fileProps.size);
+
+		if (!persistentName.empty())
+			MD5Man.setPersistent(persistentName, allFiles[fname], fileProps.md5, fileProps.size);
 	}
 
 	return res;
@@ -518,6 +518,17 @@ public:
 
 /**
  * Singleton Cache Storage for Computed MD5s
+ *
+ * Besides the in-memory cache, which is keyed by the file name relative to the
+ * directory being detected and is cleared before each detection run, the
+ * manager keeps a persistent cache keyed by the full path of each file.
+ * Persistent entries are only trusted while the size and modification time
+ * reported by the file system still match, so repeated detection of unchanged
+ * directories does not need to open and hash any file.
+ *
+ * The manager also remembers the directory listings requested while composing
+ * the file maps of a detection run, since several engines usually descend into
+ * the same subdirectories.
  */
 class MD5CacheManager : public Common::Singleton<MD5CacheManager> {
 public:
@@ -541,22 +552,89 @@ public:
 		return (md5HashMap.contains(fname) && sizeHashMap.contains(fname));
 	}
 
-	MD5CacheManager() {
+	MD5CacheManager() : _persistentLoaded(false), _persistentDirty(false) {
 		clear();
+		resetStatistics();
 	}
 
 	void clear() {
 		md5HashMap.clear(true);
 		sizeHashMap.clear(true);
+		_dirListHashMap.clear(true);
+	}
+
+	/**
+	 * Return the contents of a directory, as FSNode::getChildren() with
+	 * FSNode::kListAll would. Listings are cached until the next clear().
+	 */
+	bool getChildren(const Common::FSNode &dir, Common::FSList &files);
+
+	/**
+	 * Look up the persistent cache.
+	 *
+	 * @param key      Key of the entry, which includes the full path of the file.
+	 * @param node     File system node of the file, used to validate the entry.
+	 * @param md5      Set to the cached MD5 on success.
+	 * @param size     Set to the cached size on success.
+	 *
+	 * @return True if a valid entry was found.
+	 */
+	bool getPersistent(const Common::String &key, const Common::FSNode &node, Common::String &md5, int64 &size);
+
+	/**
+	 * Store an entry in the persistent cache. Nothing is stored if the file
+	 * system cannot report the size and modification time of the node.
+	 */
+	void setPersistent(const Common::String &key, const Common::FSNode &node, const Common::String &md5, int64 size);
+
+	/**
+	 * Write the persistent cache to disk if it has been modified since
+	 * it was loaded. This should be called once a detection run is over.
+	 */
+	void flushPersistent();
+
+	/**
+	 * Drop all persistent entries, both in memory and on disk.
+	 */
+	void invalidatePersistent();
+
+	/**
+	 * Print the persistent cache statistics gathered since the last reset.
+	 */
+	void dumpStatistics() const;
+
+	void resetStatistics() {
+		_statHits = _statMisses = _statStale = _statUnsupported = 0;
 	}
 
 private:
 	friend class Common::Singleton<MD5CacheManager>;
 
+	struct PersistentEntry {
+		int64 statSize;
+		int64 statModTime;
+		int64 size;
+		Common::String md5;
+	};
+
+	void loadPersistent();
+
 	typedef Common::HashMap<Common::String, Common::String, Common::IgnoreCase_Hash, Common::IgnoreCase_EqualTo> FileHashMap;
 	typedef Common::HashMap<Common::String, int64, Common::IgnoreCase_Hash, Common::IgnoreCase_EqualTo> SizeHashMap;
+	typedef Common::HashMap<Common::String, PersistentEntry> PersistentHashMap;
+	typedef Common::HashMap<Common::String, Common::FSList> DirListHashMap;
 	FileHashMap md5HashMap;
 	SizeHashMap sizeHashMap;
+	DirListHashMap _dirListHashMap;
+
+	PersistentHashMap _persistentMap;
+	bool _persistentLoaded;
+	bool _persistentDirty;
+
+	uint _statHits;
+	uint _statMisses;
+	uint _statStale;
+	uint _statUnsupported;
 };
 
 /** Convenience shortcut for accessing the MD5CacheManager. */
@@ -143,6 +143,9 @@ Common::Error AGSEngine::run() {
 
 #ifdef ENABLE_AGS_TESTS
 	AGS3::Test_DoAllTests();
+#ifdef ENABLE_AGS_BENCHMARKS
+	AGS3::Test_DoAllBenchmarks();
+#endif
 	return Common::kNoError;
 #endif
 
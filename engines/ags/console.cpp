@@ -23,6 +23,7 @@
 #include "ags/console.h"
 #include "ags/ags.h"
 #include "ags/globals.h"
+#include "ags/engine/ac/route_finder_jps.h"
 #include "ags/shared/ac/sprite_cache.h"
 #include "ags/shared/gfx/allegro_bitmap.h"
 #include "ags/shared/script/cc_options.h"
@@ -36,6 +37,10 @@ AGSConsole::AGSConsole(AGSEngine *vm) : GUI::Debugger(), _vm(vm), _logOutputTarg
 	registerCmd("ags_set_script_dump", WRAP_METHOD(AGSConsole, Cmd_SetScriptDump));
 	registerCmd("ags_sprite_info",   WRAP_METHOD(AGSConsole, Cmd_getSpriteInfo));
 	registerCmd("ags_sprite_dump",  WRAP_METHOD(AGSConsole, Cmd_dumpSprite));
+	registerCmd("ags_sprite_cache_stats",  WRAP_METHOD(AGSConsole, Cmd_spriteCacheStats));
+	registerCmd("ags_sprite_cache_policy",  WRAP_METHOD(AGSConsole, Cmd_spriteCachePolicy));
+	registerCmd("ags_sprite_cache_trace",  WRAP_METHOD(AGSConsole, Cmd_spriteCacheTrace));
+	registerCmd("ags_pathfinder_stats",  WRAP_METHOD(AGSConsole, Cmd_pathfinderStats));
 
 	_logOutputTarget = new LogOutputTarget();
 	_agsDebuggerOutput = _GP(DbgMgr).RegisterOutput("ScummVMLog", _logOutputTarget, AGS3::AGS::Shared::kDbgMsg_None);
@@ -245,6 +250,105 @@ bool AGSConsole::Cmd_dumpSprite(int argc, const char **argv) {
 	return true;
 }
 
+bool AGSConsole::Cmd_spriteCacheStats(int argc, const char **argv) {
+	if (argc > 2 || (argc == 2 && strcmp(argv[1], "reset") != 0)) {
+		debugPrintf("Usage: %s [reset]\n", argv[0]);
+		return true;
+	}
+
+	if (argc == 2) {
+		_GP(spriteset).ResetStats();
+		return true;
+	}
+
+	const AGS3::SpriteCacheStats &stats = _GP(spriteset).GetStats();
+	debugPrintf("Cache size: %u KB of %u KB, %u KB locked\n", (uint)(_GP(spriteset).GetCacheSize() / 1024),
+		(uint)(_GP(spriteset).GetMaxCacheSize() / 1024), (uint)(_GP(spriteset).GetLockedSize() / 1024));
+	debugPrintf("Policy: %s\n", _GP(spriteset).GetPolicyName());
+	debugPrintf("Hits: %u, misses: %u, disposed: %u\n", stats.Hits, stats.Misses, stats.Disposed);
+	debugPrintf("Loaded on misses: %u KB, of which reloaded: %u KB\n", (uint)(stats.BytesLoaded / 1024),
+		(uint)(stats.BytesReloaded / 1024));
+	debugPrintf("Stalls on misses: %u ms in total, %u ms at most\n", stats.StallTime, stats.MaxStall);
+	debugPrintf("Prefetched: %u, used: %u, disposed unused: %u, queued: %u\n", stats.Prefetched,
+		stats.PrefetchHits, stats.PrefetchWasted, (uint)_GP(spriteset).GetPrefetchQueueSize());
+	return true;
+}
+
+bool AGSConsole::Cmd_spriteCachePolicy(int argc, const char **argv) {
+	if (argc > 2) {
+		debugPrintf("Usage: %s [lru|gdsf]\n", argv[0]);
+		return true;
+	}
+
+	if (argc == 2) {
+		AGS3::SpriteCachePolicyType type = AGS3::FindSpriteCachePolicy(argv[1]);
+		if (type == AGS3::kNumSprCachePolicies) {
+			debugPrintf("Unknown policy '%s'\n", argv[1]);
+			return true;
+		}
+		_GP(spriteset).SetPolicy(type);
+	}
+
+	debugPrintf("Policy: %s\n", _GP(spriteset).GetPolicyName());
+	return true;
+}
+
+bool AGSConsole::Cmd_spriteCacheTrace(int argc, const char **argv) {
+	if (argc < 2 || argc > 3) {
+		debugPrintf("Usage: %s on|off|replay [cache size in KB]\n", argv[0]);
+		return true;
+	}
+
+	if (strcmp(argv[1], "on") == 0) {
+		_GP(spriteset).SetTraceRecording(true);
+	} else if (strcmp(argv[1], "off") == 0) {
+		_GP(spriteset).SetTraceRecording(false);
+	} else if (strcmp(argv[1], "replay") == 0) {
+		// By default replay with the space which is left for the unlocked sprites
+		size_t cacheSize = _GP(spriteset).GetMaxCacheSize() - _GP(spriteset).GetLockedSize();
+		if (argc == 3)
+			cacheSize = (size_t)atoi(argv[2]) * 1024;
+
+		const AGS3::std::vector<AGS3::SpriteAccess> &trace = _GP(spriteset).GetTrace();
+		debugPrintf("Replaying %u requests with %u KB\n", (uint)trace.size(), (uint)(cacheSize / 1024));
+		for (int i = 0; i < AGS3::kNumSprCachePolicies; ++i) {
+			AGS3::SpriteCachePolicy *policy = AGS3::CreateSpriteCachePolicy((AGS3::SpriteCachePolicyType)i);
+			uint32 start = g_system->getMillis();
+			AGS3::SpriteReplayStats stats = AGS3::ReplaySpriteTrace(*policy, trace, cacheSize);
+			debugPrintf("%s: hits %u, misses %u, disposed %u, loaded %u KB, reloaded %u KB, %u ms\n",
+				policy->GetName(), stats.Hits, stats.Misses, stats.Disposed, (uint)(stats.BytesLoaded / 1024),
+				(uint)(stats.BytesReloaded / 1024), g_system->getMillis() - start);
+			delete policy;
+		}
+		return true;
+	} else {
+		debugPrintf("Usage: %s on|off|replay [cache size in KB]\n", argv[0]);
+		return true;
+	}
+
+	debugPrintf("Recorded %u requests\n", (uint)_GP(spriteset).GetTrace().size());
+	return true;
+}
+
+bool AGSConsole::Cmd_pathfinderStats(int argc, const char **argv) {
+	if (argc == 2 && strcmp(argv[1], "reset") == 0) {
+		_GP(nav).ResetStats();
+		return true;
+	} else if (argc == 3 && strcmp(argv[1], "hierarchical") == 0) {
+		_GP(nav).SetHierarchical(strcmp(argv[2], "on") == 0);
+	} else if (argc != 1) {
+		debugPrintf("Usage: %s [reset|hierarchical on|off]\n", argv[0]);
+		return true;
+	}
+
+	const AGS3::Navigation::Stats &stats = _GP(nav).GetStats();
+	debugPrintf("Hierarchical routing: %s\n", _GP(nav).IsHierarchical() ? "on" : "off");
+	debugPrintf("Routes: %u, from the cache: %u, over the cluster graph: %u\n", stats.Queries,
+		stats.CacheHits, stats.HierarchicalRoutes);
+	debugPrintf("Graph updates: %u, clusters updated: %u\n", stats.GraphUpdates, stats.ClustersUpdated);
+	return true;
+}
+
 LogOutputTarget::LogOutputTarget() {
 }
 
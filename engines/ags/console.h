@@ -51,6 +51,11 @@ private:
 
 	bool Cmd_getSpriteInfo(int argc, const char **argv);
 	bool Cmd_dumpSprite(int argc, const char **argv);
+	bool Cmd_spriteCacheStats(int argc, const char **argv);
+	bool Cmd_spriteCachePolicy(int argc, const char **argv);
+	bool Cmd_spriteCacheTrace(int argc, const char **argv);
+
+	bool Cmd_pathfinderStats(int argc, const char **argv);
 
 	const char *getVerbosityLevel(AGS3::uint32_t groupID) const;
 	AGS3::uint32_t parseGroup(const char *, bool &) const;
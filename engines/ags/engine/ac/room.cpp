@@ -46,6 +46,7 @@
 #include "ags/engine/ac/sys_events.h"
 #include "ags/engine/ac/room.h"
 #include "ags/engine/ac/room_object.h"
+#include "ags/engine/ac/view_frame.h"
 #include "ags/engine/ac/room_status.h"
 #include "ags/engine/ac/screen.h"
 #include "ags/engine/ac/string.h"
@@ -435,6 +436,26 @@ HError LoadRoomScript(RoomStruct *room, int newnum) {
 }
 
 // forchar = playerchar on NewRoom, or NULL if restore saved game
+// Queues the sprites which the new room is likely to show soon, so that
+// they are loaded in the spare time of the next frames
+static void prefetch_room_sprites() {
+	_GP(spriteset).ClearPrefetch();
+
+	// The current loops first, then the rest of the same views
+	for (int pass = 0; pass < 2; ++pass) {
+		for (int cc = 0; cc < _G(croom)->numobj; cc++) {
+			const RoomObject &obj = _G(objs)[cc];
+			if (obj.on && obj.view != (uint16_t)-1)
+				prefetch_view(obj.view, pass == 0 ? obj.loop : -1);
+		}
+		for (int cc = 0; cc < _GP(game).numcharacters; cc++) {
+			const CharacterInfo &chi = _GP(game).chars[cc];
+			if (chi.room == _G(displayed_room) && chi.on)
+				prefetch_view(chi.view, pass == 0 ? chi.loop : -1);
+		}
+	}
+}
+
 void load_new_room(int newnum, CharacterInfo *forchar) {
 
 	debug_script_log("Loading room %d", newnum);
@@ -909,6 +930,7 @@ void load_new_room(int newnum, CharacterInfo *forchar) {
 	update_polled_stuff_if_runtime();
 	debug_script_log("Now in room %d", _G(displayed_room));
 	GUI::MarkAllGUIForUpdate();
+	prefetch_room_sprites();
 	pl_run_plugin_hooks(AGSE_ENTERROOM, _G(displayed_room));
 	//  MoveToWalkableArea(_GP(game).playercharacter);
 	//  MSS_CHECK_ALL_BLOCKS;
@@ -87,11 +87,9 @@ void get_lastcpos(int &lastcx_, int &lastcy_) {
 static int find_route_jps(int fromx, int fromy, int destx, int desty) {
 	sync_nav_wallscreen();
 
-	std::vector<int> path, cpath;
-	path.clear();
-	cpath.clear();
+	std::vector<int> cpath;
 
-	if (_GP(nav).NavigateRefined(fromx, fromy, destx, desty, path, cpath) == Navigation::NAV_UNREACHABLE)
+	if (_GP(nav).NavigateCached(fromx, fromy, destx, desty, cpath) == Navigation::NAV_UNREACHABLE)
 		return 0;
 
 	_G(num_navpoints) = 0;
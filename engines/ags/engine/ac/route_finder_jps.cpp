@@ -27,154 +27,11 @@
 //
 //=============================================================================
 
-#include "ags/lib/std/queue.h"
-#include "ags/lib/std/vector.h"
-#include "ags/lib/std/algorithm.h"
-#include "ags/lib/std/functional.h"
+#include "ags/engine/ac/route_finder_jps.h"
 #include "ags/lib/std/math.h"
-#include "ags/lib/std/xutility.h"
 
 namespace AGS3 {
 
-// TODO: this could be cleaned up/simplified ...
-
-// further optimizations possible:
-//    - forward refinement should use binary search
-
-class Navigation {
-public:
-	Navigation();
-
-	void Resize(int width, int height);
-
-	enum NavResult {
-		// unreachable
-		NAV_UNREACHABLE,
-		// straight line exists
-		NAV_STRAIGHT,
-		// path used
-		NAV_PATH
-	};
-
-	// ncpath = navpoint-compressed path
-	// opath = path composed of individual grid elements
-	NavResult NavigateRefined(int sx, int sy, int ex, int ey, std::vector<int> &opath,
-	                          std::vector<int> &ncpath);
-
-	NavResult Navigate(int sx, int sy, int ex, int ey, std::vector<int> &opath);
-
-	bool TraceLine(int srcx, int srcy, int targx, int targy, int &lastValidX, int &lastValidY) const;
-	bool TraceLine(int srcx, int srcy, int targx, int targy, std::vector<int> *rpath = nullptr) const;
-
-	inline void SetMapRow(int y, const unsigned char *row) {
-		map[y] = row;
-	}
-
-	inline static int PackSquare(int x, int y);
-	inline static void UnpackSquare(int sq, int &x, int &y);
-
-private:
-	// priority queue entry
-	struct Entry {
-		float cost;
-		int index;
-
-		inline Entry() {}
-
-		inline Entry(float ncost, int nindex)
-			: cost(ncost)
-			, index(nindex) {
-		}
-
-		inline bool operator <(const Entry &b) const {
-			return cost < b.cost;
-		}
-
-		inline bool operator >(const Entry &b) const {
-			return cost > b.cost;
-		}
-	};
-
-	int mapWidth;
-	int mapHeight;
-	std::vector<const unsigned char *> map;
-
-	typedef unsigned short tFrameId;
-	typedef int tPrev;
-
-	struct NodeInfo {
-		// quantized min distance from origin
-		unsigned short dist;
-		// frame id (counter to detect new search)
-		tFrameId frameId;
-		// previous node index (packed, relative to current node)
-		tPrev prev;
-
-		inline NodeInfo()
-			: dist(0)
-			, frameId(0)
-			, prev(-1) {
-		}
-	};
-
-	static const float DIST_SCALE_PACK;
-	static const float DIST_SCALE_UNPACK;
-
-	std::vector<NodeInfo> mapNodes;
-	tFrameId frameId;
-
-	std::priority_queue<Entry, std::vector<Entry>, Common::Less<Entry> > pq;
-
-	// temporary buffers:
-	mutable std::vector<int> fpath;
-	std::vector<int> ncpathIndex;
-	std::vector<int> rayPath, orayPath;
-
-	// temps for routing towards unreachable areas
-	int cnode;
-	int closest;
-
-	// orthogonal only (this should correspond to what AGS is doing)
-	bool nodiag;
-
-	bool navLock;
-
-	void IncFrameId();
-
-	// outside map test
-	inline bool Outside(int x, int y) const;
-	// stronger inside test
-	bool Passable(int x, int y) const;
-	// plain access, unchecked
-	inline bool Walkable(int x, int y) const;
-
-	void AddPruned(int *buf, int &bcount, int x, int y) const;
-	bool HasForcedNeighbor(int x, int y, int dx, int dy) const;
-	int FindJump(int x, int y, int dx, int dy, int ex, int ey);
-	int FindOrthoJump(int x, int y, int dx, int dy, int ex, int ey);
-
-	// neighbor reachable (nodiag only)
-	bool Reachable(int x0, int y0, int x1, int y1) const;
-
-	static inline int sign(int n) {
-		return n < 0 ? -1 : (n > 0 ? 1 : 0);
-	}
-
-	static inline int iabs(int n) {
-		return n < 0 ? -n : n;
-	}
-
-	static inline int iclamp(int v, int min, int max) {
-		return v < min ? min : (v > max ? max : v);
-	}
-
-	static inline int ClosestDist(int dx, int dy) {
-		return dx * dx + dy * dy;
-		// Manhattan?
-		//return iabs(dx) + iabs(dy);
-	}
-};
-
 // Navigation
 
 // scale pack of 2 means we can route up to 32767 units (euclidean distance) from starting point
@@ -182,6 +39,11 @@ private:
 const float Navigation::DIST_SCALE_PACK = 2.0f;
 const float Navigation::DIST_SCALE_UNPACK = 1.0f / Navigation::DIST_SCALE_PACK;
 
+const int Navigation::CLUSTER_SIZE;
+const int Navigation::ORTHO_COST;
+const int Navigation::DIAG_COST;
+const int Navigation::NO_ROUTE;
+
 Navigation::Navigation()
 	: mapWidth(0)
 	, mapHeight(0)
@@ -190,7 +52,15 @@ Navigation::Navigation()
 	, closest(0)
 	  // no diagonal route - this should correspond to what AGS does
 	, nodiag(true)
-	, navLock(false) {
+	, navLock(false)
+	, routeCacheSize(32)
+	, routeCacheClock(0)
+	, hierarchical(false)
+	, graphHash(0)
+	, graphWidth(0)
+	, graphHeight(0)
+	, clustersX(0)
+	, clustersY(0) {
 }
 
 void Navigation::Resize(int width, int height) {
@@ -212,26 +82,6 @@ void Navigation::IncFrameId() {
 	}
 }
 
-inline int Navigation::PackSquare(int x, int y) {
-	return (y << 16) + x;
-}
-
-inline void Navigation::UnpackSquare(int sq, int &x, int &y) {
-	y = sq >> 16;
-	x = sq & ((1 << 16) - 1);
-}
-
-inline bool Navigation::Outside(int x, int y) const {
-	return
-	    (unsigned)x >= (unsigned)mapWidth ||
-	    (unsigned)y >= (unsigned)mapHeight;
-}
-
-inline bool Navigation::Walkable(int x, int y) const {
-	// invert condition because of AGS
-	return map[y][x] != 0;
-}
-
 bool Navigation::Passable(int x, int y) const {
 	return !Outside(x, y) && Walkable(x, y);
 }
@@ -348,9 +198,7 @@ Navigation::NavResult Navigation::Navigate(int sx, int sy, int ex, int ey, std::
 	closest = 0x7fffffff;
 	cnode = PackSquare(sx, sy);
 
-	// no clear for priority queue, like, really?!
-	while (!pq.empty())
-		pq.pop();
+	pq.clear();
 
 	pq.push(Entry(0.0, cnode));
 
@@ -625,6 +473,13 @@ Navigation::NavResult Navigation::NavigateRefined(int sx, int sy, int ex, int ey
 		return res;
 	}
 
+	RefinePath(sx, sy, opath, ncpath);
+	return NAV_PATH;
+}
+
+void Navigation::RefinePath(int sx, int sy, std::vector<int> &opath, std::vector<int> &ncpath) {
+	ncpath.clear();
+
 	int fx = sx;
 	int fy = sy;
 
@@ -742,7 +597,7 @@ Navigation::NavResult Navigation::NavigateRefined(int sx, int sy, int ex, int ey
 	}
 
 	if (!adjusted)
-		return NAV_PATH;
+		return;
 
 	// final step (if necessary) is to reconstruct path from compressed path
 
@@ -760,8 +615,6 @@ Navigation::NavResult Navigation::NavigateRefined(int sx, int sy, int ex, int ey
 		for (int j = 1; j < (int)rayPath.size(); j++)
 			opath.push_back(rayPath[j]);
 	}
-
-	return NAV_PATH;
 }
 
 bool Navigation::TraceLine(int srcx, int srcy, int targx, int targy, int &lastValidX, int &lastValidY) const {
@@ -852,4 +705,534 @@ bool Navigation::TraceLine(int srcx, int srcy, int targx, int targy, std::vector
 	return false;
 }
 
+// Route cache
+
+void Navigation::SetRouteCacheSize(int size) {
+	routeCacheSize = size;
+	routeCache.clear();
+}
+
+uint64 Navigation::HashMap() const {
+	// FNV-1a over whole words, in four independent lanes to keep the CPU busy
+	const uint64 prime = 0x100000001b3ULL;
+	uint64 lanes[4] = { 0xcbf29ce484222325ULL, 1, 2, 3 };
+
+	for (int y = 0; y < mapHeight; y++) {
+		const unsigned char *row = map[y];
+		int x = 0;
+
+		for (; x + 32 <= mapWidth; x += 32) {
+			uint64 words[4];
+			memcpy(words, row + x, sizeof(words));
+
+			for (int i = 0; i < 4; i++)
+				lanes[i] = (lanes[i] ^ words[i]) * prime;
+		}
+
+		for (; x < mapWidth; x++)
+			lanes[x & 3] = (lanes[x & 3] ^ row[x]) * prime;
+
+		// multiplying only carries to the upper bits
+		for (int i = 0; i < 4; i++)
+			lanes[i] ^= lanes[i] >> 29;
+	}
+
+	uint64 hash = ((uint64)mapWidth << 32) | (uint32_t)mapHeight;
+
+	for (int i = 0; i < 4; i++) {
+		hash = (hash ^ lanes[i]) * prime;
+		hash ^= hash >> 29;
+	}
+
+	return hash;
+}
+
+Navigation::NavResult Navigation::NavigateCached(int sx, int sy, int ex, int ey, std::vector<int> &ncpath) {
+	stats.Queries++;
+
+	std::vector<int> opath;
+
+	if (routeCacheSize <= 0 && !hierarchical)
+		return NavigateRefined(sx, sy, ex, ey, opath, ncpath);
+
+	const uint64 mapHash = HashMap();
+
+	for (int i = 0; i < (int)routeCache.size(); i++) {
+		CachedRoute &route = routeCache[i];
+
+		if (route.mapHash == mapHash && route.sx == sx && route.sy == sy &&
+		        route.ex == ex && route.ey == ey) {
+			route.lastUse = ++routeCacheClock;
+			stats.CacheHits++;
+			ncpath = route.ncpath;
+			return route.result;
+		}
+	}
+
+	NavResult res;
+
+	if (hierarchical && (clusters.empty() || graphHash != mapHash))
+		UpdateGraph(mapHash);
+
+	if (hierarchical && NavigateHierarchical(sx, sy, ex, ey, opath)) {
+		RefinePath(sx, sy, opath, ncpath);
+		res = NAV_PATH;
+		stats.HierarchicalRoutes++;
+	} else {
+		res = NavigateRefined(sx, sy, ex, ey, opath, ncpath);
+	}
+
+	if (routeCacheSize > 0) {
+		int slot = 0;
+
+		if ((int)routeCache.size() < routeCacheSize) {
+			slot = (int)routeCache.size();
+			routeCache.push_back(CachedRoute());
+		} else {
+			// replace the least recently used route
+			for (int i = 1; i < (int)routeCache.size(); i++) {
+				if (routeCache[i].lastUse < routeCache[slot].lastUse)
+					slot = i;
+			}
+		}
+
+		CachedRoute &route = routeCache[slot];
+		route.mapHash = mapHash;
+		route.sx = sx;
+		route.sy = sy;
+		route.ex = ex;
+		route.ey = ey;
+		route.result = res;
+		route.ncpath = ncpath;
+		route.lastUse = ++routeCacheClock;
+	}
+
+	return res;
+}
+
+// Hierarchical routing
+
+void Navigation::SetHierarchical(bool on) {
+	hierarchical = on;
+	routeCache.clear();
+
+	if (!on) {
+		// free the graph
+		std::vector<Cluster>().swap(clusters);
+		std::vector<unsigned char>().swap(graphMap);
+		graphWidth = graphHeight = 0;
+	}
+}
+
+int Navigation::ClusterOf(int x, int y) const {
+	return (y / CLUSTER_SIZE) * clustersX + x / CLUSTER_SIZE;
+}
+
+void Navigation::GetClusterRect(int cluster, int &x0, int &y0, int &x1, int &y1) const {
+	x0 = (cluster % clustersX) * CLUSTER_SIZE;
+	y0 = (cluster / clustersX) * CLUSTER_SIZE;
+	x1 = std::min(x0 + CLUSTER_SIZE, mapWidth);
+	y1 = std::min(y0 + CLUSTER_SIZE, mapHeight);
+}
+
+void Navigation::AddBorderPortals(std::vector<Cluster> &newClusters, int cluster, int twin,
+                                  int x, int y, int dx, int dy, int length) {
+	// the twin cluster is right of or below the border
+	const int ax = dy;
+	const int ay = dx;
+	int runStart = -1;
+
+	for (int i = 0; i <= length; i++) {
+		const int px = x + i * dx;
+		const int py = y + i * dy;
+		const bool open = i < length &&
+		                  graphMap[py * mapWidth + px] && graphMap[(py + ay) * mapWidth + px + ax];
+
+		if (open) {
+			if (runStart < 0)
+				runStart = i;
+			continue;
+		}
+
+		if (runStart < 0)
+			continue;
+
+		// one portal in the middle of short openings, one at each end of long ones
+		int ends[2];
+		int count = 0;
+
+		if (i - runStart < 6) {
+			ends[count++] = runStart + (i - runStart) / 2;
+		} else {
+			ends[count++] = runStart;
+			ends[count++] = i - 1;
+		}
+
+		for (int j = 0; j < count; j++) {
+			const int ex = x + ends[j] * dx;
+			const int ey = y + ends[j] * dy;
+
+			Portal portal;
+			portal.square = PackSquare(ex, ey);
+			portal.twinCluster = twin;
+			portal.twinIndex = (int)newClusters[twin].portals.size();
+
+			Portal twinPortal;
+			twinPortal.square = PackSquare(ex + ax, ey + ay);
+			twinPortal.twinCluster = cluster;
+			twinPortal.twinIndex = (int)newClusters[cluster].portals.size();
+
+			newClusters[cluster].portals.push_back(portal);
+			newClusters[twin].portals.push_back(twinPortal);
+		}
+
+		runStart = -1;
+	}
+}
+
+void Navigation::SearchCluster(int cluster, int square) {
+	int x0, y0, x1, y1;
+	GetClusterRect(cluster, x0, y0, x1, y1);
+	const int width = x1 - x0;
+
+	clusterCost.resize(width * (y1 - y0));
+	Common::fill(clusterCost.begin(), clusterCost.end(), NO_ROUTE);
+
+	int sx, sy;
+	UnpackSquare(square, sx, sy);
+	const int start = (sy - y0) * width + sx - x0;
+	clusterCost[start] = 0;
+
+	// plain Dijkstra, clusters are small
+	pq.clear();
+	pq.push(Entry(0.0f, start));
+
+	while (!pq.empty()) {
+		Entry e = pq.top();
+		pq.pop();
+
+		const int cost = clusterCost[e.index];
+
+		if ((int)e.cost > cost)
+			continue;
+
+		const int x = x0 + e.index % width;
+		const int y = y0 + e.index / width;
+
+		for (int ny = std::max(y - 1, y0); ny <= std::min(y + 1, y1 - 1); ny++) {
+			for (int nx = std::max(x - 1, x0); nx <= std::min(x + 1, x1 - 1); nx++) {
+				if (nx == x && ny == y)
+					continue;
+
+				const bool diag = nx != x && ny != y;
+
+				if (!Walkable(nx, ny) || (diag && nodiag && !Reachable(x, y, nx, ny)))
+					continue;
+
+				const int ncost = cost + (diag ? DIAG_COST : ORTHO_COST);
+				const int index = (ny - y0) * width + nx - x0;
+
+				if (ncost < clusterCost[index]) {
+					clusterCost[index] = ncost;
+					pq.push(Entry((float)ncost, index));
+				}
+			}
+		}
+	}
+}
+
+void Navigation::GetPortalCosts(int cluster, std::vector<int> &costs) const {
+	int x0, y0, x1, y1;
+	GetClusterRect(cluster, x0, y0, x1, y1);
+	const std::vector<Portal> &portals = clusters[cluster].portals;
+
+	costs.resize(portals.size());
+
+	for (int i = 0; i < (int)portals.size(); i++) {
+		int x, y;
+		UnpackSquare(portals[i].square, x, y);
+		costs[i] = clusterCost[(y - y0) * (x1 - x0) + x - x0];
+	}
+}
+
+void Navigation::UpdateGraph(uint64 mapHash) {
+	std::vector<unsigned char> dirty;
+
+	if (graphWidth != mapWidth || graphHeight != mapHeight) {
+		graphWidth = mapWidth;
+		graphHeight = mapHeight;
+		clustersX = (mapWidth + CLUSTER_SIZE - 1) / CLUSTER_SIZE;
+		clustersY = (mapHeight + CLUSTER_SIZE - 1) / CLUSTER_SIZE;
+		clusters.clear();
+		clusters.resize(clustersX * clustersY);
+		graphMap.clear();
+		graphMap.resize(mapWidth * mapHeight, 0);
+		dirty.resize(clusters.size(), 1);
+	} else {
+		dirty.resize(clusters.size(), 0);
+	}
+
+	// find the clusters which changed since the last update
+	for (int y = 0; y < mapHeight; y++) {
+		const unsigned char *row = map[y];
+		unsigned char *copy = &graphMap[y * mapWidth];
+
+		for (int x = 0; x < mapWidth; x++) {
+			const unsigned char walkable = row[x] != 0;
+
+			if (copy[x] != walkable) {
+				copy[x] = walkable;
+				dirty[ClusterOf(x, y)] = 1;
+			}
+		}
+	}
+
+	// portals are cheap to find, so all borders are scanned
+	std::vector<Cluster> newClusters;
+	newClusters.resize(clusters.size());
+
+	for (int c = 0; c < (int)clusters.size(); c++) {
+		int x0, y0, x1, y1;
+		GetClusterRect(c, x0, y0, x1, y1);
+
+		if (c % clustersX + 1 < clustersX)
+			AddBorderPortals(newClusters, c, c + 1, x1 - 1, y0, 0, 1, y1 - y0);
+
+		if (c / clustersX + 1 < clustersY)
+			AddBorderPortals(newClusters, c, c + clustersX, x0, y1 - 1, 1, 0, x1 - x0);
+	}
+
+	// costs between the portals only change with the cluster and its portals
+	int firstNode = 0;
+
+	for (int c = 0; c < (int)clusters.size(); c++) {
+		Cluster &cluster = newClusters[c];
+		std::vector<Portal> &portals = cluster.portals;
+		const std::vector<Portal> &oldPortals = clusters[c].portals;
+		bool same = !dirty[c] && portals.size() == oldPortals.size();
+
+		for (int i = 0; same && i < (int)portals.size(); i++)
+			same = portals[i].square == oldPortals[i].square;
+
+		cluster.firstNode = firstNode;
+		firstNode += (int)portals.size();
+
+		if (same) {
+			cluster.costs.swap(clusters[c].costs);
+			continue;
+		}
+
+		const int count = (int)portals.size();
+		cluster.costs.resize(count * count);
+
+		for (int i = 0; i < count; i++) {
+			SearchCluster(c, portals[i].square);
+
+			int x0, y0, x1, y1;
+			GetClusterRect(c, x0, y0, x1, y1);
+
+			for (int j = 0; j < count; j++) {
+				int x, y;
+				UnpackSquare(portals[j].square, x, y);
+				cluster.costs[i * count + j] = clusterCost[(y - y0) * (x1 - x0) + x - x0];
+			}
+		}
+
+		stats.ClustersUpdated++;
+	}
+
+	clusters.swap(newClusters);
+
+	nodeSquare.resize(firstNode);
+	nodeCluster.resize(firstNode);
+	nodeTwin.resize(firstNode);
+
+	for (int c = 0; c < (int)clusters.size(); c++) {
+		const Cluster &cluster = clusters[c];
+
+		for (int i = 0; i < (int)cluster.portals.size(); i++) {
+			const Portal &portal = cluster.portals[i];
+			nodeSquare[cluster.firstNode + i] = portal.square;
+			nodeCluster[cluster.firstNode + i] = c;
+			nodeTwin[cluster.firstNode + i] = clusters[portal.twinCluster].firstNode + portal.twinIndex;
+		}
+	}
+
+	graphHash = mapHash;
+	stats.GraphUpdates++;
+}
+
+int Navigation::GraphHeuristic(int node, int ex, int ey) const {
+	if (node >= (int)nodeSquare.size())
+		return 0;
+
+	int x, y;
+	UnpackSquare(nodeSquare[node], x, y);
+	const int dx = iabs(x - ex);
+	const int dy = iabs(y - ey);
+	return ORTHO_COST * std::max(dx, dy) + (DIAG_COST - ORTHO_COST) * std::min(dx, dy);
+}
+
+bool Navigation::AddClusterPath(int cluster, int x, int y, std::vector<int> &opath) const {
+	int x0, y0, x1, y1;
+	GetClusterRect(cluster, x0, y0, x1, y1);
+	const int width = x1 - x0;
+	int cost = clusterCost[(y - y0) * width + x - x0];
+
+	if (cost == NO_ROUTE)
+		return false;
+
+	// go down the costs from SearchCluster, to the square it started from
+	while (cost > 0) {
+		bool found = false;
+
+		for (int ny = std::max(y - 1, y0); !found && ny <= std::min(y + 1, y1 - 1); ny++) {
+			for (int nx = std::max(x - 1, x0); nx <= std::min(x + 1, x1 - 1); nx++) {
+				const bool diag = nx != x && ny != y;
+				const int ncost = cost - (diag ? DIAG_COST : ORTHO_COST);
+
+				if ((nx == x && ny == y) || clusterCost[(ny - y0) * width + nx - x0] != ncost)
+					continue;
+
+				if (diag && nodiag && !Reachable(x, y, nx, ny))
+					continue;
+
+				x = nx;
+				y = ny;
+				cost = ncost;
+				opath.push_back(PackSquare(x, y));
+				found = true;
+				break;
+			}
+		}
+
+		if (!found)
+			return false;
+	}
+
+	return true;
+}
+
+void Navigation::RelaxNode(int node, int from, int cost, int ex, int ey) {
+	if (cost < nodeCost[node]) {
+		nodeCost[node] = cost;
+		nodePrev[node] = from;
+		pq.push(Entry((float)(cost + GraphHeuristic(node, ex, ey)), node));
+	}
+}
+
+bool Navigation::NavigateHierarchical(int sx, int sy, int ex, int ey, std::vector<int> &opath) {
+	// leave the trivial and the unreachable cases to plain JPS
+	if (!Passable(sx, sy) || !Passable(ex, ey))
+		return false;
+
+	const int startCluster = ClusterOf(sx, sy);
+	const int endCluster = ClusterOf(ex, ey);
+
+	if (startCluster == endCluster || !TraceLine(sx, sy, ex, ey))
+		return false;
+
+	SearchCluster(startCluster, PackSquare(sx, sy));
+	GetPortalCosts(startCluster, startCosts);
+	SearchCluster(endCluster, PackSquare(ex, ey));
+	GetPortalCosts(endCluster, endCosts);
+
+	// A* over the portals; the extra last node is the target
+	const int endNode = (int)nodeSquare.size();
+	nodeCost.resize(endNode + 1);
+	nodePrev.resize(endNode + 1);
+	nodeClosed.resize(endNode + 1);
+	Common::fill(nodeCost.begin(), nodeCost.end(), NO_ROUTE);
+	Common::fill(nodePrev.begin(), nodePrev.end(), -1);
+	Common::fill(nodeClosed.begin(), nodeClosed.end(), 0);
+
+	pq.clear();
+
+	const Cluster &start = clusters[startCluster];
+
+	for (int i = 0; i < (int)startCosts.size(); i++) {
+		if (startCosts[i] == NO_ROUTE)
+			continue;
+
+		const int node = start.firstNode + i;
+		nodeCost[node] = startCosts[i];
+		pq.push(Entry((float)(startCosts[i] + GraphHeuristic(node, ex, ey)), node));
+	}
+
+	while (!pq.empty()) {
+		const int node = pq.top().index;
+		pq.pop();
+
+		if (node == endNode)
+			break;
+
+		if (nodeClosed[node])
+			continue;
+
+		nodeClosed[node] = 1;
+
+		const int cost = nodeCost[node];
+		const int c = nodeCluster[node];
+		const Cluster &cluster = clusters[c];
+		const int local = node - cluster.firstNode;
+		const int count = (int)cluster.portals.size();
+
+		for (int j = 0; j < count; j++) {
+			if (j != local && cluster.costs[local * count + j] != NO_ROUTE)
+				RelaxNode(cluster.firstNode + j, node, cost + cluster.costs[local * count + j], ex, ey);
+		}
+
+		RelaxNode(nodeTwin[node], node, cost + ORTHO_COST, ex, ey);
+
+		if (c == endCluster && endCosts[local] != NO_ROUTE)
+			RelaxNode(endNode, node, cost + endCosts[local], ex, ey);
+	}
+
+	if (nodePrev[endNode] < 0)
+		return false;
+
+	waypoints.clear();
+	waypoints.push_back(PackSquare(ex, ey));
+
+	for (int node = nodePrev[endNode]; node >= 0; node = nodePrev[node]) {
+		if (nodeSquare[node] != waypoints.back())
+			waypoints.push_back(nodeSquare[node]);
+	}
+
+	if (waypoints.back() != PackSquare(sx, sy))
+		waypoints.push_back(PackSquare(sx, sy));
+
+	std::reverse(waypoints.begin(), waypoints.end());
+
+	// connect the waypoints, inside their clusters
+	opath.clear();
+	opath.push_back(waypoints[0]);
+
+	for (int i = 0; i < (int)waypoints.size() - 1; i++) {
+		int fx, fy, tx, ty;
+		UnpackSquare(waypoints[i], fx, fy);
+		UnpackSquare(waypoints[i + 1], tx, ty);
+
+		const int cluster = ClusterOf(fx, fy);
+
+		if (cluster != ClusterOf(tx, ty)) {
+			// step across the border
+			opath.push_back(waypoints[i + 1]);
+			continue;
+		}
+
+		if (!TraceLine(fx, fy, tx, ty, &fpath)) {
+			for (int j = 1; j < (int)fpath.size(); j++)
+				opath.push_back(fpath[j]);
+			continue;
+		}
+
+		SearchCluster(cluster, waypoints[i + 1]);
+		if (!AddClusterPath(cluster, fx, fy, opath))
+			return false;
+	}
+
+	return true;
+}
+
 } // namespace AGS3
@@ -20,11 +20,15 @@
  *
  */
 
+#ifndef AGS_ENGINE_AC_ROUTE_FINDER_JPS
+#define AGS_ENGINE_AC_ROUTE_FINDER_JPS
+
 #include "ags/lib/std/queue.h"
 #include "ags/lib/std/vector.h"
 #include "ags/lib/std/algorithm.h"
 #include "ags/lib/std/functional.h"
 #include "ags/lib/std/xutility.h"
+#include "ags/shared/core/types.h"
 
 // Not all platforms define INFINITY
 #ifndef INFINITY
@@ -60,6 +64,37 @@ public:
 
 	NavResult Navigate(int sx, int sy, int ex, int ey, std::vector<int> &opath);
 
+	// Same as NavigateRefined, but only returns the navpoint-compressed path.
+	// Reuses the routes found recently on the same map, and searches the
+	// cluster graph first if hierarchical routing is on.
+	NavResult NavigateCached(int sx, int sy, int ex, int ey, std::vector<int> &ncpath);
+
+	// Number of the routes to remember; 0 disables the route cache
+	void SetRouteCacheSize(int size);
+	// Routing over the cluster graph finds slightly longer paths than JPS,
+	// but is much faster in large rooms with complex walkable areas
+	void SetHierarchical(bool on);
+	bool IsHierarchical() const {
+		return hierarchical;
+	}
+
+	struct Stats {
+		uint32_t Queries = 0;
+		uint32_t CacheHits = 0;
+		// routes found over the cluster graph
+		uint32_t HierarchicalRoutes = 0;
+		// updates of the cluster graph after map changes
+		uint32_t GraphUpdates = 0;
+		uint32_t ClustersUpdated = 0;
+	};
+
+	const Stats &GetStats() const {
+		return stats;
+	}
+	void ResetStats() {
+		stats = Stats();
+	}
+
 	bool TraceLine(int srcx, int srcy, int targx, int targy, int &lastValidX, int &lastValidY) const;
 	bool TraceLine(int srcx, int srcy, int targx, int targy, std::vector<int> *rpath = nullptr) const;
 
@@ -120,7 +155,7 @@ private:
 	std::vector<NodeInfo> mapNodes;
 	tFrameId frameId;
 
-	std::priority_queue<Entry, std::vector<Entry>, Common::Greater<Entry> > pq;
+	std::priority_queue<Entry, std::vector<Entry>, Common::Less<Entry> > pq;
 
 	// temporary buffers:
 	mutable std::vector<int> fpath;
@@ -153,6 +188,78 @@ private:
 	// neighbor reachable (nodiag only)
 	bool Reachable(int x0, int y0, int x1, int y1) const;
 
+	// turns the path from Navigate into the navpoint-compressed path
+	void RefinePath(int sx, int sy, std::vector<int> &opath, std::vector<int> &ncpath);
+
+	uint64 HashMap() const;
+
+	// route cache
+	struct CachedRoute {
+		uint64 mapHash;
+		int sx, sy, ex, ey;
+		NavResult result;
+		std::vector<int> ncpath;
+		uint32_t lastUse;
+	};
+
+	std::vector<CachedRoute> routeCache;
+	int routeCacheSize;
+	uint32_t routeCacheClock;
+
+	// Hierarchical routing: the map is split into square clusters, and
+	// portals are placed on the passable parts of the cluster borders.
+	// A* searches the graph of the portals first, and JPS then only
+	// connects the portals along the found route.
+	static const int CLUSTER_SIZE = 16;
+	// step costs used on the cluster graph
+	static const int ORTHO_COST = 10;
+	static const int DIAG_COST = 14;
+	static const int NO_ROUTE = 0x7fffffff;
+
+	struct Portal {
+		int square;
+		// the portal across the cluster border
+		int twinCluster;
+		int twinIndex;
+	};
+
+	struct Cluster {
+		std::vector<Portal> portals;
+		// costs of the routes between the portals, inside the cluster
+		std::vector<int> costs;
+		// index of the first portal in the graph node arrays
+		int firstNode;
+	};
+
+	bool hierarchical;
+	uint64 graphHash;
+	int graphWidth, graphHeight;
+	int clustersX, clustersY;
+	std::vector<Cluster> clusters;
+	// passability of the map, as of the last graph update
+	std::vector<unsigned char> graphMap;
+	// graph nodes (portals of all clusters)
+	std::vector<int> nodeSquare, nodeCluster, nodeTwin;
+	// temporary buffers for the graph searches
+	std::vector<int> nodeCost, nodePrev, clusterCost, startCosts, endCosts;
+	std::vector<unsigned char> nodeClosed;
+	std::vector<int> waypoints;
+
+	Stats stats;
+
+	int ClusterOf(int x, int y) const;
+	void GetClusterRect(int cluster, int &x0, int &y0, int &x1, int &y1) const;
+	void UpdateGraph(uint64 mapHash);
+	void AddBorderPortals(std::vector<Cluster> &newClusters, int cluster, int twin, int x, int y, int dx, int dy, int length);
+	// costs of the routes from the square to all squares of its cluster
+	void SearchCluster(int cluster, int square);
+	void GetPortalCosts(int cluster, std::vector<int> &costs) const;
+	// adds the route from the square to where SearchCluster started
+	bool AddClusterPath(int cluster, int x, int y, std::vector<int> &opath) const;
+	int GraphHeuristic(int node, int ex, int ey) const;
+	void RelaxNode(int node, int from, int cost, int ex, int ey);
+	bool NavigateHierarchical(int sx, int sy, int ex, int ey, std::vector<int> &opath);
+
 	static inline int sign(int n) {
 		return n < 0 ? -1 : (n > 0 ? 1 : 0);
 	}
@@ -193,3 +300,5 @@ inline bool Navigation::Walkable(int x, int y) const {
 }
 
 } // namespace AGS3
+
+#endif
@@ -22,6 +22,7 @@
 
 #include "ags/lib/std/thread.h"
 #include "ags/engine/ac/timer.h"
+#include "ags/shared/ac/sprite_cache.h"
 #include "ags/shared/core/platform.h"
 #include "ags/engine/ac/sys_events.h"
 #include "ags/engine/platform/base/ags_platform_driver.h"
@@ -73,6 +74,10 @@ void WaitForNextFrame() {
 		_G(next_frame_timestamp) = now;
 	}
 
+	// use the spare time of the frame to load the sprites expected soon
+	if (_G(next_frame_timestamp) > now && _GP(spriteset).ProcessPrefetch(_G(next_frame_timestamp)))
+		now = AGS_Clock::now();
+
 	if (_G(next_frame_timestamp) > now) {
 		auto frame_time_remaining = _G(next_frame_timestamp) - now;
 		std::this_thread::sleep_for(frame_time_remaining);
@@ -124,6 +124,18 @@ void precache_view(int view) {
 	}
 }
 
+void prefetch_view(int view, int loop) {
+	if (view < 0 || view >= _GP(game).numviews)
+		return;
+
+	for (int i = 0; i < _G(views)[view].numLoops; i++) {
+		if (loop >= 0 && i != loop)
+			continue;
+		for (int j = 0; j < _G(views)[view].loops[i].numFrames; j++)
+			_GP(spriteset).PrefetchSprite(_G(views)[view].loops[i].frames[j].pic);
+	}
+}
+
 // the specified frame has just appeared, see if we need
 // to play a sound or whatever
 void CheckViewFrame(int view, int loop, int frame, int sound_volume) {
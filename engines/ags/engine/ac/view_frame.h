@@ -52,6 +52,8 @@ int  ViewFrame_GetLoop(ScriptViewFrame *svf);
 int  ViewFrame_GetFrame(ScriptViewFrame *svf);
 
 void precache_view(int view);
+// Queues the sprites of a view loop (or of all loops, if loop is -1) for prefetching
+void prefetch_view(int view, int loop);
 void CheckViewFrame(int view, int loop, int frame, int sound_volume = SCR_NO_VALUE);
 // draws a view frame, flipped if appropriate
 void DrawViewFrame(Shared::Bitmap *ds, const ViewFrame *vframe, int x, int y, bool alpha_blend = false);
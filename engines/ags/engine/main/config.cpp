@@ -28,6 +28,7 @@
 #include "ags/engine/ac/game_state.h"
 #include "ags/engine/ac/global_translation.h"
 #include "ags/engine/ac/path_helper.h"
+#include "ags/engine/ac/route_finder_jps.h"
 #include "ags/shared/ac/sprite_cache.h"
 #include "ags/engine/ac/system.h"
 #include "ags/shared/core/platform.h"
@@ -361,6 +362,11 @@ void apply_config(const ConfigTree &cfg) {
 		int cache_size_kb = INIreadint(cfg, "misc", "cachemax", DEFAULTCACHESIZE_KB);
 		if (cache_size_kb > 0)
 			_GP(spriteset).SetMaxCacheSize((size_t)cache_size_kb * 1024);
+		SpriteCachePolicyType cache_policy = FindSpriteCachePolicy(INIreadstring(cfg, "misc", "cache_policy", "lru").GetCStr());
+		if (cache_policy != kNumSprCachePolicies)
+			_GP(spriteset).SetPolicy(cache_policy);
+		_GP(nav).SetRouteCacheSize(INIreadint(cfg, "misc", "route_cache", 32));
+		_GP(nav).SetHierarchical(INIreadint(cfg, "misc", "hierarchical_pathfinding", 0) != 0);
 
 		_GP(usetup).mouse_auto_lock = INIreadint(cfg, "mouse", "auto_lock") > 0;
 
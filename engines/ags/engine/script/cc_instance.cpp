@@ -159,6 +159,17 @@ const char *regnames[] = { "null", "sp", "mar", "ax", "bx", "cx", "op", "dx" };
 
 const char *fixupnames[] = { "null", "fix_gldata", "fix_func", "fix_string", "fix_import", "fix_datadata", "fix_stack" };
 
+// Cells of the decoded code. Instruction cells keep the instruction code,
+// instance id, argument count and the registers selected by the first two
+// arguments; argument cells keep the index of the argument's value.
+#define DECODED_INSTRUCTION 0x80000000u
+#define DECODED_ARG_STACK   0x40000000u // the value is a stack offset
+#define DECODED_ARG_IMPORT  0x20000000u // the value is an import
+#define DECODED_VALUE_MASK  0x1fffffffu
+#define DECODED_ARGS_SHIFT  16
+#define DECODED_REG1_SHIFT  18
+#define DECODED_REG2_SHIFT  21
+
 // Function call stack is used to temporarily store
 // values before passing them to script function
 #define MAX_FUNC_PARAMS 20
@@ -224,6 +235,7 @@ ccInstance::ccInstance() {
 	numimports = 0;
 	resolved_imports = nullptr;
 	code_fixups         = nullptr;
+	decoded_code        = nullptr;
 
 	memset(callStackLineNumber, 0, sizeof(callStackLineNumber));
 	memset(callStackAddr, 0, sizeof(callStackAddr));
@@ -419,6 +431,13 @@ int ccInstance::Run(int32_t curpc) {
 	bool write_debug_dump = ccGetOption(SCOPT_DEBUGRUN) ||
 		(gDebugLevel > 0 && DebugMan.isDebugChannelEnabled(::AGS::kDebugScript));
 	ScriptOperation codeOp;
+	// The pre-decoded instructions use the resolved values in place,
+	// others have their arguments read into codeOp
+	const ScriptDecodedCode *decoded = ccGetOption(SCOPT_PREDECODE) ? codeInst->decoded_code : nullptr;
+	const uint32_t *decoded_cells = decoded ? decoded->Cells.data() : nullptr;
+	const RuntimeScriptValue *decoded_values = decoded ? decoded->Values.data() : nullptr;
+	const RuntimeScriptValue *args[MAX_SCMD_ARGS] = { &codeOp.Args[0], &codeOp.Args[1], &codeOp.Args[2] };
+	int reg1_index, reg2_index;
 
 	FunctionCallStack func_callstack;
 
@@ -426,92 +445,132 @@ int ccInstance::Run(int32_t curpc) {
 		if (_G(abort_engine))
 			return -1;
 
-		/*
-		if (!codeInst->ReadOperation(codeOp, pc))
-		{
-		    return -1;
-		}
-		*/
-		/* ReadOperation */
-		//=====================================================================
-		codeOp.Instruction.Code         = codeInst->code[pc];
-		codeOp.Instruction.InstanceId   = (codeOp.Instruction.Code >> INSTANCE_ID_SHIFT) & INSTANCE_ID_MASK;
-		codeOp.Instruction.Code        &= INSTANCE_ID_REMOVEMASK; // now this is pure instruction code
-
-		if (codeOp.Instruction.Code < 0 || codeOp.Instruction.Code >= CC_NUM_SCCMDS) {
-			cc_error("invalid instruction %d found in code stream", codeOp.Instruction.Code);
-			return -1;
-		}
-
-		codeOp.ArgCount = sccmd_info[codeOp.Instruction.Code].ArgCount;
-		if (pc + codeOp.ArgCount >= codeInst->codesize) {
-			cc_error("unexpected end of code data (%d; %d)", pc + codeOp.ArgCount, codeInst->codesize);
-			return -1;
-		}
-
-		int pc_at = pc + 1;
-		for (int i = 0; i < codeOp.ArgCount; ++i, ++pc_at) {
-			char fixup = codeInst->code_fixups[pc_at];
-			if (fixup > 0) {
-				// could be relative pointer or import address
-				/*
-				if (!FixupArgument(code[pc], fixup, codeOp.Args[i]))
-				{
-				    return -1;
+		const uint32_t cell = decoded_cells ? decoded_cells[pc] : 0;
+		if (cell & DECODED_INSTRUCTION) {
+			codeOp.Instruction.Code       = cell & 0xff;
+			codeOp.Instruction.InstanceId = (cell >> 8) & 0xff;
+			codeOp.ArgCount               = (cell >> DECODED_ARGS_SHIFT) & 0x3;
+			for (int i = 0; i < codeOp.ArgCount; ++i) {
+				const uint32_t arg_cell = decoded_cells[pc + 1 + i];
+				if (arg_cell & DECODED_ARG_STACK) {
+					codeOp.Args[i] = GetStackPtrOffsetFw(decoded_values[arg_cell & DECODED_VALUE_MASK].IValue);
+					args[i] = &codeOp.Args[i];
+					continue;
 				}
-				*/
-				/* FixupArgument */
-				//=====================================================================
-				switch (fixup) {
-				case FIXUP_GLOBALDATA: {
-					ScriptVariable *gl_var = (ScriptVariable *)codeInst->code[pc_at];
-					codeOp.Args[i].SetGlobalVar(&gl_var->RValue);
+				args[i] = &decoded_values[arg_cell & DECODED_VALUE_MASK];
+				if (arg_cell & DECODED_ARG_IMPORT) {
+					if (decoded->ImportsVersion != _GP(simp).getVersion())
+						codeInst->UpdateDecodedImports();
+					if (!args[i]->IsValid()) {
+						// The import could not be resolved, look it up again
+						const ScriptImport *import = _GP(simp).getByIndex((int32_t)codeInst->code[pc + 1 + i]);
+						if (!import) {
+							cc_error("cannot resolve import, key = %ld", codeInst->code[pc + 1 + i]);
+							return -1;
+						}
+						codeOp.Args[i] = import->Value;
+						args[i] = &codeOp.Args[i];
+					}
 				}
-				break;
-				case FIXUP_FUNCTION:
-					// originally commented -- CHECKME: could this be used in very old versions of AGS?
-					//      code[fixup] += (long)&code[0];
-					// This is a program counter value, presumably will be used as SCMD_CALL argument
-					codeOp.Args[i].SetInt32((int32_t)codeInst->code[pc_at]);
+			}
+			reg1_index = (cell >> DECODED_REG1_SHIFT) & 0x7;
+			reg2_index = (cell >> DECODED_REG2_SHIFT) & 0x7;
+
+			if (write_debug_dump) {
+				for (int i = 0; i < codeOp.ArgCount; ++i)
+					codeOp.Args[i] = *args[i];
+			}
+		} else {
+			/*
+			if (!codeInst->ReadOperation(codeOp, pc))
+			{
+			    return -1;
+			}
+			*/
+			/* ReadOperation */
+			//=====================================================================
+			codeOp.Instruction.Code         = codeInst->code[pc];
+			codeOp.Instruction.InstanceId   = (codeOp.Instruction.Code >> INSTANCE_ID_SHIFT) & INSTANCE_ID_MASK;
+			codeOp.Instruction.Code        &= INSTANCE_ID_REMOVEMASK; // now this is pure instruction code
+
+			if (codeOp.Instruction.Code < 0 || codeOp.Instruction.Code >= CC_NUM_SCCMDS) {
+				cc_error("invalid instruction %d found in code stream", codeOp.Instruction.Code);
+				return -1;
+			}
+
+			codeOp.ArgCount = sccmd_info[codeOp.Instruction.Code].ArgCount;
+			if (pc + codeOp.ArgCount >= codeInst->codesize) {
+				cc_error("unexpected end of code data (%d; %d)", pc + codeOp.ArgCount, codeInst->codesize);
+				return -1;
+			}
+
+			int pc_at = pc + 1;
+			for (int i = 0; i < codeOp.ArgCount; ++i, ++pc_at) {
+				char fixup = codeInst->code_fixups[pc_at];
+				if (fixup > 0) {
+					// could be relative pointer or import address
+					/*
+					if (!FixupArgument(code[pc], fixup, codeOp.Args[i]))
+					{
+					    return -1;
+					}
+					*/
+					/* FixupArgument */
+					//=====================================================================
+					switch (fixup) {
+					case FIXUP_GLOBALDATA: {
+						ScriptVariable *gl_var = (ScriptVariable *)codeInst->code[pc_at];
+						codeOp.Args[i].SetGlobalVar(&gl_var->RValue);
+					}
 					break;
-				case FIXUP_STRING:
-					codeOp.Args[i].SetStringLiteral(&codeInst->strings[0] + codeInst->code[pc_at]);
+					case FIXUP_FUNCTION:
+						// originally commented -- CHECKME: could this be used in very old versions of AGS?
+						//      code[fixup] += (long)&code[0];
+						// This is a program counter value, presumably will be used as SCMD_CALL argument
+						codeOp.Args[i].SetInt32((int32_t)codeInst->code[pc_at]);
+						break;
+					case FIXUP_STRING:
+						codeOp.Args[i].SetStringLiteral(&codeInst->strings[0] + codeInst->code[pc_at]);
+						break;
+					case FIXUP_IMPORT: {
+						const ScriptImport *import = _GP(simp).getByIndex((int32_t)codeInst->code[pc_at]);
+						if (import) {
+							codeOp.Args[i] = import->Value;
+						} else {
+							cc_error("cannot resolve import, key = %ld", codeInst->code[pc_at]);
+							return -1;
+						}
+					}
 					break;
-				case FIXUP_IMPORT: {
-					const ScriptImport *import = _GP(simp).getByIndex((int32_t)codeInst->code[pc_at]);
-					if (import) {
-						codeOp.Args[i] = import->Value;
-					} else {
-						cc_error("cannot resolve import, key = %ld", codeInst->code[pc_at]);
+					case FIXUP_STACK:
+						codeOp.Args[i] = GetStackPtrOffsetFw((int32_t)codeInst->code[pc_at]);
+						break;
+					default:
+						cc_error("internal fixup type error: %d", fixup);
 						return -1;
 					}
+					/* End FixupArgument */
+					//=====================================================================
+				} else {
+					// should be a numeric literal (int32 or float)
+					codeOp.Args[i].SetInt32((int32_t)codeInst->code[pc_at]);
 				}
-				break;
-				case FIXUP_STACK:
-					codeOp.Args[i] = GetStackPtrOffsetFw((int32_t)codeInst->code[pc_at]);
-					break;
-				default:
-					cc_error("internal fixup type error: %d", fixup);
-					return -1;
-				}
-				/* End FixupArgument */
-				//=====================================================================
-			} else {
-				// should be a numeric literal (int32 or float)
-				codeOp.Args[i].SetInt32((int32_t)codeInst->code[pc_at]);
 			}
+			/* End ReadOperation */
+			//=====================================================================
+
+			for (int i = 0; i < MAX_SCMD_ARGS; ++i)
+				args[i] = &codeOp.Args[i];
+			reg1_index = codeOp.Args[0].IValue >= 0 && codeOp.Args[0].IValue < CC_NUM_REGISTERS ? codeOp.Args[0].IValue : 0;
+			reg2_index = codeOp.Args[1].IValue >= 0 && codeOp.Args[1].IValue < CC_NUM_REGISTERS ? codeOp.Args[1].IValue : 0;
 		}
-		/* End ReadOperation */
-		//=====================================================================
 
 		// save the arguments for quick access
-		RuntimeScriptValue &arg1 = codeOp.Args[0];
-		RuntimeScriptValue &arg2 = codeOp.Args[1];
-		RuntimeScriptValue &arg3 = codeOp.Args[2];
-		RuntimeScriptValue &reg1 =
-		    registers[arg1.IValue >= 0 && arg1.IValue < CC_NUM_REGISTERS ? arg1.IValue : 0];
-		RuntimeScriptValue &reg2 =
-		    registers[arg2.IValue >= 0 && arg2.IValue < CC_NUM_REGISTERS ? arg2.IValue : 0];
+		const RuntimeScriptValue &arg1 = *args[0];
+		const RuntimeScriptValue &arg2 = *args[1];
+		const RuntimeScriptValue &arg3 = *args[2];
+		RuntimeScriptValue &reg1 = registers[reg1_index];
+		RuntimeScriptValue &reg2 = registers[reg2_index];
 
 		const char *direct_ptr1;
 		const char *direct_ptr2;
@@ -1392,6 +1451,7 @@ bool ccInstance::_Create(PScript scri, ccInstance *joined) {
 	if (joined) {
 		resolved_imports = joined->resolved_imports;
 		code_fixups = joined->code_fixups;
+		decoded_code = joined->decoded_code;
 	} else {
 		if (!ResolveScriptImports(scri)) {
 			return false;
@@ -1402,6 +1462,8 @@ bool ccInstance::_Create(PScript scri, ccInstance *joined) {
 		if (!CreateRuntimeCodeFixups(scri)) {
 			return false;
 		}
+		if (ccGetOption(SCOPT_PREDECODE))
+			CreateDecodedCode();
 	}
 
 	exports = new RuntimeScriptValue[scri->numexports];
@@ -1477,9 +1539,11 @@ void ccInstance::Free() {
 	if ((flags & INSTF_SHAREDATA) == 0) {
 		delete[] resolved_imports;
 		delete[] code_fixups;
+		delete decoded_code;
 	}
 	resolved_imports = nullptr;
 	code_fixups = nullptr;
+	decoded_code = nullptr;
 }
 
 bool ccInstance::ResolveScriptImports(PScript scri) {
@@ -1658,6 +1722,107 @@ bool ccInstance::CreateRuntimeCodeFixups(PScript scri) {
 	return true;
 }
 
+void ccInstance::CreateDecodedCode() {
+	enum ArgKind {
+		kArgLiteral, kArgGlobalData, kArgString, kArgImport, kNumArgKinds
+	};
+	// values already added, by kind and code value
+	std::unordered_map<int32_t, uint32_t> known_values[kNumArgKinds];
+
+	decoded_code = new ScriptDecodedCode();
+	decoded_code->Cells.resize(codesize, 0);
+	decoded_code->ImportsVersion = _GP(simp).getVersion();
+	uint32_t *cells = decoded_code->Cells.data();
+
+	// Anything which fails to decode is left to Run, to report the error
+	// if the code is ever reached
+	for (int32_t at = 0; at < codesize;) {
+		const int32_t instr = (int32_t)(code[at] & INSTANCE_ID_REMOVEMASK);
+		const int32_t inst_id = (int32_t)((code[at] >> INSTANCE_ID_SHIFT) & INSTANCE_ID_MASK);
+		if (instr < 0 || instr >= CC_NUM_SCCMDS)
+			return;
+		const int arg_count = sccmd_info[instr].ArgCount;
+		if (at + arg_count >= codesize)
+			return;
+
+		uint32_t regs[2] = { 0, 0 };
+		for (int i = 0; i < arg_count; ++i) {
+			const int32_t at_arg = at + 1 + i;
+			RuntimeScriptValue value;
+			ArgKind kind = kArgLiteral;
+			int32_t key = (int32_t)code[at_arg];
+			uint32_t arg_flags = 0;
+			switch (code_fixups[at_arg]) {
+			case 0:
+			case FIXUP_FUNCTION:
+				value.SetInt32(key);
+				if (i < 2 && key >= 0 && key < CC_NUM_REGISTERS)
+					regs[i] = key;
+				break;
+			case FIXUP_STACK:
+				value.SetInt32(key);
+				arg_flags = DECODED_ARG_STACK;
+				break;
+			case FIXUP_GLOBALDATA: {
+				ScriptVariable *gl_var = (ScriptVariable *)code[at_arg];
+				value.SetGlobalVar(&gl_var->RValue);
+				kind = kArgGlobalData;
+				key = gl_var->ScAddress;
+				break;
+			}
+			case FIXUP_STRING:
+				value.SetStringLiteral(&strings[0] + code[at_arg]);
+				kind = kArgString;
+				break;
+			case FIXUP_IMPORT: {
+				// Unresolved imports are left with an invalid value, and
+				// only fail the instructions which use them
+				const ScriptImport *import = _GP(simp).getByIndex(key);
+				if (import)
+					value = import->Value;
+				kind = kArgImport;
+				arg_flags = DECODED_ARG_IMPORT;
+				break;
+			}
+			default:
+				return;
+			}
+
+			std::unordered_map<int32_t, uint32_t>::const_iterator it = known_values[kind].find(key);
+			uint32_t value_index;
+			if (it != known_values[kind].end()) {
+				value_index = it->_value;
+			} else {
+				value_index = decoded_code->Values.size();
+				if (value_index > DECODED_VALUE_MASK)
+					return;
+				decoded_code->Values.push_back(value);
+				known_values[kind][key] = value_index;
+				if (kind == kArgImport) {
+					ScriptDecodedCode::ImportValue import_value = { value_index, key };
+					decoded_code->Imports.push_back(import_value);
+				}
+			}
+			cells[at_arg] = arg_flags | value_index;
+		}
+
+		cells[at] = DECODED_INSTRUCTION | instr | (inst_id << 8) | (arg_count << DECODED_ARGS_SHIFT) |
+			(regs[0] << DECODED_REG1_SHIFT) | (regs[1] << DECODED_REG2_SHIFT);
+		at += arg_count + 1;
+	}
+}
+
+void ccInstance::UpdateDecodedImports() {
+	for (const auto &import_value : decoded_code->Imports) {
+		const ScriptImport *import = _GP(simp).getByIndex(import_value.ImportIndex);
+		if (import)
+			decoded_code->Values[import_value.ValueIndex] = import->Value;
+		else
+			decoded_code->Values[import_value.ValueIndex].Invalidate();
+	}
+	decoded_code->ImportsVersion = _GP(simp).getVersion();
+}
+
 /*
 bool ccInstance::ReadOperation(ScriptOperation &op, int32_t at_pc)
 {
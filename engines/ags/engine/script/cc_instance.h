@@ -25,6 +25,7 @@
 
 #include "ags/lib/std/memory.h"
 #include "ags/lib/std/map.h"
+#include "ags/lib/std/vector.h"
 #include "ags/shared/script/script_common.h"
 #include "ags/shared/script/cc_script.h"  // ccScript
 #include "ags/engine/script/non_blocking_script_function.h"
@@ -82,6 +83,25 @@ struct ScriptVariable {
 	RuntimeScriptValue  RValue;
 };
 
+// Byte-code decoded ahead of the execution. Instructions have their code,
+// argument count and registers unpacked, and their arguments refer to values
+// which were resolved when the script was loaded; only the stack offsets are
+// resolved when the instruction is run. There is one cell per code element,
+// so that the program counter and the jump and call addresses stay the same.
+struct ScriptDecodedCode {
+	struct ImportValue {
+		uint32_t ValueIndex;
+		int      ImportIndex;
+	};
+
+	std::vector<uint32_t> Cells;
+	// argument values; each value is only kept once
+	std::vector<RuntimeScriptValue> Values;
+	// values that are imports, updated when the system imports change
+	std::vector<ImportValue> Imports;
+	uint32_t ImportsVersion = 0;
+};
+
 struct FunctionCallStack;
 
 struct ScriptPosition {
@@ -143,6 +163,8 @@ public:
 	int  numimports;
 
 	char *code_fixups;
+	// pre-decoded byte-code, or null if the code is run as it is
+	ScriptDecodedCode *decoded_code;
 
 	// returns the currently executing instance, or NULL if none
 	static ccInstance *GetCurrentInstance(void);
@@ -185,6 +207,11 @@ protected:
 	bool    AddGlobalVar(const ScriptVariable &glvar);
 	ScriptVariable *FindGlobalVar(int32_t var_addr);
 	bool    CreateRuntimeCodeFixups(PScript scri);
+	// Decodes the code after the fixups were applied
+	void    CreateDecodedCode();
+	// Resolves the imports of the decoded code again; those which are not
+	// there anymore are given an invalid value
+	void    UpdateDecodedImports();
 	//bool    ReadOperation(ScriptOperation &op, int32_t at_pc);
 
 	// Runtime fixups
@@ -34,6 +34,7 @@ int SystemImports::add(const String &name, const RuntimeScriptValue &value, ccIn
 		if (anotherscr == nullptr) {
 			imports[ixof].Value = value;
 			imports[ixof].InstancePtr = anotherscr;
+			version++;
 		}
 		return 0;
 	}
@@ -52,6 +53,7 @@ int SystemImports::add(const String &name, const RuntimeScriptValue &value, ccIn
 	imports[ixof].Name = name; // TODO: rather make a string copy here for safety reasons
 	imports[ixof].Value = value;
 	imports[ixof].InstancePtr = anotherscr;
+	version++;
 	return 0;
 }
 
@@ -63,6 +65,7 @@ void SystemImports::remove(const String &name) {
 	imports[idx].Name = nullptr;
 	imports[idx].Value.Invalidate();
 	imports[idx].InstancePtr = nullptr;
+	version++;
 }
 
 const ScriptImport *SystemImports::getByName(const String &name) {
@@ -127,6 +130,7 @@ void SystemImports::RemoveScriptExports(ccInstance *inst) {
 			imports[i].Name = nullptr;
 			imports[i].Value.Invalidate();
 			imports[i].InstancePtr = nullptr;
+			version++;
 		}
 	}
 }
@@ -134,6 +138,7 @@ void SystemImports::RemoveScriptExports(ccInstance *inst) {
 void SystemImports::clear() {
 	btree.clear();
 	imports.clear();
+	version++;
 }
 
 } // namespace AGS3
@@ -51,6 +51,8 @@ private:
 
 	std::vector<ScriptImport> imports;
 	IndexMap btree;
+	// changes whenever an import is added, replaced or removed
+	uint32_t version = 0;
 
 public:
 	int  add(const String &name, const RuntimeScriptValue &value, ccInstance *inst);
@@ -61,6 +63,9 @@ public:
 	String findName(const RuntimeScriptValue &value);
 	void RemoveScriptExports(ccInstance *inst);
 	void clear();
+	uint32_t getVersion() const {
+		return version;
+	}
 };
 
 } // namespace AGS3
@@ -134,7 +134,7 @@ Globals::Globals() {
 	_GlobalReturnValue = new RuntimeScriptValue();
 
 	// cc_options.cpp globals
-	_ccCompOptions = SCOPT_LEFTTORIGHT;
+	_ccCompOptions = SCOPT_LEFTTORIGHT | SCOPT_PREDECODE;
 
 	// cc_serializer.cpp globals
 	_ccUnserializer = new AGSDeSerializer();
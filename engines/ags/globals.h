@@ -215,6 +215,9 @@ public:
 	int _trans_blend_green = 0;
 	int _trans_blend_blue = 0;
 	BlenderMode __blender_mode = kRgbToRgbBlender;
+	// Use the row kernels of BITMAP::draw, and their SIMD implementation
+	bool _blender_row_kernels = true;
+	bool _blender_simd = true;
 	/* current format information and worker routines */
 	int _utype = U_UTF8;
 
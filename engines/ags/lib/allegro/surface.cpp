@@ -20,6 +20,14 @@
  *
  */
 
+#if defined(__SSE2__)
+#define USE_SSE2_BLENDING
+#include <emmintrin.h>
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#define USE_NEON_BLENDING
+#include <arm_neon.h>
+#endif
+
 #include "ags/lib/allegro/gfx.h"
 #include "ags/lib/allegro/color.h"
 #include "ags/lib/allegro/flood.h"
@@ -167,6 +175,37 @@ void BITMAP::draw(const BITMAP *srcBitmap, const Common::Rect &srcRect,
 	int xStart = (dstRect.left < destRect.left) ? dstRect.left - destRect.left : 0;
 	int yStart = (dstRect.top < destRect.top) ? dstRect.top - destRect.top : 0;
 
+	if (canUseRowKernels(srcBitmap) && (!useTint || srcAlpha == -1)) {
+		// Visible part of the rows
+		const int xMin = MAX(0, -xStart);
+		const int xMax = MIN<int>(dstRect.width(), destArea.w - xStart);
+		if (xMin >= xMax)
+			return;
+
+		Common::Array<uint32> rowBuffer;
+		if (horizFlip)
+			rowBuffer.resize(xMax - xMin);
+
+		for (int destY = yStart, yCtr = 0; yCtr < dstRect.height(); ++destY, ++yCtr) {
+			if (destY < 0 || destY >= destArea.h)
+				continue;
+			uint32 *destP = (uint32 *)destArea.getBasePtr(xStart + xMin, destY);
+			const uint32 *srcP = (const uint32 *)src.getBasePtr(
+			                         horizFlip ? srcArea.right - 1 : srcArea.left,
+			                         vertFlip ? srcArea.bottom - 1 - yCtr :
+			                         srcArea.top + yCtr);
+
+			if (horizFlip) {
+				for (int i = 0; i < xMax - xMin; ++i)
+					rowBuffer[i] = srcP[-(xMin + i)];
+				drawRow32(&rowBuffer[0], destP, xMax - xMin, skipTrans, srcAlpha);
+			} else {
+				drawRow32(srcP + xMin, destP, xMax - xMin, skipTrans, srcAlpha);
+			}
+		}
+		return;
+	}
+
 	for (int destY = yStart, yCtr = 0; yCtr < dstRect.height(); ++destY, ++yCtr) {
 		if (destY < 0 || destY >= destArea.h)
 			continue;
@@ -294,6 +333,31 @@ void BITMAP::stretchDraw(const BITMAP *srcBitmap, const Common::Rect &srcRect,
 	int xStart = (dstRect.left < destRect.left) ? dstRect.left - destRect.left : 0;
 	int yStart = (dstRect.top < destRect.top) ? dstRect.top - destRect.top : 0;
 
+	if (canUseRowKernels(srcBitmap)) {
+		// Visible part of the rows
+		const int xMin = MAX(0, -xStart);
+		const int xMax = MIN<int>(dstRect.width(), destArea.w - xStart);
+		if (xMin >= xMax)
+			return;
+
+		Common::Array<uint32> rowBuffer;
+		rowBuffer.resize(xMax - xMin);
+
+		for (int destY = yStart, yCtr = 0, scaleYCtr = 0; yCtr < dstRect.height();
+		        ++destY, ++yCtr, scaleYCtr += scaleY) {
+			if (destY < 0 || destY >= destArea.h)
+				continue;
+			uint32 *destP = (uint32 *)destArea.getBasePtr(xStart + xMin, destY);
+			const uint32 *srcP = (const uint32 *)src.getBasePtr(
+			                         srcRect.left, srcRect.top + scaleYCtr / SCALE_THRESHOLD);
+
+			for (int i = 0; i < xMax - xMin; ++i)
+				rowBuffer[i] = srcP[(xMin + i) * scaleX / SCALE_THRESHOLD];
+			drawRow32(&rowBuffer[0], destP, xMax - xMin, skipTrans, srcAlpha);
+		}
+		return;
+	}
+
 	for (int destY = yStart, yCtr = 0, scaleYCtr = 0; yCtr < dstRect.height();
 	        ++destY, ++yCtr, scaleYCtr += scaleY) {
 		if (destY < 0 || destY >= destArea.h)
@@ -416,6 +480,288 @@ void BITMAP::blendTintSprite(uint8 aSrc, uint8 rSrc, uint8 gSrc, uint8 bSrc, uin
 	// Preserve value in aDest
 }
 
+namespace {
+
+// Bits of the ARGB8888 format used by the row kernels
+const uint32 kAlphaMask32 = 0xFF000000;
+const uint32 kRgbMask32 = 0x00FFFFFF;
+// Allegro's transparent color, bright pink with the alpha ignored
+const uint32 kTransColor32 = 0x00FF00FF;
+
+#if defined(USE_SSE2_BLENDING)
+#define USE_SIMD_BLENDING
+
+typedef __m128i Vec;
+
+inline Vec vLoad(const uint32 *p) { return _mm_loadu_si128((const __m128i *)p); }
+inline void vStore(uint32 *p, Vec v) { _mm_storeu_si128((__m128i *)p, v); }
+inline Vec vSet(uint32 x) { return _mm_set1_epi32((int)x); }
+inline Vec vAnd(Vec a, Vec b) { return _mm_and_si128(a, b); }
+inline Vec vOr(Vec a, Vec b) { return _mm_or_si128(a, b); }
+inline Vec vAdd(Vec a, Vec b) { return _mm_add_epi32(a, b); }
+inline Vec vSub(Vec a, Vec b) { return _mm_sub_epi32(a, b); }
+inline Vec vShr8(Vec a) { return _mm_srli_epi32(a, 8); }
+inline Vec vShr24(Vec a) { return _mm_srli_epi32(a, 24); }
+inline Vec vEq(Vec a, Vec b) { return _mm_cmpeq_epi32(a, b); }
+inline Vec vAddSat8(Vec a, Vec b) { return _mm_adds_epu8(a, b); }
+inline Vec vSelect(Vec mask, Vec a, Vec b) { return _mm_or_si128(_mm_and_si128(mask, a), _mm_andnot_si128(mask, b)); }
+inline bool vAny(Vec mask) { return _mm_movemask_epi8(mask) != 0; }
+
+// The low 32 bits of the products, which SSE2 has no instruction for
+inline Vec vMul(Vec a, Vec b) {
+	const Vec even = _mm_mul_epu32(a, b);
+	const Vec odd = _mm_mul_epu32(_mm_srli_epi64(a, 32), _mm_srli_epi64(b, 32));
+	return _mm_unpacklo_epi32(_mm_shuffle_epi32(even, _MM_SHUFFLE(0, 0, 2, 0)),
+	                          _mm_shuffle_epi32(odd, _MM_SHUFFLE(0, 0, 2, 0)));
+}
+
+#elif defined(USE_NEON_BLENDING)
+#define USE_SIMD_BLENDING
+
+typedef uint32x4_t Vec;
+
+inline Vec vLoad(const uint32 *p) { return vld1q_u32((const uint32_t *)p); }
+inline void vStore(uint32 *p, Vec v) { vst1q_u32((uint32_t *)p, v); }
+inline Vec vSet(uint32 x) { return vdupq_n_u32(x); }
+inline Vec vAnd(Vec a, Vec b) { return vandq_u32(a, b); }
+inline Vec vOr(Vec a, Vec b) { return vorrq_u32(a, b); }
+inline Vec vAdd(Vec a, Vec b) { return vaddq_u32(a, b); }
+inline Vec vSub(Vec a, Vec b) { return vsubq_u32(a, b); }
+inline Vec vShr8(Vec a) { return vshrq_n_u32(a, 8); }
+inline Vec vShr24(Vec a) { return vshrq_n_u32(a, 24); }
+inline Vec vEq(Vec a, Vec b) { return vceqq_u32(a, b); }
+inline Vec vAddSat8(Vec a, Vec b) { return vreinterpretq_u32_u8(vqaddq_u8(vreinterpretq_u8_u32(a), vreinterpretq_u8_u32(b))); }
+inline Vec vSelect(Vec mask, Vec a, Vec b) { return vbslq_u32(mask, a, b); }
+inline Vec vMul(Vec a, Vec b) { return vmulq_u32(a, b); }
+
+inline bool vAny(Vec mask) {
+	const uint32x2_t m = vorr_u32(vget_low_u32(mask), vget_high_u32(mask));
+	return (vget_lane_u32(m, 0) | vget_lane_u32(m, 1)) != 0;
+}
+
+#endif
+
+#ifdef USE_SIMD_BLENDING
+
+/**
+ * BITMAP::rgbBlend for four pixels. The alpha must already be incremented.
+ * The wrap-around of the 32 bit arithmetic is the same as in the original.
+ */
+inline Vec rgbBlend4(Vec s, Vec d, Vec alpha) {
+	const Vec rbMask = vSet(0xFF00FF);
+	const Vec gMask = vSet(0xFF00);
+	const Vec dg = vAnd(d, gMask);
+	const Vec rb = vAdd(vShr8(vMul(vSub(vAnd(s, rbMask), vAnd(d, rbMask)), alpha)), vAnd(d, vSet(kRgbMask32)));
+	const Vec g = vAdd(vShr8(vMul(vSub(vAnd(s, gMask), dg), alpha)), dg);
+	return vOr(vAnd(rb, rbMask), vAnd(g, gMask));
+}
+
+// The "if (alpha) alpha++" of rgbBlend
+inline Vec incrementAlpha(Vec alpha) {
+	const Vec one = vSet(1);
+	return vSub(vAdd(alpha, one), vAnd(vEq(alpha, vSet(0)), one));
+}
+
+// The alpha of blendArgbToArgb and blendArgbToRgb
+inline Vec pixelAlpha(Vec s, uint32 alpha) {
+	if (alpha == 0)
+		return vShr24(s);
+	return vShr8(vMul(vShr24(s), vSet((alpha & 0xff) + 1)));
+}
+
+/**
+ * Blend four pixels. Lanes which need the scalar code are set in
+ * scalarLanes, for those the returned pixel is the unchanged destination.
+ */
+template<int MODE>
+inline Vec blend4(Vec s, Vec d, uint32 alpha, Vec &scalarLanes) {
+	const Vec alphaMask = vSet(kAlphaMask32);
+
+	switch (MODE) {
+	case kSourceAlphaBlender:
+		return rgbBlend4(s, d, incrementAlpha(vShr24(s)));
+	case kArgbToArgbBlender: {
+		// Only fully transparent and fully opaque pixels are done here,
+		// argbBlend uses floating point for everything else
+		const Vec a = pixelAlpha(s, alpha);
+		const Vec opaque = vEq(a, vSet(0xff));
+		scalarLanes = vEq(vOr(opaque, vEq(a, vSet(0))), vSet(0));
+		return vSelect(opaque, vOr(s, alphaMask), d);
+	}
+	case kArgbToRgbBlender:
+		return rgbBlend4(s, d, incrementAlpha(pixelAlpha(s, alpha)));
+	case kRgbToArgbBlender:
+		// Only used for an alpha of 0 or 0xff
+	case kOpaqueBlenderMode:
+		return vOr(s, alphaMask);
+	case kRgbToRgbBlender:
+		return rgbBlend4(s, d, vSet(alpha ? alpha + 1 : 0));
+	case kAlphaPreservedBlenderMode:
+		return vOr(rgbBlend4(s, d, vSet(alpha ? alpha + 1 : 0)), vAnd(d, alphaMask));
+	case kAdditiveBlenderMode:
+		return vOr(vAnd(s, vSet(kRgbMask32)), vAddSat8(vAnd(s, alphaMask), vAnd(d, alphaMask)));
+	default:
+		scalarLanes = vSet(0xFFFFFFFF);
+		return d;
+	}
+}
+
+#endif
+
+} // End of anonymous namespace
+
+bool BITMAP::canUseRowKernels(const BITMAP *srcBitmap) const {
+	if (!_G(blender_row_kernels) || srcBitmap->format != format ||
+	        format != Graphics::PixelFormat(4, 8, 8, 8, 8, 16, 8, 0, 24))
+		return false;
+
+	// The kernels read several source pixels before writing, so the
+	// bitmaps must not share any pixels
+	const byte *srcStart = srcBitmap->getPixels();
+	const byte *srcEnd = srcStart + srcBitmap->h * srcBitmap->pitch;
+	const byte *destStart = getPixels();
+	const byte *destEnd = destStart + h * pitch;
+	return srcEnd <= destStart || destEnd <= srcStart;
+}
+
+void BITMAP::drawRow32(const uint32 *src, uint32 *dest, int count, bool skipTrans, int srcAlpha) const {
+	if (srcAlpha == -1) {
+		// No blending, so only the transparent color is skipped
+		int x = 0;
+#ifdef USE_SIMD_BLENDING
+		if (_G(blender_simd)) {
+			// The masked source never matches an invalid transparent color
+			const Vec transColor = vSet(skipTrans ? kTransColor32 : 0xFFFFFFFF);
+			for (; x + 4 <= count; x += 4) {
+				const Vec s = vLoad(src + x);
+				const Vec skip = vEq(vAnd(s, vSet(kRgbMask32)), transColor);
+				vStore(dest + x, vSelect(skip, vLoad(dest + x), s));
+			}
+		}
+#endif
+		for (; x < count; ++x) {
+			if (!skipTrans || (src[x] & kRgbMask32) != kTransColor32)
+				dest[x] = src[x];
+		}
+		return;
+	}
+
+	const uint32 alpha = srcAlpha;
+	switch (_G(_blender_mode)) {
+	case kSourceAlphaBlender:
+		blendRow32<kSourceAlphaBlender>(src, dest, count, skipTrans, alpha);
+		break;
+	case kArgbToArgbBlender:
+		blendRow32<kArgbToArgbBlender>(src, dest, count, skipTrans, alpha);
+		break;
+	case kArgbToRgbBlender:
+		blendRow32<kArgbToRgbBlender>(src, dest, count, skipTrans, alpha);
+		break;
+	case kRgbToArgbBlender:
+		blendRow32<kRgbToArgbBlender>(src, dest, count, skipTrans, alpha);
+		break;
+	case kRgbToRgbBlender:
+		blendRow32<kRgbToRgbBlender>(src, dest, count, skipTrans, alpha);
+		break;
+	case kAlphaPreservedBlenderMode:
+		blendRow32<kAlphaPreservedBlenderMode>(src, dest, count, skipTrans, alpha);
+		break;
+	case kOpaqueBlenderMode:
+		blendRow32<kOpaqueBlenderMode>(src, dest, count, skipTrans, alpha);
+		break;
+	case kAdditiveBlenderMode:
+		blendRow32<kAdditiveBlenderMode>(src, dest, count, skipTrans, alpha);
+		break;
+	case kTintBlenderMode:
+		blendRow32<kTintBlenderMode>(src, dest, count, skipTrans, alpha);
+		break;
+	case kTintLightBlenderMode:
+		blendRow32<kTintLightBlenderMode>(src, dest, count, skipTrans, alpha);
+		break;
+	}
+}
+
+template<int MODE>
+void BITMAP::blendRow32(const uint32 *src, uint32 *dest, int count, bool skipTrans, uint32 alpha) const {
+	int x = 0;
+
+#ifdef USE_SIMD_BLENDING
+	// The tint blenders work in HSV space, so they are always scalar
+	if (_G(blender_simd) && MODE != kTintBlenderMode && MODE != kTintLightBlenderMode &&
+	        (MODE != kRgbToArgbBlender || alpha == 0 || alpha == 0xff)) {
+		const Vec transColor = vSet(skipTrans ? kTransColor32 : 0xFFFFFFFF);
+
+		for (; x + 4 <= count; x += 4) {
+			const Vec s = vLoad(src + x);
+			const Vec d = vLoad(dest + x);
+			const Vec skip = vEq(vAnd(s, vSet(kRgbMask32)), transColor);
+			Vec scalarLanes = vSet(0);
+			vStore(dest + x, vSelect(skip, d, blend4<MODE>(s, d, alpha, scalarLanes)));
+
+			scalarLanes = vSelect(skip, vSet(0), scalarLanes);
+			if (vAny(scalarLanes)) {
+				uint32 lanes[4];
+				vStore(lanes, scalarLanes);
+				for (int i = 0; i < 4; ++i) {
+					if (lanes[i])
+						dest[x + i] = blendPixel32<MODE>(src[x + i], dest[x + i], alpha);
+				}
+			}
+		}
+	}
+#endif
+
+	for (; x < count; ++x) {
+		const uint32 srcCol = src[x];
+		if (skipTrans && (srcCol & kRgbMask32) == kTransColor32)
+			continue;
+		dest[x] = blendPixel32<MODE>(srcCol, dest[x], alpha);
+	}
+}
+
+template<int MODE>
+inline uint32 BITMAP::blendPixel32(uint32 srcCol, uint32 destCol, uint32 alpha) const {
+	const uint8 aSrc = srcCol >> 24, rSrc = srcCol >> 16, gSrc = srcCol >> 8, bSrc = srcCol;
+	uint8 aDest = destCol >> 24, rDest = destCol >> 16, gDest = destCol >> 8, bDest = destCol;
+
+	switch (MODE) {
+	case kSourceAlphaBlender:
+		blendSourceAlpha(aSrc, rSrc, gSrc, bSrc, aDest, rDest, gDest, bDest, alpha);
+		break;
+	case kArgbToArgbBlender:
+		blendArgbToArgb(aSrc, rSrc, gSrc, bSrc, aDest, rDest, gDest, bDest, alpha);
+		break;
+	case kArgbToRgbBlender:
+		blendArgbToRgb(aSrc, rSrc, gSrc, bSrc, aDest, rDest, gDest, bDest, alpha);
+		break;
+	case kRgbToArgbBlender:
+		blendRgbToArgb(aSrc, rSrc, gSrc, bSrc, aDest, rDest, gDest, bDest, alpha);
+		break;
+	case kRgbToRgbBlender:
+		blendRgbToRgb(aSrc, rSrc, gSrc, bSrc, aDest, rDest, gDest, bDest, alpha);
+		break;
+	case kAlphaPreservedBlenderMode:
+		blendPreserveAlpha(aSrc, rSrc, gSrc, bSrc, aDest, rDest, gDest, bDest, alpha);
+		break;
+	case kOpaqueBlenderMode:
+		blendOpaque(aSrc, rSrc, gSrc, bSrc, aDest, rDest, gDest, bDest, alpha);
+		break;
+	case kAdditiveBlenderMode:
+		blendAdditiveAlpha(aSrc, rSrc, gSrc, bSrc, aDest, rDest, gDest, bDest, alpha);
+		break;
+	case kTintBlenderMode:
+		blendTintSprite(aSrc, rSrc, gSrc, bSrc, aDest, rDest, gDest, bDest, alpha, false);
+		break;
+	case kTintLightBlenderMode:
+		blendTintSprite(aSrc, rSrc, gSrc, bSrc, aDest, rDest, gDest, bDest, alpha, true);
+		break;
+	default:
+		break;
+	}
+
+	return ((uint32)aDest << 24) | ((uint32)rDest << 16) | ((uint32)gDest << 8) | bDest;
+}
+
 /*-------------------------------------------------------------------*/
 
 /**
@@ -132,6 +132,15 @@ public:
 
 	void blendPixel(uint8 aSrc, uint8 rSrc, uint8 gSrc, uint8 bSrc, uint8 &aDest, uint8 &rDest, uint8 &gDest, uint8 &bDest, uint32 alpha) const;
 
+	// Row kernels used by draw and stretchDraw between ARGB8888 bitmaps.
+	// They give the same results as blendPixel, but select the blender
+	// once per row and use SIMD where available.
+	bool canUseRowKernels(const BITMAP *srcBitmap) const;
+	void drawRow32(const uint32 *src, uint32 *dest, int count, bool skipTrans, int srcAlpha) const;
+	template<int MODE>
+	void blendRow32(const uint32 *src, uint32 *dest, int count, bool skipTrans, uint32 alpha) const;
+	template<int MODE>
+	uint32 blendPixel32(uint32 srcCol, uint32 destCol, uint32 alpha) const;
 
 	inline void rgbBlend(uint8 rSrc, uint8 gSrc, uint8 bSrc, uint8 &rDest, uint8 &gDest, uint8 &bDest, uint32 alpha) const {
 		// Note: the original's handling varies slightly for R & B vs G.
@@ -37,6 +37,9 @@ using queue = Common::Queue<T>;
  * FIXME: The current implementation requires the reverse
  * greater/lesser comparitor than the original does.
  * If this is fixed, also change the router finder's use
+ *
+ * The items are kept in a binary heap, with the item which
+ * comes first by the comparitor at the top
  */
 template<class T, class Container = vector<T>, class Comparitor = typename Common::Less<T> >
 class priority_queue {
@@ -50,17 +53,54 @@ public:
 		return _container.empty();
 	}
 
+	size_t size() const {
+		return _container.size();
+	}
+
 	const T &top() const {
 		return _container.front();
 	}
 
-	void push(const T &item) {
+	void push(const T &value) {
+		const T item = value;
+		size_t pos = _container.size();
 		_container.push_back(item);
-		Common::sort(_container.begin(), _container.end(), _comparitor);
+		while (pos > 0) {
+			size_t parent = (pos - 1) / 2;
+			if (!_comparitor(item, _container[parent]))
+				break;
+			_container[pos] = _container[parent];
+			pos = parent;
+		}
+		_container[pos] = item;
 	}
 
 	void pop() {
-		_container.remove_at(0);
+		const size_t count = _container.size() - 1;
+		if (count == 0) {
+			_container.pop_back();
+			return;
+		}
+
+		T item = _container[count];
+		_container.pop_back();
+		size_t pos = 0;
+		for (;;) {
+			size_t child = pos * 2 + 1;
+			if (child >= count)
+				break;
+			if (child + 1 < count && _comparitor(_container[child + 1], _container[child]))
+				child++;
+			if (!_comparitor(_container[child], item))
+				break;
+			_container[pos] = _container[child];
+			pos = child;
+		}
+		_container[pos] = item;
+	}
+
+	void clear() {
+		_container.clear();
 	}
 };
 
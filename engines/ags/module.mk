@@ -39,6 +39,7 @@ MODULE_OBJS = \
 	shared/ac/keycode.o \
 	shared/ac/mouse_cursor.o \
 	shared/ac/sprite_cache.o \
+	shared/ac/sprite_cache_policy.o \
 	shared/ac/view.o \
 	shared/ac/words_dictionary.o \
 	shared/core/asset.o \
@@ -368,7 +369,10 @@ MODULE_OBJS += \
 	tests/test_inifile.o \
 	tests/test_math.o \
 	tests/test_memory.o \
+	tests/test_route_finder.o \
+	tests/test_script_vm.o \
 	tests/test_sprintf.o \
+	tests/test_sprite_cache.o \
 	tests/test_string.o \
 	tests/test_version.o
 endif
@@ -54,9 +54,6 @@ extern void initialize_sprite(int);
 extern void pre_save_sprite(Bitmap *image);
 extern void get_new_size_for_sprite(int, int, int, int &, int &);
 
-#define START_OF_LIST -1
-#define END_OF_LIST   -1
-
 const char *spindexid = "SPRINDEX";
 
 // TODO: should not be part of SpriteCache, but rather some asset management class?
@@ -87,7 +84,9 @@ SpriteFile::SpriteFile() {
 }
 
 SpriteCache::SpriteCache(std::vector<SpriteInfo> &sprInfos)
-	: _sprInfos(sprInfos) {
+	: _sprInfos(sprInfos)
+	, _policy(CreateSpriteCachePolicy(kSprCachePolicy_LRU))
+	, _traceEnabled(false) {
 	Init();
 }
 
@@ -123,12 +122,45 @@ void SpriteCache::SetMaxCacheSize(size_t size) {
 	_maxCacheSize = size;
 }
 
+const SpriteCacheStats &SpriteCache::GetStats() const {
+	return _stats;
+}
+
+void SpriteCache::ResetStats() {
+	_stats = SpriteCacheStats();
+}
+
+void SpriteCache::SetPolicy(SpriteCachePolicyType type) {
+	_policy.reset(CreateSpriteCachePolicy(type));
+	// Give the cached sprites to the new policy, as if they were not used yet
+	for (size_t i = 0; i < _spriteData.size(); ++i) {
+		if (_spriteData[i].Image && _spriteData[i].IsAssetSprite() && !_spriteData[i].IsLocked())
+			_policy->Add(i, _spriteData[i].Size, false);
+	}
+}
+
+const char *SpriteCache::GetPolicyName() const {
+	return _policy->GetName();
+}
+
+void SpriteCache::SetTraceRecording(bool enable) {
+	if (enable && !_traceEnabled)
+		_trace.clear();
+	_traceEnabled = enable;
+}
+
+const std::vector<SpriteAccess> &SpriteCache::GetTrace() const {
+	return _trace;
+}
+
 void SpriteCache::Init() {
 	_cacheSize = 0;
 	_lockedSize = 0;
 	_maxCacheSize = (size_t)DEFAULTCACHESIZE_KB * 1024;
-	_liststart = -1;
-	_listend = -1;
+	_policy->Clear();
+	_prefetchQueue.clear();
+	_prefetchPos = 0;
+	ResetStats();
 }
 
 void SpriteCache::Reset() {
@@ -142,9 +174,6 @@ void SpriteCache::Reset() {
 	}
 	_spriteData.clear();
 
-	_mrulist.clear();
-	_mrubacklink.clear();
-
 	Init();
 }
 
@@ -187,6 +216,7 @@ void SpriteCache::SubstituteBitmap(sprkey_t index, Bitmap *sprite) {
 }
 
 void SpriteCache::RemoveSprite(sprkey_t index, bool freeMemory) {
+	_policy->Remove(index);
 	if (freeMemory)
 		delete _spriteData[index].Image;
 	InitNullSpriteParams(index);
@@ -204,8 +234,6 @@ sprkey_t SpriteCache::EnlargeTo(sprkey_t topmost) {
 	size_t newsize = topmost + 1;
 	_sprInfos.resize(newsize);
 	_spriteData.resize(newsize);
-	_mrulist.resize(newsize);
-	_mrubacklink.resize(newsize);
 	return topmost;
 }
 
@@ -255,105 +283,147 @@ Bitmap *SpriteCache::operator [] (sprkey_t index) {
 		return _spriteData[index].Image;
 
 	// Sprite exists in file but is not in mem, load it
-	if ((_spriteData[index].Image == nullptr) && _spriteData[index].IsAssetSprite())
+	bool missed = false;
+	if ((_spriteData[index].Image == nullptr) && _spriteData[index].IsAssetSprite()) {
+		uint32_t start = g_system->getMillis();
 		LoadSprite(index);
+		uint32_t stall = g_system->getMillis() - start;
+		_stats.Misses++;
+		_stats.StallTime += stall;
+		_stats.MaxStall = std::max(_stats.MaxStall, stall);
+		_stats.BytesLoaded += _spriteData[index].Size;
+		if (_spriteData[index].Flags & SPRCACHEFLAG_DISPOSED)
+			_stats.BytesReloaded += _spriteData[index].Size;
+		missed = true;
+	}
 
-	// Locked sprite that shouldn't be put into MRU list
+	// Locked sprite that shouldn't be given to the cache policy
 	if (_spriteData[index].IsLocked())
 		return _spriteData[index].Image;
 
-	if (_liststart < 0) {
-		_liststart = index;
-		_listend = index;
-		_mrulist[index] = END_OF_LIST;
-		_mrubacklink[index] = START_OF_LIST;
-	} else if (_listend != index) {
-		// this is the oldest element being bumped to newest, so update start link
-		if (index == _liststart) {
-			_liststart = _mrulist[index];
-			_mrubacklink[_liststart] = START_OF_LIST;
-		}
-		// already in list, link previous to next
-		else if (_mrulist[index] > 0) {
-			_mrulist[_mrubacklink[index]] = _mrulist[index];
-			_mrubacklink[_mrulist[index]] = _mrubacklink[index];
+	if (!missed && _spriteData[index].IsAssetSprite()) {
+		_stats.Hits++;
+		if (_spriteData[index].Flags & SPRCACHEFLAG_PREFETCHED) {
+			_stats.PrefetchHits++;
+			_spriteData[index].Flags &= ~SPRCACHEFLAG_PREFETCHED;
 		}
+	}
 
-		// set this as the newest element in the list
-		_mrulist[index] = END_OF_LIST;
-		_mrulist[_listend] = index;
-		_mrubacklink[index] = _listend;
-		_listend = index;
+	if (_traceEnabled && _trace.size() < MAX_TRACE_LENGTH && _spriteData[index].IsAssetSprite()) {
+		SpriteAccess access;
+		access.Index = index;
+		access.Size = _spriteData[index].Size;
+		_trace.push_back(access);
 	}
 
+	if (_policy->Contains(index))
+		_policy->Touch(index);
+	else
+		_policy->Add(index, _spriteData[index].Size, true);
+
 	return _spriteData[index].Image;
 }
 
-void SpriteCache::DisposeOldest() {
-	if (_liststart < 0)
-		return;
-
-	sprkey_t sprnum = _liststart;
+bool SpriteCache::DisposeNext() {
+	sprkey_t sprnum = _policy->PopVictim();
+	if (sprnum < 0)
+		return false;
 
 	if ((_spriteData[sprnum].Image != nullptr) && !_spriteData[sprnum].IsLocked()) {
 		// Free the memory
-		// Sprites that are not from the game resources should not normally be in a MRU list;
+		// Sprites that are not from the game resources should not normally be given to the policy;
 		// if such is met here there's something wrong with the internal cache logic!
 		if (!_spriteData[sprnum].IsAssetSprite()) {
-			quitprintf("SpriteCache::DisposeOldest: attempted to remove sprite %d that was added externally or does not exist", sprnum);
+			quitprintf("SpriteCache::DisposeNext: attempted to remove sprite %d that was added externally or does not exist", sprnum);
 		}
 		_cacheSize -= _spriteData[sprnum].Size;
 
 		delete _spriteData[sprnum].Image;
 		_spriteData[sprnum].Image = nullptr;
-	}
-
-	if (_liststart == _listend) {
-		// there was one huge sprite, removing it has now emptied the cache completely
-		if (_cacheSize > 0) {
-			Debug::Printf(kDbgGroup_SprCache, kDbgMsg_Error, "SPRITE CACHE ERROR: Sprite cache should be empty, but still has %d bytes", _cacheSize);
-		}
-		_mrulist[_liststart] = 0;
-		_liststart = -1;
-		_listend = -1;
-	} else {
-		sprkey_t oldstart = _liststart;
-		_liststart = _mrulist[_liststart];
-		_mrulist[oldstart] = 0;
-		_mrubacklink[_liststart] = START_OF_LIST;
-		if (oldstart == _liststart) {
-			// Somehow, we have got a recursive link to itself, so we
-			// the game will freeze (since it is not actually freeing any
-			// memory)
-			// There must be a bug somewhere causing this, but for now
-			// let's just reset the cache
-			Debug::Printf(kDbgGroup_SprCache, kDbgMsg_Error, "RUNTIME CACHE ERROR: CACHE INCONSISTENT: RESETTING\n\tAt size %d (of %d), start %d end %d  fwdlink=%d",
-				_cacheSize, _maxCacheSize, oldstart, _listend, _liststart);
-			DisposeAll();
+		_spriteData[sprnum].Flags |= SPRCACHEFLAG_DISPOSED;
+		_stats.Disposed++;
+		if (_spriteData[sprnum].Flags & SPRCACHEFLAG_PREFETCHED) {
+			_stats.PrefetchWasted++;
+			_spriteData[sprnum].Flags &= ~SPRCACHEFLAG_PREFETCHED;
 		}
 	}
 
 #ifdef DEBUG_SPRITECACHE
-	Debug::Printf(kDbgGroup_SprCache, kDbgMsg_Debug, "DisposeOldest: disposed %d, size now %d KB", sprnum, _cacheSize / 1024);
+	Debug::Printf(kDbgGroup_SprCache, kDbgMsg_Debug, "DisposeNext: disposed %d, size now %d KB", sprnum, _cacheSize / 1024);
 #endif
+	return true;
 }
 
 void SpriteCache::DisposeAll() {
-	_liststart = -1;
-	_listend = -1;
+	_policy->Clear();
 	for (size_t i = 0; i < _spriteData.size(); ++i) {
 		if (!_spriteData[i].IsLocked() && // not locked
 			_spriteData[i].IsAssetSprite()) // sprite from game resource
 		{
 			delete _spriteData[i].Image;
 			_spriteData[i].Image = nullptr;
+			_spriteData[i].Flags &= ~SPRCACHEFLAG_PREFETCHED;
 		}
-		_mrulist[i] = 0;
-		_mrubacklink[i] = 0;
 	}
 	_cacheSize = _lockedSize;
 }
 
+void SpriteCache::PrefetchSprite(sprkey_t index) {
+	if (index < MIN_SPRITE_INDEX || (size_t)index >= _spriteData.size())
+		return;
+	SpriteData &data = _spriteData[index];
+	if (data.Image || !data.IsAssetSprite() || (data.Flags & SPRCACHEFLAG_PREFETCHQUEUED))
+		return;
+	data.Flags |= SPRCACHEFLAG_PREFETCHQUEUED;
+	_prefetchQueue.push_back(index);
+}
+
+void SpriteCache::ClearPrefetch() {
+	for (size_t i = _prefetchPos; i < _prefetchQueue.size(); ++i) {
+		if ((size_t)_prefetchQueue[i] < _spriteData.size())
+			_spriteData[_prefetchQueue[i]].Flags &= ~SPRCACHEFLAG_PREFETCHQUEUED;
+	}
+	_prefetchQueue.clear();
+	_prefetchPos = 0;
+}
+
+size_t SpriteCache::GetPrefetchQueueSize() const {
+	return _prefetchQueue.size() - _prefetchPos;
+}
+
+bool SpriteCache::ProcessPrefetch(uint32_t deadline) {
+	bool loaded = false;
+	while (_prefetchPos < _prefetchQueue.size() &&
+		static_cast<int32_t>(deadline - g_system->getMillis()) > 0) {
+		// The cache is full: the rest would have to replace sprites in use
+		if (_cacheSize >= _maxCacheSize) {
+			ClearPrefetch();
+			break;
+		}
+
+		sprkey_t index = _prefetchQueue[_prefetchPos++];
+		if ((size_t)index >= _spriteData.size())
+			continue;
+		_spriteData[index].Flags &= ~SPRCACHEFLAG_PREFETCHQUEUED;
+		// Already loaded on demand, or removed since it was queued
+		if (_spriteData[index].Image || !_spriteData[index].IsAssetSprite())
+			continue;
+
+		LoadSprite(index);
+		if (!_spriteData[index].Image)
+			continue; // failed and remapped
+		// The sprite was not used yet, so it goes first if space is needed
+		_policy->Add(index, _spriteData[index].Size, false);
+		_spriteData[index].Flags |= SPRCACHEFLAG_PREFETCHED;
+		_stats.Prefetched++;
+		loaded = true;
+	}
+
+	if (_prefetchPos == _prefetchQueue.size())
+		ClearPrefetch();
+	return loaded;
+}
+
 void SpriteCache::Precache(sprkey_t index) {
 	if (index < 0 || (size_t)index >= _spriteData.size())
 		return;
@@ -367,6 +437,7 @@ void SpriteCache::Precache(sprkey_t index) {
 
 	// make sure locked sprites can't fill the cache
 	_maxCacheSize += sprSize;
+	_policy->Remove(index);
 	_lockedSize += sprSize;
 
 	_spriteData[index].Flags |= SPRCACHEFLAG_LOCKED;
@@ -392,7 +463,7 @@ size_t SpriteCache::LoadSprite(sprkey_t index) {
 	int hh = 0;
 
 	while (_cacheSize > _maxCacheSize) {
-		DisposeOldest();
+		DisposeNext();
 		hh++;
 		if (hh > 1000) {
 			Debug::Printf(kDbgGroup_SprCache, kDbgMsg_Error, "RUNTIME CACHE ERROR: STUCK IN FREE_UP_MEM; RESETTING CACHE");
@@ -618,8 +689,6 @@ HError SpriteCache::InitFile(const String &filename, const String &sprindex_file
 	size_t newsize = metrics.size();
 	_sprInfos.resize(newsize);
 	_spriteData.resize(newsize);
-	_mrulist.resize(newsize);
-	_mrubacklink.resize(newsize);
 	for (size_t i = 0; i < metrics.size(); ++i) {
 		if (!metrics[i].IsNull()) {
 			// Existing sprite
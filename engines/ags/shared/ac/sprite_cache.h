@@ -25,7 +25,7 @@
 //
 // SpriteFile handles sprite serialization and streaming.
 // SpriteCache provides bitmaps by demand; it uses SpriteFile to load sprites
-// and does MRU (most-recent-use) caching.
+// and does MRU (most-recent-use) caching by default, see SpriteCachePolicy.
 //
 // TODO: store sprite data in a specialized container type that is optimized
 // for having most keys allocated in large continious sequences by default.
@@ -44,6 +44,7 @@
 
 #include "ags/lib/std/memory.h"
 #include "ags/lib/std/vector.h"
+#include "ags/shared/ac/sprite_cache_policy.h"
 #include "ags/shared/core/platform.h"
 #include "ags/shared/util/error.h"
 #include "ags/shared/util/geometry.h"
@@ -69,6 +70,12 @@ struct SpriteInfo;
 #define SPRCACHEFLAG_REMAPPED       0x02
 // Locked sprites are ones that should not be freed when out of cache space.
 #define SPRCACHEFLAG_LOCKED         0x04
+// Tells that the sprite is waiting in the prefetch queue.
+#define SPRCACHEFLAG_PREFETCHQUEUED 0x08
+// Tells that the sprite was loaded by prefetching and was not used since.
+#define SPRCACHEFLAG_PREFETCHED     0x10
+// Tells that the sprite was disposed to make space at least once.
+#define SPRCACHEFLAG_DISPOSED       0x20
 
 // Max size of the sprite cache, in bytes
 #if AGS_PLATFORM_OS_ANDROID || AGS_PLATFORM_OS_IOS
@@ -96,8 +103,6 @@ enum SpriteIndexFileVersion {
 };
 
 
-typedef int32_t sprkey_t;
-
 // SpriteFileIndex contains sprite file's table of contents
 struct SpriteFileIndex {
 	int SpriteFileIDCheck = 0; // tag matching sprite file and index file
@@ -163,6 +168,20 @@ private:
 	sprkey_t _curPos; // current stream position (sprite slot)
 };
 
+// Sprite cache statistics, for the debugger
+struct SpriteCacheStats {
+	uint32_t Hits = 0;           // requested sprite was already loaded
+	uint32_t Misses = 0;         // requested sprite had to be loaded right away
+	uint32_t StallTime = 0;      // total time spent on loading missed sprites, in ms
+	uint32_t MaxStall = 0;       // longest load of a single missed sprite, in ms
+	uint32_t Prefetched = 0;     // sprites loaded in advance
+	uint32_t PrefetchHits = 0;   // prefetched sprites which were used afterwards
+	uint32_t PrefetchWasted = 0; // prefetched sprites disposed without being used
+	uint32_t Disposed = 0;       // sprites disposed to make space
+	uint64 BytesLoaded = 0;    // size of the missed sprites
+	uint64 BytesReloaded = 0;  // size of the missed sprites which were disposed before
+};
+
 class SpriteCache {
 public:
 	static const sprkey_t MIN_SPRITE_INDEX = 1; // 0 is reserved for "empty sprite"
@@ -220,6 +239,28 @@ public:
 	// Sets max cache size in bytes
 	void        SetMaxCacheSize(size_t size);
 
+	// Queues sprite to be loaded in advance, when there is spare time
+	void        PrefetchSprite(sprkey_t index);
+	// Drops all the sprites waiting in the prefetch queue
+	void        ClearPrefetch();
+	// Tells the number of sprites waiting in the prefetch queue
+	size_t      GetPrefetchQueueSize() const;
+	// Loads queued sprites until the given time (as by g_system->getMillis)
+	// is reached or the cache is full; returns if any sprite was loaded.
+	// Prefetching never disposes other sprites to make space.
+	bool        ProcessPrefetch(uint32_t deadline);
+	// Gets the hit, miss and prefetch counters
+	const SpriteCacheStats &GetStats() const;
+	void        ResetStats();
+
+	// Selects the policy that decides which sprites get disposed first
+	void        SetPolicy(SpriteCachePolicyType type);
+	const char *GetPolicyName() const;
+	// Starts or stops recording the sprite requests, for replaying them
+	// with the different policies; starting discards the previous record
+	void        SetTraceRecording(bool enable);
+	const std::vector<SpriteAccess> &GetTrace() const;
+
 	// Loads (if it's not in cache yet) and returns bitmap by the sprite index
 	Shared::Bitmap *operator[] (sprkey_t index);
 
@@ -230,8 +271,9 @@ private:
 	// Gets the index of a sprite which data is used for the given slot;
 	// in case of remapped sprite this will return the one given sprite is remapped to
 	sprkey_t    GetDataIndex(sprkey_t index);
-	// Delete the oldest image in cache
-	void        DisposeOldest();
+	// Delete the image chosen by the cache policy; returns false if the
+	// policy has no sprites left
+	bool        DisposeNext();
 
 	// Information required for the sprite streaming
 	// TODO: split into sprite cache and sprite stream data
@@ -266,13 +308,20 @@ private:
 	size_t _lockedSize;    // size in bytes of currently locked images
 	size_t _cacheSize;     // size in bytes of currently cached images
 
-	// MRU list: the way to track which sprites were used recently.
-	// When clearing up space for new sprites, cache first deletes the sprites
-	// that were last time used long ago.
-	std::vector<sprkey_t> _mrulist;
-	std::vector<sprkey_t> _mrubacklink;
-	int _liststart;
-	int _listend;
+	// Tracks the loaded sprites which may be disposed, and decides which
+	// of them to delete first when clearing up space for new sprites.
+	std::unique_ptr<SpriteCachePolicy> _policy;
+
+	// Recorded sprite requests
+	static const size_t MAX_TRACE_LENGTH = 1 << 22;
+	std::vector<SpriteAccess> _trace;
+	bool _traceEnabled;
+
+	// Sprites to load in advance, in the order of their expected use
+	std::vector<sprkey_t> _prefetchQueue;
+	size_t _prefetchPos;
+
+	SpriteCacheStats _stats;
 
 	// Initialize the empty sprite slot
 	void        InitNullSpriteParams(sprkey_t index);
@@ -0,0 +1,319 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#include "ags/shared/ac/sprite_cache_policy.h"
+#include "ags/lib/std/algorithm.h"
+#include "common/str.h"
+
+namespace AGS3 {
+
+namespace {
+
+const sprkey_t END_OF_LIST = -1;
+const sprkey_t NOT_LISTED = -2;
+
+// Least recently used sprites go first
+class LRUSpriteCachePolicy : public SpriteCachePolicy {
+public:
+	LRUSpriteCachePolicy() : _oldest(END_OF_LIST), _newest(END_OF_LIST) {
+	}
+
+	const char *GetName() const override {
+		return "lru";
+	}
+
+	void Add(sprkey_t index, size_t size, bool used) override {
+		if (Contains(index))
+			Unlink(index);
+		else if ((size_t)index >= _prev.size()) {
+			_prev.resize(index + 1, NOT_LISTED);
+			_next.resize(index + 1, NOT_LISTED);
+		}
+
+		if (used)
+			LinkNewest(index);
+		else
+			LinkOldest(index);
+	}
+
+	void Touch(sprkey_t index) override {
+		if (!Contains(index) || index == _newest)
+			return;
+		Unlink(index);
+		LinkNewest(index);
+	}
+
+	void Remove(sprkey_t index) override {
+		if (Contains(index)) {
+			Unlink(index);
+			_prev[index] = _next[index] = NOT_LISTED;
+		}
+	}
+
+	bool Contains(sprkey_t index) const override {
+		return index >= 0 && (size_t)index < _prev.size() && _prev[index] != NOT_LISTED;
+	}
+
+	sprkey_t PopVictim() override {
+		sprkey_t victim = _oldest;
+		if (victim != END_OF_LIST)
+			Remove(victim);
+		return victim;
+	}
+
+	void Clear() override {
+		_prev.clear();
+		_next.clear();
+		_oldest = _newest = END_OF_LIST;
+	}
+
+private:
+	void LinkNewest(sprkey_t index) {
+		_prev[index] = _newest;
+		_next[index] = END_OF_LIST;
+		if (_newest != END_OF_LIST)
+			_next[_newest] = index;
+		else
+			_oldest = index;
+		_newest = index;
+	}
+
+	void LinkOldest(sprkey_t index) {
+		_prev[index] = END_OF_LIST;
+		_next[index] = _oldest;
+		if (_oldest != END_OF_LIST)
+			_prev[_oldest] = index;
+		else
+			_newest = index;
+		_oldest = index;
+	}
+
+	void Unlink(sprkey_t index) {
+		if (_prev[index] != END_OF_LIST)
+			_next[_prev[index]] = _next[index];
+		else
+			_oldest = _next[index];
+		if (_next[index] != END_OF_LIST)
+			_prev[_next[index]] = _prev[index];
+		else
+			_newest = _prev[index];
+	}
+
+	// Links of the list, from the oldest to the newest sprite
+	std::vector<sprkey_t> _prev;
+	std::vector<sprkey_t> _next;
+	sprkey_t _oldest;
+	sprkey_t _newest;
+};
+
+// Greedy-Dual-Size-Frequency: every sprite gets a priority of
+// L + uses / size, and the sprite with the lowest priority goes first.
+// L is raised to the priority of each disposed sprite, which ages the
+// sprites that are not used anymore.
+class GDSFSpriteCachePolicy : public SpriteCachePolicy {
+public:
+	GDSFSpriteCachePolicy() : _inflation(0.0) {
+	}
+
+	const char *GetName() const override {
+		return "gdsf";
+	}
+
+	void Add(sprkey_t index, size_t size, bool used) override {
+		if ((size_t)index >= _entries.size())
+			_entries.resize(index + 1);
+
+		Entry &entry = _entries[index];
+		entry.Uses = used ? 1 : 0;
+		entry.Size = (uint32_t)std::max<size_t>(size, 1);
+		entry.Priority = _inflation + (double)entry.Uses * COST_SCALE / entry.Size;
+		if (entry.HeapPos < 0) {
+			entry.HeapPos = _heap.size();
+			_heap.push_back(index);
+		}
+		SiftUp(entry.HeapPos);
+		SiftDown(entry.HeapPos);
+	}
+
+	void Touch(sprkey_t index) override {
+		if (!Contains(index))
+			return;
+		Entry &entry = _entries[index];
+		if (entry.Uses < MAX_USES)
+			entry.Uses++;
+		entry.Priority = _inflation + (double)entry.Uses * COST_SCALE / entry.Size;
+		// The priority can only grow
+		SiftDown(entry.HeapPos);
+	}
+
+	void Remove(sprkey_t index) override {
+		if (!Contains(index))
+			return;
+		int pos = _entries[index].HeapPos;
+		_entries[index].HeapPos = -1;
+		sprkey_t last = _heap.back();
+		_heap.pop_back();
+		if (last != index) {
+			_heap[pos] = last;
+			_entries[last].HeapPos = pos;
+			SiftUp(pos);
+			SiftDown(_entries[last].HeapPos);
+		}
+	}
+
+	bool Contains(sprkey_t index) const override {
+		return index >= 0 && (size_t)index < _entries.size() && _entries[index].HeapPos >= 0;
+	}
+
+	sprkey_t PopVictim() override {
+		if (_heap.empty())
+			return -1;
+		sprkey_t victim = _heap[0];
+		_inflation = _entries[victim].Priority;
+		Remove(victim);
+		return victim;
+	}
+
+	void Clear() override {
+		_entries.clear();
+		_heap.clear();
+		_inflation = 0.0;
+	}
+
+private:
+	// Keeps the priorities of small sprites well above the rounding errors
+	static const uint32_t COST_SCALE = 0x10000;
+	// Counting more uses keeps the sprites of the previous room in the cache
+	// for a long time; in replays of room changes two uses worked best
+	static const uint32_t MAX_USES = 2;
+
+	struct Entry {
+		double Priority = 0.0;
+		uint32_t Uses = 0;
+		uint32_t Size = 1;
+		int HeapPos = -1;
+	};
+
+	bool Less(int a, int b) const {
+		return _entries[_heap[a]].Priority < _entries[_heap[b]].Priority;
+	}
+
+	void Swap(int a, int b) {
+		std::swap(_heap[a], _heap[b]);
+		_entries[_heap[a]].HeapPos = a;
+		_entries[_heap[b]].HeapPos = b;
+	}
+
+	void SiftUp(int pos) {
+		while (pos > 0 && Less(pos, (pos - 1) / 2)) {
+			Swap(pos, (pos - 1) / 2);
+			pos = (pos - 1) / 2;
+		}
+	}
+
+	void SiftDown(int pos) {
+		const int count = _heap.size();
+		for (;;) {
+			int least = pos;
+			if (pos * 2 + 1 < count && Less(pos * 2 + 1, least))
+				least = pos * 2 + 1;
+			if (pos * 2 + 2 < count && Less(pos * 2 + 2, least))
+				least = pos * 2 + 2;
+			if (least == pos)
+				break;
+			Swap(pos, least);
+			pos = least;
+		}
+	}
+
+	std::vector<Entry> _entries;
+	// Binary min-heap of the sprites, by priority
+	std::vector<sprkey_t> _heap;
+	double _inflation;
+};
+
+const char *const PolicyNames[kNumSprCachePolicies] = { "lru", "gdsf" };
+
+} // namespace
+
+SpriteCachePolicy *CreateSpriteCachePolicy(SpriteCachePolicyType type) {
+	switch (type) {
+	case kSprCachePolicy_GDSF:
+		return new GDSFSpriteCachePolicy();
+	default:
+		return new LRUSpriteCachePolicy();
+	}
+}
+
+SpriteCachePolicyType FindSpriteCachePolicy(const char *name) {
+	for (int i = 0; i < kNumSprCachePolicies; ++i) {
+		if (scumm_stricmp(name, PolicyNames[i]) == 0)
+			return (SpriteCachePolicyType)i;
+	}
+	return kNumSprCachePolicies;
+}
+
+SpriteReplayStats ReplaySpriteTrace(SpriteCachePolicy &policy,
+		const std::vector<SpriteAccess> &trace, size_t maxCacheSize) {
+	SpriteReplayStats stats;
+	std::vector<uint32_t> sizes; // sizes of the cached sprites
+	std::vector<bool> disposed;  // sprites that were disposed at least once
+	size_t cacheSize = 0;
+
+	policy.Clear();
+	for (const auto &access : trace) {
+		if (access.Index < 0)
+			continue;
+		if ((size_t)access.Index >= sizes.size()) {
+			sizes.resize(access.Index + 1, 0);
+			disposed.resize(access.Index + 1, false);
+		}
+
+		if (policy.Contains(access.Index)) {
+			stats.Hits++;
+			policy.Touch(access.Index);
+			continue;
+		}
+
+		// Same as SpriteCache::LoadSprite: make space first, then load
+		while (cacheSize > maxCacheSize) {
+			sprkey_t victim = policy.PopVictim();
+			if (victim < 0)
+				break;
+			cacheSize -= sizes[victim];
+			disposed[victim] = true;
+			stats.Disposed++;
+		}
+
+		stats.Misses++;
+		stats.BytesLoaded += access.Size;
+		if (disposed[access.Index])
+			stats.BytesReloaded += access.Size;
+		sizes[access.Index] = access.Size;
+		cacheSize += access.Size;
+		policy.Add(access.Index, access.Size, true);
+	}
+	policy.Clear();
+	return stats;
+}
+
+} // namespace AGS3
@@ -0,0 +1,103 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+//=============================================================================
+//
+// Eviction policies of the sprite cache.
+//
+// A policy tracks the sprites which the cache may dispose, and decides which
+// of them goes first when the cache runs out of space. Locked and external
+// sprites are never given to the policy.
+//
+// LRU disposes the sprite which was used longest ago; this is what the cache
+// always did. GDSF (Greedy-Dual-Size-Frequency) weighs how often a sprite was
+// used against its size, so that a large sprite used once does not push out
+// many small sprites that are used on every frame.
+//
+//=============================================================================
+
+#ifndef AGS_SHARED_AC_SPRITE_CACHE_POLICY_H
+#define AGS_SHARED_AC_SPRITE_CACHE_POLICY_H
+
+#include "ags/lib/std/vector.h"
+#include "ags/shared/core/types.h"
+
+namespace AGS3 {
+
+typedef int32_t sprkey_t;
+
+enum SpriteCachePolicyType {
+	kSprCachePolicy_LRU,
+	kSprCachePolicy_GDSF,
+	kNumSprCachePolicies
+};
+
+class SpriteCachePolicy {
+public:
+	virtual ~SpriteCachePolicy() {}
+
+	// Short name, as used in the config and the debugger
+	virtual const char *GetName() const = 0;
+	// Adds a sprite which was just loaded; unused sprites (e.g. prefetched
+	// ones) are ranked to be disposed before all the used ones
+	virtual void Add(sprkey_t index, size_t size, bool used) = 0;
+	// Registers the use of a sprite which was added before
+	virtual void Touch(sprkey_t index) = 0;
+	// Forgets a sprite, if it was added
+	virtual void Remove(sprkey_t index) = 0;
+	// Tells if the sprite was added
+	virtual bool Contains(sprkey_t index) const = 0;
+	// Forgets the sprite which should be disposed first and returns it,
+	// or returns -1 if there is no sprite left
+	virtual sprkey_t PopVictim() = 0;
+	// Forgets all sprites
+	virtual void Clear() = 0;
+};
+
+// Creates the policy of the given type
+SpriteCachePolicy *CreateSpriteCachePolicy(SpriteCachePolicyType type);
+// Finds the policy type by its name; returns kNumSprCachePolicies if unknown
+SpriteCachePolicyType FindSpriteCachePolicy(const char *name);
+
+// Single sprite request, for recording and replaying cache use
+struct SpriteAccess {
+	sprkey_t Index;
+	uint32_t Size; // size of the loaded sprite, in bytes
+};
+
+// Results of a trace replay
+struct SpriteReplayStats {
+	uint32_t Hits = 0;
+	uint32_t Misses = 0;
+	uint32_t Disposed = 0;
+	uint64 BytesLoaded = 0;
+	uint64 BytesReloaded = 0; // loads of the sprites that were disposed before
+};
+
+// Feeds recorded sprite requests through the policy, as if the sprite cache
+// had the given size limit, and counts what the cache would have done
+SpriteReplayStats ReplaySpriteTrace(SpriteCachePolicy &policy,
+	const std::vector<SpriteAccess> &trace, size_t maxCacheSize);
+
+} // namespace AGS3
+
+#endif
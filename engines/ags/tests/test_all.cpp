@@ -36,6 +36,20 @@ void Test_DoAllTests() {
 	Test_IniFile();
 
 	Test_Gfx();
+	Test_DrawKernels();
+
+	Test_SpriteCachePolicies();
+	Test_SpriteCacheReplay();
+
+	Test_RouteFinder();
+
+	Test_ScriptVM();
+}
+
+void Test_DoAllBenchmarks() {
+	Test_DrawBenchmark();
+	Test_RouteFinderBenchmark();
+	Test_ScriptVMBenchmark();
 }
 
 } // namespace AGS3
@@ -25,6 +25,8 @@
 namespace AGS3 {
 
 extern void Test_DoAllTests();
+// Only report timings, so these are kept out of Test_DoAllTests
+extern void Test_DoAllBenchmarks();
 
 // Math tests
 extern void Test_Math();
@@ -35,6 +37,20 @@ extern void Test_IniFile();
 
 // Graphics tests
 extern void Test_Gfx();
+extern void Test_DrawKernels();
+extern void Test_DrawBenchmark();
+
+// Route finder tests
+extern void Test_RouteFinder();
+extern void Test_RouteFinderBenchmark();
+
+// Script interpreter tests
+extern void Test_ScriptVM();
+extern void Test_ScriptVMBenchmark();
+
+// Sprite cache tests
+extern void Test_SpriteCachePolicies();
+extern void Test_SpriteCacheReplay();
 
 // Memory / bit-byte operations
 extern void Test_Memory();
@@ -24,11 +24,153 @@
 #include "ags/shared/core/platform.h"
 #include "ags/shared/gfx/gfx_def.h"
 #include "ags/shared/debugging/assert.h"
+#include "ags/lib/allegro/color.h"
+#include "ags/lib/allegro/surface.h"
+#include "ags/globals.h"
+#include "common/system.h"
 
 namespace AGS3 {
 
 namespace GfxDef = AGS::Shared::GfxDef;
 
+namespace {
+
+enum DrawKernels {
+	kGenericDraw,
+	kRowKernels,
+	kSimdRowKernels
+};
+
+const BlenderMode blenderModes[] = {
+	kSourceAlphaBlender, kArgbToArgbBlender, kArgbToRgbBlender, kRgbToArgbBlender,
+	kRgbToRgbBlender, kAlphaPreservedBlenderMode, kOpaqueBlenderMode,
+	kAdditiveBlenderMode, kTintBlenderMode, kTintLightBlenderMode
+};
+
+void setDrawKernels(DrawKernels kernels) {
+	_G(blender_row_kernels) = kernels != kGenericDraw;
+	_G(blender_simd) = kernels == kSimdRowKernels;
+}
+
+uint32 nextRandom(uint32 &seed) {
+	seed = seed * 1103515245 + 12345;
+	return seed >> 8;
+}
+
+// Fill a 32-bit bitmap with runs of transparent, invisible, opaque
+// and random pixels
+void fillBitmap(BITMAP *bmp, uint32 seed) {
+	for (int y = 0; y < bmp->h; ++y) {
+		for (int x = 0; x < bmp->w; ++x) {
+			uint32 color = nextRandom(seed) ^ (nextRandom(seed) << 16);
+			switch ((x / 8 + y) % 5) {
+			case 0:
+				color = (color & 0xFF000000) | 0xFF00FF;
+				break;
+			case 1:
+				color &= 0xFFFFFF;
+				break;
+			case 2:
+				color |= 0xFF000000;
+				break;
+			default:
+				break;
+			}
+			*(uint32 *)bmp->getBasePtr(x, y) = color;
+		}
+	}
+}
+
+void drawWithKernels(BITMAP *dest, BITMAP *src, DrawKernels kernels, BlenderMode mode, int alpha) {
+	static const int positions[][2] = { { 0, 0 }, { 13, 7 }, { -21, -3 }, { 90, 70 }, { -5, 60 } };
+
+	setDrawKernels(kernels);
+	set_blender_mode(mode, 0, 0, 0, 0);
+	for (int i = 0; i < ARRAYSIZE(positions); ++i) {
+		const int x = positions[i][0], y = positions[i][1];
+		for (int flip = 0; flip < 4; ++flip) {
+			dest->draw(src, Common::Rect(0, 0, src->w, src->h), x + flip, y,
+			           (flip & 1) != 0, (flip & 2) != 0, flip != 3, alpha);
+		}
+		dest->draw(src, Common::Rect(0, 0, src->w, src->h), x, y, false, false, true, alpha, 40, 200, 90);
+		dest->stretchDraw(src, Common::Rect(3, 2, 30, 25), Common::Rect(x, y, x + 61, y + 47), true, alpha);
+		dest->stretchDraw(src, Common::Rect(0, 0, src->w, src->h), Common::Rect(x, y, x + 11, y + 17), false, alpha);
+	}
+}
+
+} // namespace
+
+// Test that the row kernels of BITMAP::draw and stretchDraw give the
+// same results as the generic per-pixel code
+void Test_DrawKernels() {
+	static const int alphas[] = { -1, 0, 1, 100, 0xff };
+
+	BITMAP *src = create_bitmap_ex(32, 37, 29);
+	fillBitmap(src, 1);
+
+	for (int m = 0; m < ARRAYSIZE(blenderModes); ++m) {
+		for (int a = 0; a < ARRAYSIZE(alphas); ++a) {
+			// The light tint makes colors brighter than white above 250
+			if (blenderModes[m] == kTintLightBlenderMode && alphas[a] > 250)
+				continue;
+
+			BITMAP *dest[3];
+			for (int kernels = kGenericDraw; kernels <= kSimdRowKernels; ++kernels) {
+				dest[kernels] = create_bitmap_ex(32, 100, 80);
+				fillBitmap(dest[kernels], 2);
+				drawWithKernels(dest[kernels], src, (DrawKernels)kernels, blenderModes[m], alphas[a]);
+			}
+
+			for (int kernels = kRowKernels; kernels <= kSimdRowKernels; ++kernels) {
+				for (int y = 0; y < dest[kGenericDraw]->h; ++y)
+					assert(!memcmp(dest[kGenericDraw]->getBasePtr(0, y), dest[kernels]->getBasePtr(0, y), dest[kGenericDraw]->w * 4));
+			}
+
+			for (int kernels = kGenericDraw; kernels <= kSimdRowKernels; ++kernels)
+				destroy_bitmap(dest[kernels]);
+		}
+	}
+
+	destroy_bitmap(src);
+	setDrawKernels(kSimdRowKernels);
+	set_blender_mode(kRgbToRgbBlender, 0, 0, 0, 0);
+}
+
+// Time typical sprite drawing in every blender mode
+void Test_DrawBenchmark() {
+	const int iterations = 2000;
+
+	BITMAP *src = create_bitmap_ex(32, 128, 128);
+	BITMAP *dest = create_bitmap_ex(32, 1280, 720);
+	fillBitmap(src, 1);
+	fillBitmap(dest, 2);
+
+	for (int m = 0; m < ARRAYSIZE(blenderModes); ++m) {
+		uint32 times[3];
+		for (int kernels = kGenericDraw; kernels <= kSimdRowKernels; ++kernels) {
+			setDrawKernels((DrawKernels)kernels);
+			set_blender_mode(blenderModes[m], 0, 0, 0, 0);
+
+			const uint32 start = g_system->getMillis();
+			for (int i = 0; i < iterations; ++i) {
+				const int x = (i * 37) % 1200 - 20, y = (i * 23) % 640 - 20;
+				if (i % 4 == 3)
+					dest->stretchDraw(src, Common::Rect(0, 0, 128, 128), Common::Rect(x, y, x + 192, y + 160), true, 200);
+				else
+					dest->draw(src, Common::Rect(0, 0, 128, 128), x, y, (i % 4) == 1, false, true, 200);
+			}
+			times[kernels] = g_system->getMillis() - start;
+		}
+		debug("Blender mode %d, %d sprites of 128x128: generic %u ms, row kernels %u ms, SIMD %u ms",
+		      blenderModes[m], iterations, times[kGenericDraw], times[kRowKernels], times[kSimdRowKernels]);
+	}
+
+	destroy_bitmap(src);
+	destroy_bitmap(dest);
+	setDrawKernels(kSimdRowKernels);
+	set_blender_mode(kRgbToRgbBlender, 0, 0, 0, 0);
+}
+
 void Test_Gfx() {
 	// Test that every transparency which is a multiple of 10 is converted
 	// forth and back without loosing precision
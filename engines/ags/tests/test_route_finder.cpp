@@ -0,0 +1,281 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#include "ags/shared/core/platform.h"
+#include "ags/engine/ac/route_finder_jps.h"
+#include "ags/shared/debugging/assert.h"
+#include "common/system.h"
+#include "common/debug.h"
+
+namespace AGS3 {
+
+namespace {
+
+struct RoomMask {
+	int width = 0;
+	int height = 0;
+	std::vector<unsigned char> pixels;
+
+	void fillRect(int x0, int y0, int x1, int y1, unsigned char area) {
+		for (int y = MAX(y0, 0); y < MIN(y1, height); ++y)
+			for (int x = MAX(x0, 0); x < MIN(x1, width); ++x)
+				pixels[y * width + x] = area;
+	}
+
+	bool walkable(int x, int y) const {
+		return pixels[y * width + x] != 0;
+	}
+
+	void attach(Navigation &nav) const {
+		nav.Resize(width, height);
+		for (int y = 0; y < height; ++y)
+			nav.SetMapRow(y, &pixels[y * width]);
+	}
+};
+
+uint32_t nextRandom(uint32_t &seed) {
+	seed = seed * 1103515245 + 12345;
+	return seed >> 8;
+}
+
+// Walkable floor with furniture all over it, like in most rooms
+void buildFurnishedRoom(RoomMask &mask, int width, int height, uint32_t seed) {
+	mask.width = width;
+	mask.height = height;
+	mask.pixels.clear();
+	mask.pixels.resize(width * height, 0);
+	mask.fillRect(10, height / 4, width - 10, height - 10, 1);
+
+	for (int i = 0; i < 40; ++i) {
+		const int x = nextRandom(seed) % width;
+		const int y = height / 4 + nextRandom(seed) % (height * 3 / 4);
+		mask.fillRect(x, y, x + 8 + nextRandom(seed) % 40, y + 4 + nextRandom(seed) % 20, 0);
+	}
+}
+
+// Walls with narrow gaps, which make plain JPS explore most of the room
+void buildMazeRoom(RoomMask &mask, int width, int height, uint32_t seed) {
+	mask.width = width;
+	mask.height = height;
+	mask.pixels.clear();
+	mask.pixels.resize(width * height, 0);
+	mask.fillRect(2, 2, width - 2, height - 2, 2);
+
+	for (int x = 24; x < width - 8; x += 24) {
+		mask.fillRect(x, 2, x + 3, height - 2, 0);
+		for (int gap = 0; gap < 2; ++gap) {
+			const int y = 4 + nextRandom(seed) % (height - 16);
+			mask.fillRect(x, y, x + 3, y + 6, 2);
+		}
+	}
+	for (int y = 40; y < height - 8; y += 40) {
+		mask.fillRect(2, y, width - 2, y + 3, 0);
+		for (int gap = 0; gap < 6; ++gap) {
+			const int x = 4 + nextRandom(seed) % (width - 16);
+			mask.fillRect(x, y, x + 5, y + 3, 2);
+		}
+	}
+}
+
+void randomWalkable(const RoomMask &mask, uint32_t &seed, int &x, int &y) {
+	do {
+		x = nextRandom(seed) % mask.width;
+		y = nextRandom(seed) % mask.height;
+	} while (!mask.walkable(x, y));
+}
+
+float pathLength(const std::vector<int> &path) {
+	float length = 0.f;
+	for (int i = 1; i < (int)path.size(); ++i) {
+		int x0, y0, x1, y1;
+		Navigation::UnpackSquare(path[i - 1], x0, y0);
+		Navigation::UnpackSquare(path[i], x1, y1);
+		length += sqrt((float)((x1 - x0) * (x1 - x0) + (y1 - y0) * (y1 - y0)));
+	}
+	return length;
+}
+
+bool isClearPath(const Navigation &nav, const std::vector<int> &path) {
+	for (int i = 1; i < (int)path.size(); ++i) {
+		int x0, y0, x1, y1;
+		Navigation::UnpackSquare(path[i - 1], x0, y0);
+		Navigation::UnpackSquare(path[i], x1, y1);
+		if (nav.TraceLine(x0, y0, x1, y1))
+			return false;
+	}
+	return true;
+}
+
+void checkHierarchicalRoutes(const RoomMask &mask, uint32_t seed) {
+	Navigation flat, graph;
+	flat.SetRouteCacheSize(0);
+	graph.SetRouteCacheSize(0);
+	graph.SetHierarchical(true);
+	mask.attach(flat);
+	mask.attach(graph);
+
+	std::vector<int> opath, flatPath, graphPath;
+	for (int i = 0; i < 200; ++i) {
+		int sx, sy, ex, ey;
+		randomWalkable(mask, seed, sx, sy);
+		randomWalkable(mask, seed, ex, ey);
+
+		Navigation::NavResult flatResult = flat.NavigateRefined(sx, sy, ex, ey, opath, flatPath);
+		Navigation::NavResult graphResult = graph.NavigateCached(sx, sy, ex, ey, graphPath);
+		assert(graphResult == flatResult || (graphResult == Navigation::NAV_PATH && flatResult == Navigation::NAV_STRAIGHT));
+		if (flatResult == Navigation::NAV_UNREACHABLE)
+			continue;
+
+		// Same ends, no walls crossed, and not much longer
+		assert(graphPath.front() == flatPath.front() && graphPath.back() == flatPath.back());
+		assert(isClearPath(graph, graphPath));
+		assert(pathLength(graphPath) <= pathLength(flatPath) * 1.5f + 2.f);
+	}
+	assert(graph.GetStats().HierarchicalRoutes > 0);
+}
+
+} // namespace
+
+void Test_RouteFinder() {
+	RoomMask mask;
+	buildFurnishedRoom(mask, 320, 200, 1);
+
+	// The cached routes are the same as the searched ones
+	Navigation nav;
+	mask.attach(nav);
+	std::vector<int> opath, path, cachedPath;
+	uint32_t seed = 7;
+	for (int i = 0; i < 50; ++i) {
+		int sx, sy, ex, ey;
+		randomWalkable(mask, seed, sx, sy);
+		randomWalkable(mask, seed, ex, ey);
+
+		Navigation::NavResult result = nav.NavigateRefined(sx, sy, ex, ey, opath, path);
+		assert(nav.NavigateCached(sx, sy, ex, ey, cachedPath) == result);
+		assert(cachedPath == path);
+		const uint32_t hits = nav.GetStats().CacheHits;
+		assert(nav.NavigateCached(sx, sy, ex, ey, cachedPath) == result);
+		assert(cachedPath == path);
+		assert(nav.GetStats().CacheHits == hits + 1);
+	}
+
+	// A changed mask makes the cached route stale
+	int sx, sy, ex, ey;
+	randomWalkable(mask, seed, sx, sy);
+	randomWalkable(mask, seed, ex, ey);
+	nav.NavigateCached(sx, sy, ex, ey, path);
+	const uint32_t hits = nav.GetStats().CacheHits;
+	mask.fillRect((sx + ex) / 2 - 5, (sy + ey) / 2 - 5, (sx + ex) / 2 + 5, (sy + ey) / 2 + 5, 0);
+	nav.NavigateCached(sx, sy, ex, ey, path);
+	assert(nav.GetStats().CacheHits == hits);
+
+	// Routes over the cluster graph
+	checkHierarchicalRoutes(mask, 11);
+	RoomMask maze;
+	buildMazeRoom(maze, 320, 200, 3);
+	checkHierarchicalRoutes(maze, 13);
+
+	// The graph updated after a change is the same as a new one
+	Navigation updated, rebuilt;
+	updated.SetRouteCacheSize(0);
+	updated.SetHierarchical(true);
+	rebuilt.SetRouteCacheSize(0);
+	rebuilt.SetHierarchical(true);
+	maze.attach(updated);
+	updated.NavigateCached(5, 5, 300, 190, path);
+	maze.fillRect(100, 50, 140, 150, 0);
+	maze.fillRect(200, 10, 204, 190, 2);
+	maze.attach(rebuilt);
+	seed = 17;
+	for (int i = 0; i < 50; ++i) {
+		randomWalkable(maze, seed, sx, sy);
+		randomWalkable(maze, seed, ex, ey);
+		Navigation::NavResult result = updated.NavigateCached(sx, sy, ex, ey, path);
+		assert(rebuilt.NavigateCached(sx, sy, ex, ey, cachedPath) == result);
+		assert(cachedPath == path);
+	}
+	assert(updated.GetStats().GraphUpdates == 2);
+	assert(updated.GetStats().ClustersUpdated < rebuilt.GetStats().ClustersUpdated * 2);
+}
+
+void Test_RouteFinderBenchmark() {
+	const struct {
+		const char *name;
+		int width, height;
+		bool maze;
+	} rooms[] = {
+		{ "320x200 furnished", 320, 200, false },
+		{ "640x400 furnished", 640, 400, false },
+		{ "320x200 maze", 320, 200, true },
+		{ "640x400 maze", 640, 400, true }
+	};
+	const int queries = 500;
+
+	for (int r = 0; r < ARRAYSIZE(rooms); ++r) {
+		RoomMask mask;
+		if (rooms[r].maze)
+			buildMazeRoom(mask, rooms[r].width, rooms[r].height, 5);
+		else
+			buildFurnishedRoom(mask, rooms[r].width, rooms[r].height, 5);
+
+		uint32 randomTimes[2], spotTimes[2];
+		for (int mode = 0; mode < 4; ++mode) {
+			// Random routes with and without the cluster graph, then characters
+			// walking between a few spots with and without the route cache
+			const bool spots = mode >= 2;
+			Navigation nav;
+			nav.SetRouteCacheSize(mode == 3 ? 32 : 0);
+			nav.SetHierarchical(mode == 1);
+			mask.attach(nav);
+
+			int spot[5][2];
+			uint32_t seed = 9;
+			for (int i = 0; i < ARRAYSIZE(spot); ++i)
+				randomWalkable(mask, seed, spot[i][0], spot[i][1]);
+
+			std::vector<int> path;
+			const uint32 start = g_system->getMillis();
+			for (int i = 0; i < queries; ++i) {
+				int sx, sy, ex, ey;
+				if (spots) {
+					const int from = nextRandom(seed) % ARRAYSIZE(spot);
+					const int to = nextRandom(seed) % ARRAYSIZE(spot);
+					sx = spot[from][0];
+					sy = spot[from][1];
+					ex = spot[to][0];
+					ey = spot[to][1];
+				} else {
+					randomWalkable(mask, seed, sx, sy);
+					randomWalkable(mask, seed, ex, ey);
+				}
+				nav.NavigateCached(sx, sy, ex, ey, path);
+			}
+			(spots ? spotTimes : randomTimes)[mode % 2] = g_system->getMillis() - start;
+		}
+
+		debug("Route finder, %s, %d queries: random routes JPS %u ms, hierarchical %u ms; "
+			"between 5 spots JPS %u ms, cached %u ms", rooms[r].name, queries,
+			randomTimes[0], randomTimes[1], spotTimes[0], spotTimes[1]);
+	}
+}
+
+} // namespace AGS3
@@ -0,0 +1,255 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#include "ags/shared/core/platform.h"
+#include "ags/shared/script/cc_options.h"
+#include "ags/engine/script/cc_instance.h"
+#include "ags/engine/script/script_runtime.h"
+#include "ags/shared/debugging/assert.h"
+#include "common/system.h"
+#include "common/debug.h"
+
+namespace AGS3 {
+
+namespace {
+
+const char *const TestImportName = "ScriptVmTest_Combine";
+
+RuntimeScriptValue Sc_ScriptVmTest_Add(const RuntimeScriptValue *params, int32_t param_count) {
+	return RuntimeScriptValue().SetInt32(params[0].IValue + params[1].IValue);
+}
+
+RuntimeScriptValue Sc_ScriptVmTest_Sub(const RuntimeScriptValue *params, int32_t param_count) {
+	return RuntimeScriptValue().SetInt32(params[0].IValue - params[1].IValue);
+}
+
+// Writes byte-code the way the compiler does
+struct ScriptWriter {
+	std::vector<int32_t> code;
+	std::vector<int32_t> fixups;
+	std::vector<char> fixupTypes;
+
+	int pc() const {
+		return code.size();
+	}
+
+	void op(int32_t cmd) {
+		code.push_back(cmd);
+	}
+
+	void op(int32_t cmd, int32_t arg1) {
+		code.push_back(cmd);
+		code.push_back(arg1);
+	}
+
+	void op(int32_t cmd, int32_t arg1, int32_t arg2, char fixup2 = 0) {
+		code.push_back(cmd);
+		code.push_back(arg1);
+		code.push_back(arg2);
+		if (fixup2) {
+			fixups.push_back(pc() - 1);
+			fixupTypes.push_back(fixup2);
+		}
+	}
+
+	// Moves the code into the script
+	void write(ccScript &script) {
+		script.codesize = code.size();
+		script.code = (int32_t *)malloc(code.size() * sizeof(int32_t));
+		memcpy(script.code, &code[0], code.size() * sizeof(int32_t));
+		script.numfixups = fixups.size();
+		script.fixups = (int32_t *)malloc(fixups.size() * sizeof(int32_t));
+		memcpy(script.fixups, &fixups[0], fixups.size() * sizeof(int32_t));
+		script.fixuptypes = (char *)malloc(fixupTypes.size());
+		memcpy(script.fixuptypes, &fixupTypes[0], fixupTypes.size());
+	}
+};
+
+// Builds a script with a loop, which sums up values made with
+// arithmetics, a local function call and an imported function call:
+//
+//   int sum, strings_equal;
+//   int Bench() {
+//     strings_equal = "abc" == "abc";
+//     for (int i = 0; i < iterations; i++) {
+//       int t = i % 1000;
+//       sum = Combine(sum + square(t * t % 7), t);
+//     }
+//     return sum;
+//   }
+PScript buildScript(int32_t iterations) {
+	ScriptWriter w;
+	const int32_t sumAddr = 0, equalAddr = 4;
+
+	w.op(SCMD_LINENUM, 1);
+	w.op(SCMD_LITTOREG, SREG_AX, 0, FIXUP_STRING);
+	w.op(SCMD_LITTOREG, SREG_DX, 4, FIXUP_STRING);
+	w.op(SCMD_STRINGSEQUAL, SREG_AX, SREG_DX);
+	w.op(SCMD_LITTOREG, SREG_MAR, equalAddr, FIXUP_GLOBALDATA);
+	w.op(SCMD_MEMWRITE, SREG_AX);
+	w.op(SCMD_LITTOREG, SREG_CX, 0);
+
+	const int loop = w.pc();
+	w.op(SCMD_LINENUM, 2);
+	w.op(SCMD_REGTOREG, SREG_CX, SREG_DX);
+	w.op(SCMD_LITTOREG, SREG_AX, 1000);
+	w.op(SCMD_MODREG, SREG_DX, SREG_AX);
+	w.op(SCMD_PUSHREG, SREG_DX);
+	w.op(SCMD_MULREG, SREG_DX, SREG_DX);
+	w.op(SCMD_LITTOREG, SREG_AX, 7);
+	w.op(SCMD_MODREG, SREG_DX, SREG_AX);
+	const int squareCall = w.pc();
+	w.op(SCMD_LITTOREG, SREG_AX, 0, FIXUP_FUNCTION);
+	w.op(SCMD_CALL, SREG_AX);
+	w.op(SCMD_LITTOREG, SREG_MAR, sumAddr, FIXUP_GLOBALDATA);
+	w.op(SCMD_MEMREAD, SREG_BX);
+	w.op(SCMD_ADDREG, SREG_BX, SREG_DX);
+	w.op(SCMD_POPREG, SREG_DX);
+	w.op(SCMD_PUSHREAL, SREG_DX);
+	w.op(SCMD_PUSHREAL, SREG_BX);
+	w.op(SCMD_NUMFUNCARGS, 2);
+	w.op(SCMD_LITTOREG, SREG_AX, 0, FIXUP_IMPORT);
+	w.op(SCMD_CALLEXT, SREG_AX);
+	w.op(SCMD_SUBREALSTACK, 2);
+	w.op(SCMD_LITTOREG, SREG_MAR, sumAddr, FIXUP_GLOBALDATA);
+	w.op(SCMD_MEMWRITE, SREG_AX);
+	w.op(SCMD_ADD, SREG_CX, 1);
+	w.op(SCMD_REGTOREG, SREG_CX, SREG_AX);
+	w.op(SCMD_LITTOREG, SREG_DX, iterations);
+	w.op(SCMD_LESSTHAN, SREG_AX, SREG_DX);
+	w.op(SCMD_JNZ, loop - (w.pc() + 2));
+	w.op(SCMD_LITTOREG, SREG_MAR, sumAddr, FIXUP_GLOBALDATA);
+	w.op(SCMD_MEMREAD, SREG_AX);
+	w.op(SCMD_RET);
+
+	// int square(int) takes and returns the value in DX
+	w.code[squareCall + 2] = w.pc();
+	w.op(SCMD_MULREG, SREG_DX, SREG_DX);
+	w.op(SCMD_RET);
+
+	PScript script(new ccScript());
+	w.write(*script);
+	script->globaldatasize = 8;
+	script->globaldata = (char *)calloc(1, 8);
+	script->stringssize = 8;
+	script->strings = (char *)malloc(8);
+	memcpy(script->strings, "abc\0abc\0", 8);
+	script->numimports = 1;
+	script->imports = (char **)malloc(sizeof(char *));
+	script->imports[0] = scumm_strdup(TestImportName);
+	script->numexports = 1;
+	script->exports = (char **)malloc(sizeof(char *));
+	script->exports[0] = scumm_strdup("Bench");
+	script->export_addr = (int32_t *)malloc(sizeof(int32_t));
+	script->export_addr[0] = EXPORT_FUNCTION << 24;
+	return script;
+}
+
+int32_t expectedSum(int32_t iterations, bool subtract) {
+	int32_t sum = 0;
+	for (int32_t i = 0; i < iterations; ++i) {
+		const int32_t t = i % 1000;
+		const int32_t u = (t * t % 7) * (t * t % 7);
+		sum = subtract ? sum + u - t : sum + u + t;
+	}
+	return sum;
+}
+
+// Runs the script and returns its result
+int32_t runScript(ccInstance *inst, bool predecoded) {
+	ccSetOption(SCOPT_PREDECODE, predecoded);
+	const int result = inst->CallScriptFunction("Bench", 0, nullptr);
+	ccSetOption(SCOPT_PREDECODE, 1);
+	assert(result == 0);
+	return inst->returnValue;
+}
+
+int32_t readGlobal(const ccInstance *inst, int32_t addr) {
+	return READ_LE_INT32(inst->globaldata + addr);
+}
+
+} // namespace
+
+void Test_ScriptVM() {
+	const int32_t iterations = 2000;
+	ccAddExternalStaticFunction(TestImportName, Sc_ScriptVmTest_Add);
+	PScript script = buildScript(iterations);
+
+	// The pre-decoded code runs the same as the original one
+	ccInstance *inst = ccInstance::CreateFromScript(script);
+	assert(inst && inst->decoded_code);
+	assert(runScript(inst, false) == expectedSum(iterations, false));
+	assert(readGlobal(inst, 4) == 1);
+	memset(inst->globaldata, 0, 8);
+	assert(runScript(inst, true) == expectedSum(iterations, false));
+	assert(readGlobal(inst, 4) == 1);
+
+	// Equal values are only kept once: five registers, 0, 1, 1000, the
+	// iterations, the jump, the function address, two globals, two strings
+	// and the import
+	assert(inst->decoded_code->Values.size() == 16);
+
+	// A replaced import is picked up by the decoded code
+	ccAddExternalStaticFunction(TestImportName, Sc_ScriptVmTest_Sub);
+	memset(inst->globaldata, 0, 8);
+	assert(runScript(inst, true) == expectedSum(iterations, true));
+
+	// Forks share the decoded code
+	ccInstance *fork = inst->Fork();
+	assert(fork->decoded_code == inst->decoded_code);
+	memset(inst->globaldata, 0, 8);
+	assert(runScript(fork, true) == expectedSum(iterations, true));
+	delete fork;
+	delete inst;
+
+	// Without the option the code is not decoded
+	ccSetOption(SCOPT_PREDECODE, 0);
+	inst = ccInstance::CreateFromScript(script);
+	ccSetOption(SCOPT_PREDECODE, 1);
+	assert(inst && !inst->decoded_code);
+	assert(runScript(inst, true) == expectedSum(iterations, true));
+	delete inst;
+
+	ccRemoveExternalSymbol(TestImportName);
+}
+
+void Test_ScriptVMBenchmark() {
+	const int32_t iterations = 1000000;
+	ccAddExternalStaticFunction(TestImportName, Sc_ScriptVmTest_Add);
+	PScript script = buildScript(iterations);
+	ccInstance *inst = ccInstance::CreateFromScript(script);
+
+	uint32 times[2];
+	for (int predecoded = 0; predecoded < 2; ++predecoded) {
+		memset(inst->globaldata, 0, 8);
+		const uint32 start = g_system->getMillis();
+		runScript(inst, predecoded != 0);
+		times[predecoded] = g_system->getMillis() - start;
+	}
+	debug("Script VM, loop of %d iterations: original %u ms, pre-decoded %u ms",
+		iterations, times[0], times[1]);
+
+	delete inst;
+	ccRemoveExternalSymbol(TestImportName);
+}
+
+} // namespace AGS3
@@ -0,0 +1,147 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#include "ags/shared/core/platform.h"
+#include "ags/shared/ac/sprite_cache_policy.h"
+#include "ags/shared/debugging/assert.h"
+#include "common/system.h"
+#include "common/debug.h"
+
+namespace AGS3 {
+
+namespace {
+
+void addAccess(std::vector<SpriteAccess> &trace, sprkey_t index, uint32_t size) {
+	SpriteAccess access;
+	access.Index = index;
+	access.Size = size;
+	trace.push_back(access);
+}
+
+// Builds requests like those of a high resolution game: the GUI and the
+// walking characters every frame, large room backgrounds and objects
+// which change with the room, and some full screen one-off sprites
+void buildGameTrace(std::vector<SpriteAccess> &trace) {
+	const uint32_t guiSize = 32 * 32 * 4;
+	const uint32_t frameSize = 100 * 150 * 4;
+	const uint32_t objectSize = 640 * 480 * 4;
+	const uint32_t fullScreenSize = 1280 * 720 * 4;
+	uint32_t seed = 1;
+
+	for (int frame = 0; frame < 20000; ++frame) {
+		const int room = (frame / 400) % 12;
+		seed = seed * 1103515245 + 12345;
+
+		for (int i = 0; i < 40; ++i)
+			addAccess(trace, 1 + i, guiSize);
+		for (int chr = 0; chr < 6; ++chr)
+			addAccess(trace, 100 + chr * 32 + (frame / 4 + chr) % 8 + 8 * ((frame / 200 + chr) % 4), frameSize);
+		for (int obj = 0; obj < 3; ++obj)
+			addAccess(trace, 1000 + room * 3 + obj, objectSize);
+		if ((seed >> 16) % 50 == 0)
+			addAccess(trace, 2000 + frame, fullScreenSize);
+	}
+}
+
+} // namespace
+
+void Test_SpriteCachePolicies() {
+	// LRU disposes the sprites in the order of their use,
+	// and the unused ones first
+	SpriteCachePolicy *lru = CreateSpriteCachePolicy(kSprCachePolicy_LRU);
+	lru->Add(1, 100, true);
+	lru->Add(2, 100, true);
+	lru->Add(3, 100, true);
+	lru->Add(4, 100, false);
+	lru->Touch(1);
+	assert(lru->PopVictim() == 4);
+	assert(lru->PopVictim() == 2);
+	lru->Remove(3);
+	assert(!lru->Contains(3));
+	assert(lru->PopVictim() == 1);
+	assert(lru->PopVictim() == -1);
+	delete lru;
+
+	// GDSF keeps small sprites which are used often instead of a large one
+	SpriteCachePolicy *gdsf = CreateSpriteCachePolicy(kSprCachePolicy_GDSF);
+	for (sprkey_t i = 1; i <= 10; ++i) {
+		gdsf->Add(i, 4096, true);
+		for (int j = 0; j < 5; ++j)
+			gdsf->Touch(i);
+	}
+	gdsf->Add(11, 1024 * 1024, true);
+	gdsf->Add(12, 4096, false);
+	assert(gdsf->PopVictim() == 12);
+	assert(gdsf->PopVictim() == 11);
+	gdsf->Remove(5);
+	for (int i = 0; i < 9; ++i) {
+		sprkey_t victim = gdsf->PopVictim();
+		assert(victim >= 1 && victim <= 10 && victim != 5);
+	}
+	assert(gdsf->PopVictim() == -1);
+
+	// Sprites which are not used anymore age, until they go before the hot ones
+	gdsf->Add(1, 4096, true);
+	for (int j = 0; j < 20; ++j)
+		gdsf->Touch(1);
+	for (sprkey_t i = 2; i < 200; ++i) {
+		gdsf->Add(i, 4096, true);
+		if (gdsf->PopVictim() == 1)
+			break;
+		assert(i < 199);
+	}
+	delete gdsf;
+
+	// Replays with enough space only miss once per sprite
+	std::vector<SpriteAccess> trace;
+	buildGameTrace(trace);
+	for (int i = 0; i < kNumSprCachePolicies; ++i) {
+		SpriteCachePolicy *policy = CreateSpriteCachePolicy((SpriteCachePolicyType)i);
+		assert(FindSpriteCachePolicy(policy->GetName()) == i);
+		SpriteReplayStats stats = ReplaySpriteTrace(*policy, trace, (size_t)-1);
+		assert(stats.Hits + stats.Misses == trace.size());
+		assert(stats.Disposed == 0 && stats.BytesReloaded == 0);
+		assert(!policy->Contains(1));
+		delete policy;
+	}
+	assert(FindSpriteCachePolicy("none") == kNumSprCachePolicies);
+}
+
+void Test_SpriteCacheReplay() {
+	std::vector<SpriteAccess> trace;
+	buildGameTrace(trace);
+
+	const size_t cacheSizesKb[] = { 4 * 1024, 8 * 1024, 16 * 1024 };
+	for (size_t s = 0; s < ARRAYSIZE(cacheSizesKb); ++s) {
+		for (int i = 0; i < kNumSprCachePolicies; ++i) {
+			SpriteCachePolicy *policy = CreateSpriteCachePolicy((SpriteCachePolicyType)i);
+			const uint32 start = g_system->getMillis();
+			SpriteReplayStats stats = ReplaySpriteTrace(*policy, trace, cacheSizesKb[s] * 1024);
+			debug("Sprite cache replay, %s with %u KB: hits %u, misses %u, reloaded %u KB, %u ms",
+				policy->GetName(), (uint)cacheSizesKb[s], stats.Hits, stats.Misses,
+				(uint)(stats.BytesReloaded / 1024), g_system->getMillis() - start);
+			delete policy;
+		}
+	}
+}
+
+} // namespace AGS3
@@ -54,6 +54,7 @@
 #include "sci/video/seq_decoder.h"
 #ifdef ENABLE_SCI32
 #include "common/memstream.h"
+#include "sci/graphics/celobj32.h"
 #include "sci/graphics/frameout.h"
 #include "sci/graphics/paint32.h"
 #include "sci/graphics/palette32.h"
@@ -120,9 +121,12 @@ Console::Console(SciEngine *engine) : GUI::Debugger(),
 	registerCmd("hexgrep",			WRAP_METHOD(Console, cmdHexgrep));
 	registerCmd("verify_scripts",		WRAP_METHOD(Console, cmdVerifyScripts));
 	registerCmd("integrity_dump",	WRAP_METHOD(Console, cmdResourceIntegrityDump));
+	registerCmd("resource_prefetch",	WRAP_METHOD(Console, cmdResourcePrefetch));
+	registerCmd("resources",			WRAP_METHOD(Console, cmdResources));
 	// Game
 	registerCmd("save_game",			WRAP_METHOD(Console, cmdSaveGame));
 	registerCmd("restore_game",		WRAP_METHOD(Console, cmdRestoreGame));
+	registerCmd("save_writer",		WRAP_METHOD(Console, cmdSaveWriter));
 	registerCmd("restart_game",		WRAP_METHOD(Console, cmdRestartGame));
 	registerCmd("version",			WRAP_METHOD(Console, cmdGetVersion));
 	registerCmd("room",				WRAP_METHOD(Console, cmdRoomNumber));
@@ -148,6 +152,9 @@ Console::Console(SciEngine *engine) : GUI::Debugger(),
 	registerCmd("pi",                 WRAP_METHOD(Console, cmdPlaneItemList));	// alias
 	registerCmd("visible_plane_items", WRAP_METHOD(Console, cmdVisiblePlaneItemList));
 	registerCmd("vpi",                WRAP_METHOD(Console, cmdVisiblePlaneItemList));	// alias
+	registerCmd("frameout_stats",     WRAP_METHOD(Console, cmdFrameOutStats));
+	registerCmd("cel_benchmark",      WRAP_METHOD(Console, cmdCelBenchmark));
+	registerCmd("cel_cache",          WRAP_METHOD(Console, cmdCelCache));
 	registerCmd("saved_bits",         WRAP_METHOD(Console, cmdSavedBits));
 	registerCmd("show_saved_bits",    WRAP_METHOD(Console, cmdShowSavedBits));
 	// Segments
@@ -163,6 +170,7 @@ Console::Console(SciEngine *engine) : GUI::Debugger(),
 	registerCmd("gc_reachable",		WRAP_METHOD(Console, cmdGCShowReachable));
 	registerCmd("gc_freeable",		WRAP_METHOD(Console, cmdGCShowFreeable));
 	registerCmd("gc_normalize",		WRAP_METHOD(Console, cmdGCNormalize));
+	registerCmd("gc_stats",			WRAP_METHOD(Console, cmdGCStats));
 	// Music/SFX
 	registerCmd("songlib",			WRAP_METHOD(Console, cmdSongLib));
 	registerCmd("songinfo",			WRAP_METHOD(Console, cmdSongInfo));
@@ -226,6 +234,8 @@ Console::Console(SciEngine *engine) : GUI::Debugger(),
 	registerCmd("bpe",				WRAP_METHOD(Console, cmdBreakpointFunction));		// alias
 	// VM
 	registerCmd("script_steps",		WRAP_METHOD(Console, cmdScriptSteps));
+	registerCmd("opcode_profile",		WRAP_METHOD(Console, cmdOpcodeProfile));
+	registerCmd("send_cache",		WRAP_METHOD(Console, cmdSendCache));
 	registerCmd("script_objects",   WRAP_METHOD(Console, cmdScriptObjects));
 	registerCmd("scro",             WRAP_METHOD(Console, cmdScriptObjects));
 	registerCmd("script_strings",   WRAP_METHOD(Console, cmdScriptStrings));
@@ -257,9 +267,12 @@ Console::Console(SciEngine *engine) : GUI::Debugger(),
 	_debugState.breakpointWasHit = false;
 	_debugState._breakpoints.clear(); // No breakpoints defined
 	_debugState._activeBreakpointTypes = 0;
+	_debugState.opcodeProfile = NULL;
 }
 
 Console::~Console() {
+	delete _debugState.opcodeProfile;
+	_debugState.opcodeProfile = NULL;
 }
 
 void Console::attach(const char *entry) {
@@ -350,10 +363,13 @@ bool Console::cmdHelp(int argc, const char **argv) {
 	debugPrintf(" hexgrep - Searches some resources for a particular sequence of bytes, represented as hexadecimal numbers\n");
 	debugPrintf(" verify_scripts - Performs sanity checks on SCI1.1-SCI2.1 game scripts (e.g. if they're up to 64KB in total)\n");
 	debugPrintf(" integrity_dump - Dumps integrity data about resources in the current game to disk\n");
+	debugPrintf(" resource_prefetch - Shows the resource prefetching counters, or turns prefetching on or off\n");
+	debugPrintf(" resources - Shows the resource memory use and hit rates, or sets memory limits and pinned resources\n");
 	debugPrintf("\n");
 	debugPrintf("Game:\n");
 	debugPrintf(" save_game - Saves the current game state to the hard disk\n");
 	debugPrintf(" restore_game - Restores a saved game from the hard disk\n");
+	debugPrintf(" save_writer - Shows the timings of savegames, or turns writing them in the background on/off\n");
 	debugPrintf(" list_saves - List all saved games including filenames\n");
 	debugPrintf(" restart_game - Restarts the game\n");
 	debugPrintf(" version - Shows the resource and interpreter versions\n");
@@ -374,6 +390,9 @@ bool Console::cmdHelp(int argc, const char **argv) {
 	debugPrintf(" visible_plane_list / vpl - Shows a list of all the planes in the visible draw list (SCI2+)\n");
 	debugPrintf(" plane_items / pi - Shows a list of all items for a plane (SCI2+)\n");
 	debugPrintf(" visible_plane_items / vpi - Shows a list of all items for a plane in the visible draw list (SCI2+)\n");
+	debugPrintf(" frameout_stats - Shows or resets the rendering counters of the frames (SCI2+)\n");
+	debugPrintf(" cel_benchmark - Draws the cels of a view through all renderers and compares them (SCI2+)\n");
+	debugPrintf(" cel_cache - Shows, clears or resizes the cache of decompressed cels (SCI2+)\n");
 	debugPrintf(" saved_bits - List saved bits on the hunk\n");
 	debugPrintf(" show_saved_bits - Display saved bits\n");
 	debugPrintf("\n");
@@ -388,6 +407,7 @@ bool Console::cmdHelp(int argc, const char **argv) {
 	debugPrintf(" gc_reachable - Lists all addresses directly reachable from a given memory object\n");
 	debugPrintf(" gc_freeable - Lists all addresses freeable in a given segment\n");
 	debugPrintf(" gc_normalize - Prints the \"normal\" address of a given address\n");
+	debugPrintf(" gc_stats - Shows the garbage collection timings, or changes incremental collection\n");
 	debugPrintf("\n");
 	debugPrintf("Music/SFX:\n");
 	debugPrintf(" songlib - Shows the song library\n");
@@ -433,6 +453,8 @@ bool Console::cmdHelp(int argc, const char **argv) {
 	debugPrintf("\n");
 	debugPrintf("VM:\n");
 	debugPrintf(" script_steps - Shows the number of executed SCI operations\n");
+	debugPrintf(" opcode_profile - Shows the most frequent opcodes and opcode pairs, or turns profiling on or off\n");
+	debugPrintf(" send_cache - Shows the hit rate of the inline caches of sends, or turns them on or off\n");
 	debugPrintf(" script_objects / scro - Shows all objects inside a specified script\n");
 	debugPrintf(" script_strings / scrs - Shows all strings inside a specified script\n");
 	debugPrintf(" script_said - Shows all said - strings inside a specified script\n");
@@ -1097,6 +1119,84 @@ bool Console::cmdResourceInfo(int argc, const char **argv) {
 	return true;
 }
 
+bool Console::cmdResourcePrefetch(int argc, const char **argv) {
+	if (argc > 2 || (argc == 2 && strcmp(argv[1], "on") && strcmp(argv[1], "off") && strcmp(argv[1], "reset"))) {
+		debugPrintf("Shows how well the resources used by rooms were loaded ahead of their use,\n");
+		debugPrintf("turns prefetching on or off, or resets the counters\n");
+		debugPrintf("Usage: %s [on | off | reset]\n", argv[0]);
+		return true;
+	}
+
+	ResourceManager *resMan = _engine->getResMan();
+	if (argc == 2) {
+		if (!strcmp(argv[1], "reset"))
+			resMan->resetPrefetchStats();
+		else
+			resMan->setPrefetchEnabled(!strcmp(argv[1], "on"));
+	}
+
+	const ResourceManager::PrefetchStats &stats = resMan->getPrefetchStats();
+	debugPrintf("Prefetching is %s, %u resources queued\n", resMan->isPrefetchEnabled() ? "on" : "off", resMan->getPrefetchQueueSize());
+	debugPrintf("Queued: %u, prefetched: %u (%u KB), skipped for lack of memory: %u\n",
+		stats.queued, stats.prefetched, stats.prefetchedBytes / 1024, stats.skipped);
+	debugPrintf("Prefetched resources used: %u, freed unused: %u\n", stats.hits, stats.wasted);
+	debugPrintf("Resources loaded on request: %u, in %u ms\n", stats.stalls, stats.stallTime);
+	return true;
+}
+
+bool Console::cmdResources(int argc, const char **argv) {
+	ResourceManager *resMan = _engine->getResMan();
+
+	if (argc == 2 && !strcmp(argv[1], "reset")) {
+		resMan->resetResourceStats();
+	} else if (argc == 3 && !strcmp(argv[1], "limit")) {
+		resMan->setMaxMemoryLRU(MAX(atoi(argv[2]), 0) * 1024);
+	} else if (argc == 4 && !strcmp(argv[1], "budget")) {
+		int category = 0;
+		while (category < kResourceCategoryCount && strcmp(argv[2], getResourceCategoryName((ResourceCategory)category)))
+			++category;
+		if (category == kResourceCategoryCount) {
+			debugPrintf("Unknown resource category '%s'\n", argv[2]);
+			return true;
+		}
+		resMan->setLRUBudget((ResourceCategory)category, MAX(atoi(argv[3]), 0) * 1024);
+	} else if (argc == 4 && (!strcmp(argv[1], "pin") || !strcmp(argv[1], "unpin"))) {
+		const ResourceType type = parseResourceType(argv[2]);
+		if (type == kResourceTypeInvalid) {
+			debugPrintf("Resource type '%s' is not valid\n", argv[2]);
+			return true;
+		}
+		if (!resMan->pinResource(ResourceId(type, atoi(argv[3])), !strcmp(argv[1], "pin"))) {
+			debugPrintf("Resource %s.%s not found\n", argv[2], argv[3]);
+			return true;
+		}
+	} else if (argc != 1) {
+		debugPrintf("Shows the memory used by resources and how often requested resources were in memory\n");
+		debugPrintf("Usage: %s [reset]\n", argv[0]);
+		debugPrintf("       %s limit <KB> - sets the memory limit of all unlocked resources\n", argv[0]);
+		debugPrintf("       %s budget <category> <KB> - sets the memory budget of a category, 0 for none\n", argv[0]);
+		debugPrintf("       %s pin|unpin <resource type> <resource number> - keeps a resource in memory\n", argv[0]);
+		debugPrintf("Categories are graphics, audio, script and other\n");
+		return true;
+	}
+
+	debugPrintf("Unlocked: %d of %d KB, locked: %d KB, pinned: %u KB in %u resources\n",
+		resMan->getMemoryLRU() / 1024, resMan->getMaxMemoryLRU() / 1024, resMan->getMemoryLocked() / 1024,
+		resMan->getPinnedMemory() / 1024, resMan->getPinnedCount());
+	debugPrintf("Category   Unlocked KB (count)  Budget KB  Requests  Hit rate  Loads  Reloads  Freed  Loaded KB\n");
+	for (int i = 0; i < kResourceCategoryCount; ++i) {
+		const ResourceCategory category = (ResourceCategory)i;
+		const ResourceManager::ResourceStats &stats = resMan->getResourceStats(category);
+		debugPrintf("%-10s %11u %7s  %9u  %8u  %7u%%  %5u  %7u  %5u  %9u\n",
+			getResourceCategoryName(category), resMan->getLRUMemory(category) / 1024,
+			Common::String::format("(%u)", resMan->getLRUCount(category)).c_str(),
+			resMan->getLRUBudget(category) / 1024, stats.requests,
+			stats.requests ? (uint)((uint64)stats.hits * 100 / stats.requests) : 0,
+			stats.loads, stats.reloads, stats.evictions, (uint)(stats.loadedBytes / 1024));
+	}
+	return true;
+}
+
 bool Console::cmdResourceTypes(int argc, const char **argv) {
 	debugPrintf("The %d valid resource types are:\n", kResourceTypeInvalid);
 	for (int i = 0; i < kResourceTypeInvalid; i++) {
@@ -1611,6 +1711,33 @@ bool Console::cmdSaveGame(int argc, const char **argv) {
 	return true;
 }
 
+bool Console::cmdSaveWriter(int argc, const char **argv) {
+	SavegameWriter *writer = _engine->getSavegameWriter();
+
+	if (argc == 2 && !scumm_stricmp(argv[1], "reset")) {
+		writer->resetStats();
+		return true;
+	} else if (argc == 2 && (!scumm_stricmp(argv[1], "on") || !scumm_stricmp(argv[1], "off"))) {
+		writer->flush();
+		writer->setEnabled(!scumm_stricmp(argv[1], "on"));
+	} else if (argc != 1) {
+		debugPrintf("Shows the timings of savegames, or turns writing them in the background on/off.\n");
+		debugPrintf("Usage: %s [on | off | reset]\n", argv[0]);
+		return true;
+	}
+
+	const SavegameWriterStats &stats = writer->getStats();
+	debugPrintf("Writing savegames in the background is %s%s\n",
+		writer->isEnabled() ? "on" : "off", writer->isPending() ? ", a savegame is pending" : "");
+	debugPrintf("Savegames written: %u, finished right away: %u, failed: %u\n",
+		stats.saves, stats.flushes, stats.failures);
+	debugPrintf("Last snapshot: %u bytes in %u ms, longest snapshot %u ms\n",
+		stats.snapshotSize, stats.snapshotTime, stats.maxSnapshotTime);
+	debugPrintf("Last write: %u ms over %u frames\n", stats.writeTime, stats.writeSteps);
+
+	return true;
+}
+
 bool Console::cmdRestoreGame(int argc, const char **argv) {
 	if (argc != 2) {
 		debugPrintf("Restores a saved game from the hard disk\n");
@@ -1618,6 +1745,7 @@ bool Console::cmdRestoreGame(int argc, const char **argv) {
 		return true;
 	}
 
+	_engine->getSavegameWriter()->flush();
 	Common::SaveFileManager *saveFileMan = g_engine->getSaveFileManager();
 	Common::SeekableReadStream *in = saveFileMan->openForLoading(argv[1]);
 	if (in) {
@@ -2148,6 +2276,82 @@ bool Console::cmdVisiblePlaneItemList(int argc, const char **argv) {
 	return true;
 }
 
+bool Console::cmdFrameOutStats(int argc, const char **argv) {
+	if (argc > 2 || (argc == 2 && strcmp(argv[1], "reset"))) {
+		debugPrintf("Shows the rendering counters of the last frame and the average of all frames\n");
+		debugPrintf("Usage: %s [reset]\n", argv[0]);
+		return true;
+	}
+
+#ifdef ENABLE_SCI32
+	if (_engine->_gfxFrameout) {
+		if (argc == 2) {
+			_engine->_gfxFrameout->resetFrameOutStats();
+			debugPrintf("Rendering counters reset\n");
+		} else {
+			_engine->_gfxFrameout->printFrameOutStats(this);
+		}
+	} else {
+		debugPrintf("This SCI version does not have a frameout renderer\n");
+	}
+#else
+	debugPrintf("SCI32 isn't included in this compiled executable\n");
+#endif
+	return true;
+}
+
+bool Console::cmdCelBenchmark(int argc, const char **argv) {
+	if (argc < 2 || argc > 3) {
+		debugPrintf("Draws all cels of a view through every cel renderer, pixel by pixel and by rows,\n");
+		debugPrintf("and shows the times and any differences in the output\n");
+		debugPrintf("Usage: %s <view number> [<iterations>]\n", argv[0]);
+		return true;
+	}
+
+#ifdef ENABLE_SCI32
+	if (_engine->_gfxFrameout) {
+		const GuiResourceId viewId = atoi(argv[1]);
+		const int iterations = argc == 3 ? MAX(atoi(argv[2]), 1) : 100;
+		CelObj::benchmarkRenderers(this, viewId, iterations);
+	} else {
+		debugPrintf("This SCI version does not have SCI32 cels\n");
+	}
+#else
+	debugPrintf("SCI32 isn't included in this compiled executable\n");
+#endif
+	return true;
+}
+
+bool Console::cmdCelCache(int argc, const char **argv) {
+	const bool clear = argc == 2 && !strcmp(argv[1], "clear");
+	const bool resize = argc == 3 && !strcmp(argv[1], "size");
+	if (argc > 1 && !clear && !resize) {
+		debugPrintf("Shows the use of the cache of decompressed cel pixels, drops all cels\n");
+		debugPrintf("from it, or sets its size limit in KB (0 disables the cache)\n");
+		debugPrintf("Usage: %s [clear | size <KB>]\n", argv[0]);
+		return true;
+	}
+
+#ifdef ENABLE_SCI32
+	if (_engine->_gfxFrameout && CelObj::_pixelCache) {
+		CelPixelCache &cache = *CelObj::_pixelCache;
+		if (clear) {
+			cache.clear();
+			cache.resetStats();
+			debugPrintf("Cel pixel cache cleared\n");
+		} else if (resize) {
+			cache.setMaxSize(MAX(atoi(argv[2]), 0) * 1024);
+		}
+		cache.printStats(this);
+	} else {
+		debugPrintf("This SCI version does not have SCI32 cels\n");
+	}
+#else
+	debugPrintf("SCI32 isn't included in this compiled executable\n");
+#endif
+	return true;
+}
+
 bool Console::cmdSavedBits(int argc, const char **argv) {
 	SegManager *segman = _engine->_gamestate->_segMan;
 	SegmentId id = segman->findSegmentByType(SEG_TYPE_HUNK);
@@ -2841,6 +3045,38 @@ bool Console::cmdGCNormalize(int argc, const char **argv) {
 	return true;
 }
 
+bool Console::cmdGCStats(int argc, const char **argv) {
+	GarbageCollector *gc = _engine->_gamestate->_segMan->getGC();
+
+	if (argc == 2 && !scumm_stricmp(argv[1], "reset")) {
+		gc->resetStats();
+		return true;
+	} else if (argc == 3 && !scumm_stricmp(argv[1], "incremental")) {
+		gc->setIncremental(!scumm_stricmp(argv[2], "on"));
+	} else if (argc == 3 && !scumm_stricmp(argv[1], "step")) {
+		gc->setStepSize(atoi(argv[2]));
+	} else if (argc != 1) {
+		debugPrintf("Shows the garbage collection timings, or changes incremental collection.\n");
+		debugPrintf("Usage: %s [reset | incremental on|off | step <references>]\n", argv[0]);
+		return true;
+	}
+
+	const GCStats &stats = gc->getStats();
+	debugPrintf("Incremental collection is %s, %u references per step%s\n",
+		gc->isIncremental() ? "on" : "off", gc->getStepSize(), gc->isMarking() ? ", marking" : "");
+	debugPrintf("Full collections: %u, incremental: %u finished, %u cancelled\n",
+		stats.collections, stats.cycles, stats.cancelled);
+	debugPrintf("Marking steps: %u, %u ms in total, longest %u ms\n",
+		stats.steps, stats.markTime, stats.maxStepTime);
+	debugPrintf("Pauses: %u ms in total, longest %u ms, last %u ms\n",
+		stats.pauseTime, stats.maxPauseTime, stats.lastPauseTime);
+	debugPrintf("Rescanned references: %u, reported by the write barrier: %u\n",
+		stats.rescanned, stats.barriers);
+	debugPrintf("Freed: %u\n", stats.freed);
+
+	return true;
+}
+
 bool Console::cmdVMVarlist(int argc, const char **argv) {
 	EngineState *s = _engine->_gamestate;
 	const char *varnames[] = {"global", "local", "temp", "param"};
@@ -3270,6 +3506,134 @@ bool Console::cmdScriptSteps(int argc, const char **argv) {
 	return true;
 }
 
+namespace {
+struct OpcodeCount {
+	uint32 count;
+	uint index;
+
+	bool operator<(const OpcodeCount &other) const {
+		return count > other.count;
+	}
+};
+} // End of anonymous namespace
+
+bool Console::cmdOpcodeProfile(int argc, const char **argv) {
+	if (argc == 2 && !scumm_stricmp(argv[1], "on")) {
+		if (!_debugState.opcodeProfile)
+			_debugState.opcodeProfile = new OpcodeProfile();
+		debugPrintf("Opcode profiling is on. Superinstructions are not used while profiling\n");
+		return true;
+	} else if (argc == 2 && !scumm_stricmp(argv[1], "off")) {
+		delete _debugState.opcodeProfile;
+		_debugState.opcodeProfile = NULL;
+		debugPrintf("Opcode profiling is off\n");
+		return true;
+	} else if (argc == 2 && !scumm_stricmp(argv[1], "reset")) {
+		if (_debugState.opcodeProfile)
+			_debugState.opcodeProfile->reset();
+		return true;
+	} else if (argc != 1) {
+		debugPrintf("Shows the most frequent opcodes and opcode pairs, or turns profiling on or off.\n");
+		debugPrintf("Usage: %s [on | off | reset]\n", argv[0]);
+		return true;
+	}
+
+	const OpcodeProfile *profile = _debugState.opcodeProfile;
+	if (!profile) {
+		debugPrintf("Opcode profiling is off, turn it on with: %s on\n", argv[0]);
+		return true;
+	}
+
+	Common::Array<OpcodeCount> opcodes;
+	Common::Array<OpcodeCount> pairs;
+	uint64 total = 0;
+	for (uint i = 0; i < 128; ++i) {
+		total += profile->opcodes[i];
+		if (profile->opcodes[i]) {
+			OpcodeCount count = { profile->opcodes[i], i };
+			opcodes.push_back(count);
+		}
+		for (uint j = 0; j < 128; ++j) {
+			if (profile->pairs[i][j]) {
+				OpcodeCount count = { profile->pairs[i][j], i * 128 + j };
+				pairs.push_back(count);
+			}
+		}
+	}
+	Common::sort(opcodes.begin(), opcodes.end());
+	Common::sort(pairs.begin(), pairs.end());
+
+	if (!total) {
+		debugPrintf("No opcodes executed yet\n");
+		return true;
+	}
+
+	debugPrintf("%u opcodes executed, %u push runs and %u ldi/push pairs could be fused\n",
+		(uint)total, profile->pushRuns, profile->loadPushes);
+
+	debugPrintf("Opcodes:\n");
+	for (uint i = 0; i < opcodes.size() && i < 20; ++i) {
+		debugPrintf(" %-8s %10u %5.1f%%\n", opcodeNames[opcodes[i].index], opcodes[i].count,
+			opcodes[i].count * 100.0 / total);
+	}
+
+	debugPrintf("Opcode pairs:\n");
+	for (uint i = 0; i < pairs.size() && i < 20; ++i) {
+		debugPrintf(" %-8s %-8s %10u %5.1f%%\n", opcodeNames[pairs[i].index / 128],
+			opcodeNames[pairs[i].index % 128], pairs[i].count, pairs[i].count * 100.0 / total);
+	}
+
+	return true;
+}
+
+bool Console::cmdSendCache(int argc, const char **argv) {
+	SegManager *segMan = _engine->_gamestate->_segMan;
+
+	if (argc == 2 && !scumm_stricmp(argv[1], "on")) {
+		segMan->setSendCacheEnabled(true);
+	} else if (argc == 2 && !scumm_stricmp(argv[1], "off")) {
+		segMan->setSendCacheEnabled(false);
+	} else if (argc == 2 && !scumm_stricmp(argv[1], "reset")) {
+		segMan->resetSendCacheStats();
+		return true;
+	} else if (argc != 1) {
+		debugPrintf("Shows the hit rate of the inline caches of sends, or turns them on or off.\n");
+		debugPrintf("Usage: %s [on | off | reset]\n", argv[0]);
+		return true;
+	}
+
+	const SendCacheStats &stats = segMan->getSendCacheStats();
+	const uint32 lookups = stats.hits + stats.misses;
+	debugPrintf("Send caches are %s\n", segMan->isSendCacheEnabled() ? "on" : "off");
+	debugPrintf("Lookups: %u, hits: %u (%.1f%%), misses: %u, evictions: %u, invalidations: %u\n",
+		lookups, stats.hits, lookups ? stats.hits * 100.0 / lookups : 0.0, stats.misses,
+		stats.evictions, stats.invalidations);
+
+	// Count the sends by the number of receiver types they have seen since
+	// the last invalidation
+	uint32 sites[3] = { 0, 0, 0 };
+	const Common::Array<SegmentObj *> &segments = segMan->getSegments();
+	for (uint i = 0; i < segments.size(); ++i) {
+		if (!segments[i] || segments[i]->getType() != SEG_TYPE_SCRIPT)
+			continue;
+
+		const Common::Array<SendCache> &caches = static_cast<Script *>(segments[i])->getSendCaches();
+		for (uint j = 0; j < caches.size(); ++j) {
+			if (caches[j].epoch != segMan->getSendCacheEpoch() || !caches[j].count)
+				continue;
+			if (caches[j].count == 1)
+				++sites[0];
+			else if (caches[j].count <= kSendCacheEntries)
+				++sites[1];
+			else
+				++sites[2];
+		}
+	}
+	debugPrintf("Sends: %u monomorphic, %u polymorphic, %u megamorphic\n", sites[0], sites[1], sites[2]);
+
+	return true;
+}
+
 bool Console::cmdScriptObjects(int argc, const char **argv) {
 	int curScriptNr = -1;
 
@@ -78,12 +78,15 @@ private:
 	bool cmdResourceTypes(int argc, const char **argv);
 	bool cmdList(int argc, const char **argv);
 	bool cmdResourceIntegrityDump(int argc, const char **argv);
+	bool cmdResourcePrefetch(int argc, const char **argv);
+	bool cmdResources(int argc, const char **argv);
 	bool cmdAllocList(int argc, const char **argv);
 	bool cmdHexgrep(int argc, const char **argv);
 	bool cmdVerifyScripts(int argc, const char **argv);
 	// Game
 	bool cmdSaveGame(int argc, const char **argv);
 	bool cmdRestoreGame(int argc, const char **argv);
+	bool cmdSaveWriter(int argc, const char **argv);
 	bool cmdRestartGame(int argc, const char **argv);
 	bool cmdGetVersion(int argc, const char **argv);
 	bool cmdRoomNumber(int argc, const char **argv);
@@ -104,6 +107,9 @@ private:
 	bool cmdVisiblePlaneList(int argc, const char **argv);
 	bool cmdPlaneItemList(int argc, const char **argv);
 	bool cmdVisiblePlaneItemList(int argc, const char **argv);
+	bool cmdFrameOutStats(int argc, const char **argv);
+	bool cmdCelBenchmark(int argc, const char **argv);
+	bool cmdCelCache(int argc, const char **argv);
 	bool cmdSavedBits(int argc, const char **argv);
 	bool cmdShowSavedBits(int argc, const char **argv);
 	// Segments
@@ -116,6 +122,7 @@ private:
 	bool cmdGCShowReachable(int argc, const char **argv);
 	bool cmdGCShowFreeable(int argc, const char **argv);
 	bool cmdGCNormalize(int argc, const char **argv);
+	bool cmdGCStats(int argc, const char **argv);
 	// Music/SFX
 	bool cmdSongLib(int argc, const char **argv);
 	bool cmdSongInfo(int argc, const char **argv);
@@ -159,6 +166,8 @@ private:
 	bool cmdBreakpointAddress(int argc, const char **argv);
 	// VM
 	bool cmdScriptSteps(int argc, const char **argv);
+	bool cmdOpcodeProfile(int argc, const char **argv);
+	bool cmdSendCache(int argc, const char **argv);
 	bool cmdScriptObjects(int argc, const char **argv);
 	bool cmdScriptStrings(int argc, const char **argv);
 	bool cmdScriptSaid(int argc, const char **argv);
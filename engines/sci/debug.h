@@ -72,6 +72,27 @@ enum DebugSeeking {
 	kDebugSeekStepOver = 5      // Step forward until we reach same stack-level again
 };
 
+/**
+ * Counts of the executed opcodes and pairs of opcodes, used to find the
+ * sequences which are worth fusing into superinstructions. Only allocated
+ * while profiling, see the opcode_profile console command.
+ */
+struct OpcodeProfile {
+	uint32 opcodes[128];
+	uint32 pairs[128][128];  ///< By previous and current opcode
+	uint32 pushRuns;         ///< Executed push runs, see SuperInstructionType
+	uint32 loadPushes;       ///< Executed ldi/push pairs
+	int lastOpcode;          ///< -1 at the start of the profile
+
+	OpcodeProfile() { reset(); }
+	void reset() {
+		memset(opcodes, 0, sizeof(opcodes));
+		memset(pairs, 0, sizeof(pairs));
+		pushRuns = loadPushes = 0;
+		lastOpcode = -1;
+	}
+};
+
 struct DebugState {
 	bool debugging;
 	bool breakpointWasHit;
@@ -84,6 +105,7 @@ struct DebugState {
 	StackPtr old_sp;
 	Common::List<Breakpoint> _breakpoints;   //< List of breakpoints
 	int _activeBreakpointTypes;  //< Bit mask specifying which types of breakpoints are active
+	OpcodeProfile *opcodeProfile; //< Opcode counters, or NULL when not profiling
 
 	void updateActiveBreakpointTypes();
 };
@@ -132,6 +132,7 @@ reg_t file_open(EngineState *s, const Common::String &filename, kFileOpenMode mo
 	Common::SeekableReadStream *inFile = 0;
 	Common::WriteStream *outFile = 0;
 	Common::SaveFileManager *saveFileMan = g_sci->getSaveFileManager();
+	g_sci->getSavegameWriter()->flush();
 
 	bool isCompressed = true;
 	const SciGameId gameId = g_sci->getGameId();
@@ -304,6 +305,7 @@ static bool _savegame_sort_byDate(const SavegameDesc &l, const SavegameDesc &r)
 }
 
 bool fillSavegameDesc(const Common::String &filename, SavegameDesc &desc) {
+	g_sci->getSavegameWriter()->flush();
 	Common::SaveFileManager *saveFileMan = g_sci->getSaveFileManager();
 	Common::ScopedPtr<Common::SeekableReadStream> in(saveFileMan->openForLoading(filename));
 	if (!in) {
@@ -352,6 +354,7 @@ bool fillSavegameDesc(const Common::String &filename, SavegameDesc &desc) {
 
 // Create an array containing all found savedgames, sorted by creation date
 void listSavegames(Common::Array<SavegameDesc> &saves) {
+	g_sci->getSavegameWriter()->flush();
 	Common::SaveFileManager *saveFileMan = g_sci->getSaveFileManager();
 	Common::StringArray saveNames = saveFileMan->listSavefiles(g_sci->getSavegamePattern());
 
@@ -548,6 +551,7 @@ reg_t DirSeeker::firstFile(const Common::String &mask, reg_t buffer, SegManager
 	_outbuffer = buffer;
 	_files.clear();
 	_virtualFiles.clear();
+	g_sci->getSavegameWriter()->flush();
 
 	int QfGImport = g_sci->inQfGImportRoom();
 	if (QfGImport) {
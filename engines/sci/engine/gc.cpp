@@ -22,6 +22,7 @@
 
 #include "sci/engine/gc.h"
 #include "common/array.h"
+#include "common/system.h"
 #include "sci/graphics/ports.h"
 
 #ifdef ENABLE_SCI32
@@ -84,26 +85,50 @@ static AddrSet *normalizeAddresses(SegManager *segMan, const AddrSet &nonnormal_
 	return normal_map;
 }
 
-static void processWorkList(SegManager *segMan, WorklistManager &wm, const Common::Array<SegmentObj *> &heap) {
+// Clones, lists and nodes may be freed between the steps of an incremental
+// collection, while they are waiting in the worklist
+static bool isLiveEntry(const SegmentObj *mobj, reg_t reg) {
+	switch (mobj->getType()) {
+	case SEG_TYPE_CLONES:
+	case SEG_TYPE_LISTS:
+	case SEG_TYPE_NODES:
+		return mobj->isValidOffset(reg.getOffset());
+	default:
+		return true;
+	}
+}
+
+/**
+ * Marks the references in the worklist, until it is empty or the given
+ * number of references was marked. 0 means no limit.
+ * @return true if the worklist is empty
+ */
+static bool processWorkList(SegManager *segMan, WorklistManager &wm, const Common::Array<SegmentObj *> &heap, uint budget = 0) {
 	SegmentId stackSegment = segMan->findSegmentByType(SEG_TYPE_STACK);
+	uint marked = 0;
 	while (!wm._worklist.empty()) {
+		if (budget && marked >= budget)
+			return false;
+
 		reg_t reg = wm._worklist.back();
 		wm._worklist.pop_back();
+		++marked;
 		if (reg.getSegment() != stackSegment) { // No need to repeat this one
 			debugC(kDebugLevelGC, "[GC] Checking %04x:%04x", PRINT_REG(reg));
-			if (reg.getSegment() < heap.size() && heap[reg.getSegment()]) {
+			if (reg.getSegment() < heap.size() && heap[reg.getSegment()] && isLiveEntry(heap[reg.getSegment()], reg)) {
 				// Valid heap object? Find its outgoing references!
-				wm.pushArray(heap[reg.getSegment()]->listAllOutgoingReferences(reg));
+				const Common::Array<reg_t> refs = heap[reg.getSegment()]->listAllOutgoingReferences(reg);
+				wm.pushArray(refs);
+				marked += refs.size();
 			}
 		}
 	}
+	return true;
 }
 
-AddrSet *findAllActiveReferences(EngineState *s) {
+static void pushRoots(EngineState *s, WorklistManager &wm) {
 	assert(!s->_executionStack.empty());
 
-	WorklistManager wm;
-
 	// Initialize registers
 	wm.push(s->r_acc);
 	wm.push(s->r_prev);
@@ -170,7 +195,14 @@ AddrSet *findAllActiveReferences(EngineState *s) {
 	}
 
 	debugC(kDebugLevelGC, "[GC] -- Finished explicitly loaded scripts, done with root set");
+}
 
+AddrSet *findAllActiveReferences(EngineState *s) {
+	WorklistManager wm;
+
+	pushRoots(s, wm);
+
+	const Common::Array<SegmentObj *> &heap = s->_segMan->getSegments();
 	processWorkList(s->_segMan, wm, heap);
 
 	if (g_sci->_gfxPorts)
@@ -180,10 +212,151 @@ AddrSet *findAllActiveReferences(EngineState *s) {
 }
 
 void run_gc(EngineState *s) {
-	SegManager *segMan = s->_segMan;
+	s->_segMan->getGC()->collect(s);
+}
+
+GarbageCollector::GarbageCollector(SegManager *segMan) :
+	_segMan(segMan),
+	_incremental(true),
+	_marking(false),
+	_stepSize(kGCStepSize) {
+	resetStats();
+}
+
+void GarbageCollector::collect(EngineState *s) {
+	cancel();
+
+	const uint32 startTime = g_system->getMillis();
 
 	// Some debug stuff
 	debugC(kDebugLevelGC, "[GC] Running...");
+
+	// Compute the set of all segments references currently in use.
+	AddrSet *activeRefs = findAllActiveReferences(s);
+	_stats.freed += sweep(*activeRefs);
+	delete activeRefs;
+
+	++_stats.collections;
+	addPause(g_system->getMillis() - startTime);
+}
+
+void GarbageCollector::start(EngineState *s) {
+	if (!_incremental) {
+		collect(s);
+		return;
+	}
+
+	cancel();
+	debugC(kDebugLevelGC, "[GC] Starting incremental collection");
+	_marking = true;
+	_segMan->setGCMarking(true);
+	pushRoots(s, _wm);
+	step(s);
+}
+
+void GarbageCollector::step(EngineState *s) {
+	if (!_marking)
+		return;
+
+	const uint32 startTime = g_system->getMillis();
+	const bool done = processWorkList(_segMan, _wm, _segMan->getSegments(), _stepSize);
+	const uint32 time = g_system->getMillis() - startTime;
+
+	++_stats.steps;
+	_stats.markTime += time;
+	_stats.maxStepTime = MAX(_stats.maxStepTime, time);
+
+	if (done)
+		finish(s);
+}
+
+void GarbageCollector::finish(EngineState *s) {
+	const uint32 startTime = g_system->getMillis();
+	const Common::Array<SegmentObj *> &heap = _segMan->getSegments();
+
+	// The roots and the objects may have changed since they were marked, so
+	// rescan them, together with the lists, nodes and arrays which were
+	// reported by the write barrier
+	pushRoots(s, _wm);
+
+	Common::Array<reg_t> rescan;
+	for (AddrSet::const_iterator it = _wm._map.begin(); it != _wm._map.end(); ++it) {
+		const SegmentId segment = it->_key.getSegment();
+		if (segment >= heap.size() || !heap[segment])
+			continue;
+
+		const SegmentType type = heap[segment]->getType();
+		if (type == SEG_TYPE_SCRIPT || type == SEG_TYPE_CLONES || type == SEG_TYPE_LOCALS || _dirty.contains(it->_key))
+			rescan.push_back(it->_key);
+	}
+
+	for (uint i = 0; i < rescan.size(); ++i) {
+		const SegmentObj *mobj = heap[rescan[i].getSegment()];
+		if (isLiveEntry(mobj, rescan[i]))
+			_wm.pushArray(mobj->listAllOutgoingReferences(rescan[i]));
+	}
+	_stats.rescanned += rescan.size();
+
+	processWorkList(_segMan, _wm, heap);
+
+	if (g_sci->_gfxPorts)
+		g_sci->_gfxPorts->processEngineHunkList(_wm);
+
+	AddrSet *activeRefs = normalizeAddresses(_segMan, _wm._map);
+	_marking = false;
+	_segMan->setGCMarking(false);
+	_wm._worklist.clear();
+	_wm._map.clear();
+	_dirty.clear();
+
+	_stats.freed += sweep(*activeRefs);
+	delete activeRefs;
+
+	++_stats.cycles;
+	addPause(g_system->getMillis() - startTime);
+	debugC(kDebugLevelGC, "[GC] Finished incremental collection");
+}
+
+void GarbageCollector::cancel() {
+	if (_marking) {
+		debugC(kDebugLevelGC, "[GC] Abandoning incremental collection");
+		++_stats.cancelled;
+	}
+
+	_marking = false;
+	_segMan->setGCMarking(false);
+	_wm._worklist.clear();
+	_wm._map.clear();
+	_dirty.clear();
+}
+
+void GarbageCollector::writeBarrier(reg_t addr) {
+	// Unmarked entries get scanned anyway, if they are still reachable
+	if (_marking && _wm._map.contains(addr) && !_dirty.contains(addr)) {
+		_dirty.setVal(addr, true);
+		++_stats.barriers;
+	}
+}
+
+void GarbageCollector::setIncremental(bool incremental) {
+	if (!incremental)
+		cancel();
+	_incremental = incremental;
+}
+
+void GarbageCollector::resetStats() {
+	memset(&_stats, 0, sizeof(_stats));
+}
+
+void GarbageCollector::addPause(uint32 time) {
+	_stats.pauseTime += time;
+	_stats.maxPauseTime = MAX(_stats.maxPauseTime, time);
+	_stats.lastPauseTime = time;
+}
+
+uint GarbageCollector::sweep(const AddrSet &activeRefs) {
+	uint freed = 0;
+
 #ifdef GC_DEBUG_CODE
 	const char *segnames[SEG_TYPE_MAX + 1];
 	int segcount[SEG_TYPE_MAX + 1];
@@ -191,12 +364,9 @@ void run_gc(EngineState *s) {
 	memset(segcount, 0, sizeof(segcount));
 #endif
 
-	// Compute the set of all segments references currently in use.
-	AddrSet *activeRefs = findAllActiveReferences(s);
-
 	// Iterate over all segments, and check for each whether it
 	// contains stuff that can be collected.
-	const Common::Array<SegmentObj *> &heap = segMan->getSegments();
+	const Common::Array<SegmentObj *> &heap = _segMan->getSegments();
 	for (uint seg = 1; seg < heap.size(); seg++) {
 		SegmentObj *mobj = heap[seg];
 
@@ -211,10 +381,11 @@ void run_gc(EngineState *s) {
 			const Common::Array<reg_t> tmp = mobj->listAllDeallocatable(seg);
 			for (Common::Array<reg_t>::const_iterator it = tmp.begin(); it != tmp.end(); ++it) {
 				const reg_t addr = *it;
-				if (!activeRefs->contains(addr)) {
+				if (!activeRefs.contains(addr)) {
 					// Not found -> we can free it
-					mobj->freeAtAddress(segMan, addr);
+					mobj->freeAtAddress(_segMan, addr);
 					debugC(kDebugLevelGC, "[GC] Deallocating %04x:%04x", PRINT_REG(addr));
+					++freed;
 #ifdef GC_DEBUG_CODE
 					segcount[type]++;
 #endif
@@ -224,8 +395,6 @@ void run_gc(EngineState *s) {
 		}
 	}
 
-	delete activeRefs;
-
 #ifdef GC_DEBUG_CODE
 	// Output debug summary of garbage collection
 	debugC(kDebugLevelGC, "[GC] Summary:");
@@ -233,6 +402,8 @@ void run_gc(EngineState *s) {
 		if (segcount[i])
 			debugC(kDebugLevelGC, "\t%d\t* %s", segcount[i], segnames[i]);
 #endif
+
+	return freed;
 }
 
 } // End of namespace Sci
@@ -50,7 +50,7 @@ typedef Common::HashMap<reg_t, bool, reg_t_Hash> AddrSet;
 AddrSet *findAllActiveReferences(EngineState *s);
 
 /**
- * Runs garbage collection on the current system state
+ * Runs a full garbage collection on the current system state
  * @param s The state in which we should gc
  */
 void run_gc(EngineState *s);
@@ -63,6 +63,86 @@ struct WorklistManager {
 	void pushArray(const Common::Array<reg_t> &tmp);
 };
 
+enum {
+	/** Number of references marked in one step of an incremental collection */
+	kGCStepSize = 2048
+};
+
+struct GCStats {
+	uint32 collections;   ///< Full, stop-the-world collections
+	uint32 cycles;        ///< Finished incremental collections
+	uint32 cancelled;     ///< Incremental collections abandoned by a reset
+	uint32 steps;         ///< Marking steps of incremental collections
+	uint32 freed;         ///< Freed objects, lists, nodes, hunks and arrays
+	uint32 barriers;      ///< Lists, nodes and arrays reported by the write barrier
+	uint32 rescanned;     ///< References rescanned by final passes
+	uint32 markTime;      ///< Time spent in marking steps, in ms
+	uint32 maxStepTime;   ///< Longest marking step, in ms
+	uint32 pauseTime;     ///< Time spent in full collections and final passes, in ms
+	uint32 maxPauseTime;  ///< Longest full collection or final pass, in ms
+	uint32 lastPauseTime; ///< Last full collection or final pass, in ms
+};
+
+/**
+ * Garbage collector which spreads the marking over small steps, done before
+ * kernel calls, so that only the final pass and the sweep stop the game.
+ *
+ * Object properties and locals are written all over the engine, so the
+ * final pass rescans all of the objects, clones and locals which had been
+ * marked, as well as the roots. Lists, nodes and SCI32 arrays are only
+ * reached through the SegManager, which reports them to writeBarrier()
+ * while marking, and only these are rescanned.
+ */
+class GarbageCollector {
+public:
+	GarbageCollector(SegManager *segMan);
+
+	/** Collects all garbage at once, abandoning any incremental collection. */
+	void collect(EngineState *s);
+
+	/**
+	 * Starts an incremental collection, or runs a full one if incremental
+	 * collections are turned off.
+	 */
+	void start(EngineState *s);
+
+	/** Does the next marking step, and finishes the collection after the last one. */
+	void step(EngineState *s);
+
+	/** Abandons the current incremental collection, e.g. when the segments are reset. */
+	void cancel();
+
+	bool isMarking() const { return _marking; }
+
+	/**
+	 * Records that the references of a marked list, node or array may have
+	 * changed, so that the final pass rescans it.
+	 */
+	void writeBarrier(reg_t addr);
+
+	bool isIncremental() const { return _incremental; }
+	void setIncremental(bool incremental);
+	uint getStepSize() const { return _stepSize; }
+	void setStepSize(uint stepSize) { _stepSize = MAX<uint>(stepSize, 1); }
+
+	const GCStats &getStats() const { return _stats; }
+	void resetStats();
+
+private:
+	void finish(EngineState *s);
+	uint sweep(const AddrSet &activeRefs);
+	void addPause(uint32 time);
+
+	SegManager *_segMan;
+	bool _incremental;
+	bool _marking;
+	uint _stepSize;
+
+	WorklistManager _wm;
+	AddrSet _dirty;  ///< Marked lists, nodes and arrays which may have changed
+	GCStats _stats;
+};
+
 
 } // End of namespace Sci
 
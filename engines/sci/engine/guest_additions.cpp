@@ -603,6 +603,7 @@ reg_t GuestAdditions::promptSaveRestoreRama(EngineState *s, int argc, reg_t *arg
 				// We need to touch the save file just so it exists here, since
 				// otherwise the game will not let us save to the new save slot
 				// (it will try to come up with a brand new slot instead)
+				g_sci->getSavegameWriter()->flush();
 				Common::OutSaveFile *out = g_sci->getSaveFileManager()->openForSaving(g_sci->getSavegameName(saveNo));
 				set_savegame_metadata(out, saveGameName, "");
 
@@ -630,6 +631,7 @@ reg_t GuestAdditions::promptSaveRestoreRama(EngineState *s, int argc, reg_t *arg
 				// slot, but ScummVM's GUI does, so force the new name into the
 				// save file metadata if it has changed so it actually makes it
 				// into the save game
+				g_sci->getSavegameWriter()->flush();
 				Common::ScopedPtr<Common::OutSaveFile> out(g_sci->getSaveFileManager()->openForSaving(g_sci->getSavegameName(saveNo)));
 				set_savegame_metadata(out.get(), saveGameName, "");
 				resetCatalogFile = true;
@@ -814,6 +816,7 @@ bool GuestAdditions::restoreFromLauncher() const {
 #endif
 		int savegameId = _state->_delayedRestoreGameId; // delayedRestoreGameId gets destroyed within gamestate_restore()!
 		Common::String fileName = g_sci->getSavegameName(savegameId);
+		g_sci->getSavegameWriter()->flush();
 		Common::SeekableReadStream *in = g_sci->getSaveFileManager()->openForLoading(fileName);
 
 		if (in) {
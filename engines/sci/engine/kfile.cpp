@@ -242,6 +242,7 @@ static bool isSaveCatalogue(const Common::String &name) {
 static bool saveCatalogueExists(const Common::String &name) {
 	bool exists = false;
 	Common::SaveFileManager *saveFileMan = g_sci->getSaveFileManager();
+	g_sci->getSavegameWriter()->flush();
 
 	// There will always be one save game in some games, the "new game"
 	// game, which should be ignored when deciding if there are any save
@@ -460,6 +461,7 @@ reg_t kFileIOOpen(EngineState *s, int argc, reg_t *argv) {
 
 		if (saveNo != -1) {
 			Common::SaveFileManager *saveFileMan = g_sci->getSaveFileManager();
+			g_sci->getSavegameWriter()->flush();
 			const Common::String fileName = g_sci->getSavegameName(saveNo);
 			Common::SeekableReadStream *in = nullptr;
 			Common::OutSaveFile *out = nullptr;
@@ -655,6 +657,7 @@ reg_t kFileIOUnlink(EngineState *s, int argc, reg_t *argv) {
 	Common::String name = s->_segMan->getString(argv[0]);
 	Common::SaveFileManager *saveFileMan = g_sci->getSaveFileManager();
 	bool result;
+	g_sci->getSavegameWriter()->flush();
 
 	// SQ4 floppy prepends /\ to the filenames
 	if (name.hasPrefix("/\\")) {
@@ -810,6 +813,7 @@ reg_t kFileIOExists(EngineState *s, int argc, reg_t *argv) {
 	Common::String name = s->_segMan->getString(argv[0]);
 
 	bool exists = false;
+	g_sci->getSavegameWriter()->flush();
 
 	if (g_sci->getGameId() == GID_PEPPER) {
 		// HACK: Special case for Pepper's Adventure in Time
@@ -936,6 +940,7 @@ reg_t kFileIORename(EngineState *s, int argc, reg_t *argv) {
 
 	// SCI1.1 returns 0 on success and a DOS error code on fail. SCI32
 	// returns -1 on fail. We just return -1 for all versions.
+	g_sci->getSavegameWriter()->flush();
 	if (g_sci->getSaveFileManager()->renameSavefile(oldName, newName, isCompressed))
 		return NULL_REG;
 	else
@@ -955,6 +960,7 @@ reg_t kFileIOCopy(EngineState *s, int argc, reg_t *argv) {
 
 	// SCI1.1 returns 0 on success and a DOS error code on fail. SCI32
 	// returns -1 on fail. We just return -1 for all versions.
+	g_sci->getSavegameWriter()->flush();
 	if (g_sci->getSaveFileManager()->copySavefile(oldName, newName, isCompressed))
 		return NULL_REG;
 	else
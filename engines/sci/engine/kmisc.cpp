@@ -309,6 +309,13 @@ enum {
 	K_MEMORY_POKE					= 6
 };
 
+// Scripts may write into their own code, which then has to be decoded again
+static void invalidateScriptCode(EngineState *s, reg_t dest, uint32 size) {
+	Script *script = s->_segMan->getScriptIfLoaded(dest.getSegment());
+	if (script)
+		script->invalidateDecodedCode(dest.getOffset(), size);
+}
+
 reg_t kMemory(EngineState *s, int argc, reg_t *argv) {
 	switch (argv[0].toUint16()) {
 	case K_MEMORY_ALLOCATE_CRITICAL: {
@@ -353,6 +360,7 @@ reg_t kMemory(EngineState *s, int argc, reg_t *argv) {
 	case K_MEMORY_MEMCPY : {
 		int size = argv[3].toUint16();
 		s->_segMan->memcpy(argv[1], argv[2], size);
+		invalidateScriptCode(s, argv[1], size);
 		break;
 	}
 	case K_MEMORY_PEEK : {
@@ -396,6 +404,7 @@ reg_t kMemory(EngineState *s, int argc, reg_t *argv) {
 				error("Attempt to poke memory at odd offset %04X:%04X", PRINT_REG(argv[1]));
 			*(ref.reg) = argv[2];
 		}
+		invalidateScriptCode(s, argv[1], 2);
 		break;
 	}
 	default:
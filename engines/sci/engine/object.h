@@ -230,6 +230,12 @@ public:
 
 	Selector getVarSelector(uint16 i) const { return _baseVars[i]; }
 
+	/**
+	 * @returns The definition of the object in its script. Clones share it
+	 * with the object they were cloned from.
+	 */
+	const byte *getDefinition() const { return _baseObj.data(); }
+
 	/**
 	 * @returns A pointer to the code for the method at the given index.
 	 */
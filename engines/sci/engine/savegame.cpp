@@ -26,6 +26,8 @@
 #include "common/func.h"
 #include "common/serializer.h"
 #include "common/translation.h"
+#include "common/memstream.h"
+#include "common/zlib.h"
 #include "graphics/thumbnail.h"
 
 #include "sci/sci.h"
@@ -1211,6 +1213,11 @@ bool gamestate_save(EngineState *s, int saveId, const Common::String &savename,
 	Common::SaveFileManager *saveFileMan = g_sci->getSaveFileManager();
 	const Common::String filename = g_sci->getSavegameName(saveId);
 
+	SavegameWriter *writer = g_sci->getSavegameWriter();
+	writer->flush();
+	if (writer->isEnabled())
+		return writer->queue(s, filename, savename, version);
+
 	Common::OutSaveFile *saveStream = saveFileMan->openForSaving(filename);
 	if (saveStream == nullptr) {
 		warning("Error opening savegame \"%s\" for writing", filename.c_str());
@@ -1252,6 +1259,133 @@ bool gamestate_save(EngineState *s, Common::WriteStream *fh, const Common::Strin
 
 extern int showScummVMDialog(const Common::U32String &message, const Common::U32String &altButton = Common::U32String(), bool alignCenter = true);
 
+SavegameWriter::SavegameWriter() :
+	_enabled(true),
+	_failed(false),
+	_snapshot(nullptr),
+	_written(0),
+	_out(nullptr) {
+	resetStats();
+}
+
+SavegameWriter::~SavegameWriter() {
+	flush();
+}
+
+bool SavegameWriter::queue(EngineState *s, const Common::String &filename, const Common::String &savename, const Common::String &version) {
+	assert(!isPending());
+
+	// The save file manager would compress the data as it is written, in one
+	// go, so the file is opened uncompressed and compressed here instead.
+	// The save slot itself is only replaced once the savegame is complete.
+	const Common::String tempFilename = filename + ".tmp";
+	Common::OutSaveFile *saveStream = g_sci->getSaveFileManager()->openForSaving(tempFilename, false);
+	if (saveStream == nullptr) {
+		warning("Error opening savegame \"%s\" for writing", tempFilename.c_str());
+		return false;
+	}
+	Common::WriteStream *out = Common::wrapCompressedWriteStream(saveStream);
+
+	const uint32 start = g_system->getMillis();
+	Common::MemoryWriteStreamDynamic *snapshot = new Common::MemoryWriteStreamDynamic(DisposeAfterUse::YES);
+	if (!gamestate_save(s, snapshot, savename, version)) {
+		warning("Saving the game failed");
+		delete snapshot;
+		out->finalize();
+		delete out;
+		g_sci->getSaveFileManager()->removeSavefile(tempFilename);
+		_stats.failures++;
+		return false;
+	}
+
+	_stats.snapshotTime = g_system->getMillis() - start;
+	_stats.maxSnapshotTime = MAX(_stats.maxSnapshotTime, _stats.snapshotTime);
+	_stats.snapshotSize = snapshot->size();
+	_stats.writeTime = 0;
+	_stats.writeSteps = 0;
+	_filename = filename;
+	_tempFilename = tempFilename;
+	_snapshot = snapshot;
+	_written = 0;
+	_out = out;
+	return true;
+}
+
+void SavegameWriter::update(uint32 deadline) {
+	if (_failed) {
+		// Synchronous saves report this error from SciEngine::saveGameState()
+		_failed = false;
+		showScummVMDialog(_(Common::Error(Common::kWritingFailed).getDesc()));
+	}
+
+	if (!isPending())
+		return;
+
+	const uint32 start = g_system->getMillis();
+	do {
+		writeChunk();
+	} while (isPending() && g_system->getMillis() < deadline);
+
+	_stats.writeTime += g_system->getMillis() - start;
+	_stats.writeSteps++;
+}
+
+void SavegameWriter::flush() {
+	if (!isPending())
+		return;
+
+	const uint32 start = g_system->getMillis();
+	while (isPending())
+		writeChunk();
+
+	_stats.writeTime += g_system->getMillis() - start;
+	_stats.writeSteps++;
+	_stats.flushes++;
+}
+
+void SavegameWriter::resetStats() {
+	memset(&_stats, 0, sizeof(_stats));
+}
+
+void SavegameWriter::writeChunk() {
+	const uint32 size = MIN<uint32>(_snapshot->size() - _written, kSavegameWriteChunkSize);
+	if (_out->write(_snapshot->getData() + _written, size) != size) {
+		finish();
+		return;
+	}
+
+	_written += size;
+	if (_written == (uint32)_snapshot->size())
+		finish();
+}
+
+void SavegameWriter::finish() {
+	Common::SaveFileManager *saveFileMan = g_sci->getSaveFileManager();
+
+	_out->finalize();
+	bool success = !_out->err() && _written == (uint32)_snapshot->size();
+	delete _out;
+	_out = nullptr;
+
+	// The temporary file is compressed already, so the save file manager just
+	// renames it where it can
+	if (success)
+		success = saveFileMan->renameSavefile(_tempFilename, _filename);
+
+	if (success) {
+		_stats.saves++;
+	} else {
+		warning("Writing the savegame \"%s\" failed", _filename.c_str());
+		saveFileMan->removeSavefile(_tempFilename);
+		_stats.failures++;
+		_failed = true;
+	}
+
+	delete _snapshot;
+	_snapshot = nullptr;
+	_written = 0;
+}
+
 void gamestate_afterRestoreFixUp(EngineState *s, int savegameId) {
 	switch (g_sci->getGameId()) {
 	case GID_CAMELOT: {
@@ -1401,6 +1535,8 @@ void gamestate_afterRestoreFixUp(EngineState *s, int savegameId) {
 }
 
 bool gamestate_restore(EngineState *s, int saveId) {
+	g_sci->getSavegameWriter()->flush();
+
 	Common::SaveFileManager *saveFileMan = g_sci->getSaveFileManager();
 	const Common::String filename = g_sci->getSavegameName(saveId);
 	Common::SeekableReadStream *saveStream = saveFileMan->openForLoading(filename);
@@ -28,6 +28,11 @@
 
 #include "sci/sci.h"
 
+namespace Common {
+class MemoryWriteStreamDynamic;
+class WriteStream;
+}
+
 namespace Sci {
 
 struct EngineState;
@@ -146,6 +151,81 @@ bool get_savegame_metadata(Common::SeekableReadStream *stream, SavegameMetadata
 void set_savegame_metadata(Common::Serializer &ser, Common::WriteStream *fh, const Common::String &savename, const Common::String &version);
 void set_savegame_metadata(Common::WriteStream *fh, const Common::String &savename, const Common::String &version);
 
+enum {
+	/** Bytes of a savegame snapshot compressed and written at once */
+	kSavegameWriteChunkSize = 16384
+};
+
+struct SavegameWriterStats {
+	uint32 saves;		// savegames written in the background
+	uint32 flushes;		// savegames which had to be finished right away
+	uint32 failures;	// savegames which could not be written
+	uint32 snapshotTime;	// ms the game stopped for the last snapshot
+	uint32 maxSnapshotTime;
+	uint32 snapshotSize;	// bytes of the last snapshot
+	uint32 writeTime;	// ms spent compressing and writing the last savegame
+	uint32 writeSteps;	// calls it was spread over
+};
+
+/**
+ * Writes savegames in the background. gamestate_save() serializes the game
+ * state into memory, which is quick, and leaves compressing the snapshot and
+ * writing it to the slow save storage to update(), which does a bit of it in
+ * the idle time of every frame.
+ *
+ * The savegame is written to a temporary file, which only replaces the save
+ * slot once it has been written completely, so the previous savegame is kept
+ * if writing fails or ScummVM stops in the meantime. A failed write is
+ * reported to the player from update().
+ *
+ * A savegame must have been written before anything reads or lists the save
+ * files, so all those places call flush() first.
+ */
+class SavegameWriter {
+public:
+	SavegameWriter();
+	~SavegameWriter();
+
+	bool isEnabled() const { return _enabled; }
+	void setEnabled(bool enable) { _enabled = enable; }
+
+	/** Returns true while a savegame is still being written */
+	bool isPending() const { return _out != nullptr; }
+
+	/**
+	 * Takes a snapshot of the game state and opens a temporary save file,
+	 * which is then written by update().
+	 * @return true on success, false otherwise
+	 */
+	bool queue(EngineState *s, const Common::String &filename, const Common::String &savename, const Common::String &version);
+
+	/**
+	 * Writes more of the pending savegame, until the given time. At least one
+	 * chunk gets written, so that the savegame is done eventually. Also tells
+	 * the player about savegames which could not be written.
+	 */
+	void update(uint32 deadline);
+
+	/** Writes the rest of the pending savegame right away */
+	void flush();
+
+	const SavegameWriterStats &getStats() const { return _stats; }
+	void resetStats();
+
+private:
+	void writeChunk();
+	void finish();
+
+	bool _enabled;
+	Common::String _filename;
+	Common::String _tempFilename;
+	bool _failed;		// a savegame failed, and the player has not been told yet
+	Common::MemoryWriteStreamDynamic *_snapshot;
+	uint32 _written;
+	Common::WriteStream *_out;
+	SavegameWriterStats _stats;
+};
+
 } // End of namespace Sci
 
 #endif // SCI_ENGINE_SAVEGAME_H
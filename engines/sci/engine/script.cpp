@@ -73,6 +73,8 @@ void Script::freeScript(const bool keepLocalsSegment) {
 	_offsetLookupObjectCount = 0;
 	_offsetLookupStringCount = 0;
 	_offsetLookupSaidCount = 0;
+
+	invalidateDecodedCode();
 }
 
 enum {
@@ -147,8 +149,10 @@ void Script::load(int script_nr, ResourceManager *resMan, ScriptPatcher *scriptP
 	}
 
 	// Check scripts (+ possibly SCI 1.1 heap) for matching signatures and patch those, if found
-	if (applyScriptPatches)
+	if (applyScriptPatches) {
 		scriptPatcher->processScript(_nr, outBuffer);
+		invalidateDecodedCode();
+	}
 
 	if (getSciVersion() <= SCI_VERSION_1_LATE) {
 		// Some buggy game scripts contain two export tables (e.g. script 912
@@ -1277,4 +1281,110 @@ bool Script::offsetIsObject(uint32 offset) const {
 	return _buf->getUint16SEAt(offset + SCRIPT_OBJECT_MAGIC_OFFSET) == SCRIPT_OBJECT_MAGIC_NUMBER;
 }
 
+static bool isPushImmediate(const byte opcode) {
+	return opcode == op_push0 || opcode == op_push1 || opcode == op_push2 || opcode == op_pushi;
+}
+
+const DecodedInstruction &Script::getDecodedInstruction(uint32 offset) {
+	// Code outside of the script block, and code of huge SCI3 scripts once
+	// the index is full, is decoded on every execution
+	if (offset >= getScriptSize() || _decodedCode.size() >= 0xFFFF) {
+		decodeInstruction(offset, _uncachedInstruction, false);
+		return _uncachedInstruction;
+	}
+
+	if (_decodedIndex.empty())
+		_decodedIndex.resize(getScriptSize());
+
+	uint16 &index = _decodedIndex[offset];
+	if (index) {
+		return _decodedCode[index - 1];
+	}
+
+	_decodedCode.push_back(DecodedInstruction());
+	index = _decodedCode.size();
+	decodeInstruction(offset, _decodedCode.back(), true);
+	return _decodedCode.back();
+}
+
+void Script::decodeInstruction(uint32 offset, DecodedInstruction &instruction, bool cached) {
+	const byte *code = getBuf();
+	const uint32 sendCache = cached ? instruction.sendCache : 0;
+	instruction.size = readPMachineInstruction(code + offset, instruction.extOpcode, instruction.opparams);
+	instruction.superType = kSuperInstructionNone;
+	instruction.superSize = instruction.size;
+	instruction.superCount = 1;
+	instruction.superOperands = 0;
+	instruction.sendCache = 0;
+
+	const byte opcode = instruction.extOpcode >> 1;
+	if (opcode == op_send || opcode == op_self || opcode == op_super) {
+		// Instructions outside of the cache are decoded on every execution,
+		// so they don't get an inline cache either
+		if (sendCache) {
+			instruction.sendCache = sendCache;
+		} else if (cached) {
+			SendCache cache;
+			memset(&cache, 0, sizeof(cache));
+			_sendCaches.push_back(cache);
+			instruction.sendCache = _sendCaches.size();
+		}
+	} else if (isPushImmediate(opcode)) {
+		// Constants pushed in a row, usually the selectors and the arguments
+		// of a send. The largest of these instructions is 3 bytes long.
+		int16 values[kMaxFusedPushes];
+		uint count = 0;
+		uint32 next = offset;
+		while (count < kMaxFusedPushes && next < getScriptSize() && next + 3 <= getBufSize()) {
+			const byte nextOpcode = code[next] >> 1;
+			if (!isPushImmediate(nextOpcode))
+				break;
+
+			byte extOpcode;
+			int16 opparams[4];
+			next += readPMachineInstruction(code + next, extOpcode, opparams);
+			values[count++] = (nextOpcode == op_pushi) ? opparams[0] : (nextOpcode - op_push0);
+		}
+
+		if (count > 1) {
+			instruction.superType = kSuperInstructionPushRun;
+			instruction.superSize = next - offset;
+			instruction.superCount = count;
+			instruction.superOperands = _fusedOperands.size();
+			for (uint i = 0; i < count; ++i)
+				_fusedOperands.push_back(values[i]);
+		}
+	} else if (opcode == op_ldi) {
+		const uint32 next = offset + instruction.size;
+		if (next < getScriptSize() && (code[next] >> 1) == op_push) {
+			instruction.superType = kSuperInstructionLoadPush;
+			instruction.superSize = instruction.size + 1;
+			instruction.superCount = 2;
+		}
+	}
+}
+
+void Script::invalidateDecodedCode() {
+	_decodedIndex.clear();
+	_decodedCode.clear();
+	_fusedOperands.clear();
+	_sendCaches.clear();
+}
+
+void Script::invalidateDecodedCode(uint32 offset, uint32 size) {
+	if (offset >= _decodedIndex.size())
+		return;
+
+	// Instructions starting before the written bytes may still span them,
+	// the longest ones being runs of fused pushes
+	const uint32 maxSize = kMaxFusedPushes * 3;
+	const uint32 start = (offset > maxSize) ? offset - maxSize : 0;
+	const uint32 end = MIN<uint32>(offset + size, _decodedIndex.size());
+	for (uint32 i = start; i < end; ++i) {
+		const uint16 index = _decodedIndex[i];
+		if (index && i + _decodedCode[index - 1].superSize > offset)
+			decodeInstruction(i, _decodedCode[index - 1], true);
+	}
+}
+
 } // End of namespace Sci
@@ -69,6 +69,37 @@ struct offsetLookupArrayEntry {
 
 typedef Common::Array<offsetLookupArrayEntry> offsetLookupArrayType;
 
+/**
+ * Superinstructions, i.e. frequent sequences of instructions which the VM
+ * executes in one step.
+ */
+enum SuperInstructionType {
+	kSuperInstructionNone = 0,
+	kSuperInstructionPushRun,  ///< push0, push1, push2 and pushi in a row
+	kSuperInstructionLoadPush  ///< ldi followed by push
+};
+
+enum {
+	/** Maximum number of pushes fused into one superinstruction */
+	kMaxFusedPushes = 16
+};
+
+/**
+ * A PMachine instruction, as decoded by readPMachineInstruction().
+ */
+struct DecodedInstruction {
+	int16 opparams[4];
+	uint16 size;     ///< Size of the instruction in bytes
+	byte extOpcode;  ///< "Extended" opcode, with the low bit
+
+	byte superType;  ///< SuperInstructionType starting at this instruction
+	uint16 superSize;  ///< Size of the whole sequence in bytes
+	uint16 superCount; ///< Number of instructions in the sequence
+	uint32 superOperands; ///< Index of the pushed values, for push runs
+
+	uint32 sendCache; ///< Index of the inline cache of sends, plus one
+};
+
 class Script : public SegmentObj {
 private:
 	int _nr; /**< Script number */
@@ -94,6 +125,16 @@ private:
 
 	ObjMap _objects;	/**< Table for objects, contains property variables */
 
+	/**
+	 * Indexes of the decoded instructions plus one, by offset within the
+	 * script. 0 marks offsets which have not been executed yet.
+	 */
+	Common::Array<uint16> _decodedIndex;
+	Common::Array<DecodedInstruction> _decodedCode;
+	Common::Array<int16> _fusedOperands; /**< Values pushed by push runs */
+	DecodedInstruction _uncachedInstruction;
+	Common::Array<SendCache> _sendCaches; /**< Inline caches of the sends */
+
 protected:
 	offsetLookupArrayType _offsetLookupArray; // Table of all elements of currently loaded script, that may get pointed to
 
@@ -128,6 +169,33 @@ public:
 	const ObjMap &getObjectMap() const { return _objects; }
 	bool offsetIsObject(uint32 offset) const;
 
+	/**
+	 * Returns the instruction at the given offset, decoding it on its first
+	 * execution. The returned reference is only valid until the next call.
+	 */
+	const DecodedInstruction &getDecodedInstruction(uint32 offset);
+	const int16 *getFusedOperands(uint32 index) const { return &_fusedOperands[index]; }
+
+	/**
+	 * Drops the decoded instructions. Needed whenever the code of the script
+	 * changes, e.g. after script patches were applied.
+	 */
+	void invalidateDecodedCode();
+
+	/**
+	 * Decodes again the instructions overlapping the given bytes, after the
+	 * game scripts wrote into them.
+	 */
+	void invalidateDecodedCode(uint32 offset, uint32 size);
+	uint32 getDecodedCount() const { return _decodedCode.size(); }
+
+	/**
+	 * Returns the inline cache of a send instruction, or NULL. The pointer
+	 * is valid until the next instruction of this script gets decoded.
+	 */
+	SendCache *getSendCache(uint32 index) { return index ? &_sendCaches[index - 1] : NULL; }
+	const Common::Array<SendCache> &getSendCaches() const { return _sendCaches; }
+
 public:
 	Script();
 	~Script() override;
@@ -355,6 +423,13 @@ private:
 
 	LocalVariables *allocLocalsSegment(SegManager *segMan);
 
+	/**
+	 * Decodes the instruction at the given offset, and the superinstruction
+	 * which starts with it, if any. Sends of cached instructions get an
+	 * inline cache.
+	 */
+	void decodeInstruction(uint32 offset, DecodedInstruction &instruction, bool cached);
+
 	/**
 	 * Identifies certain offsets within script data and set up lookup-table
 	 */
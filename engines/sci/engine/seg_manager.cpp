@@ -21,7 +21,10 @@
  */
 
 #include "sci/sci.h"
+#include "sci/engine/gc.h"
+#include "sci/engine/kernel.h"
 #include "sci/engine/seg_manager.h"
+#include "sci/engine/selector.h"
 #include "sci/engine/state.h"
 #include "sci/engine/script.h"
 #ifdef ENABLE_SCI32
@@ -33,6 +36,9 @@ namespace Sci {
 
 SegManager::SegManager(ResourceManager *resMan, ScriptPatcher *scriptPatcher)
 	: _resMan(resMan), _scriptPatcher(scriptPatcher) {
+	_gcMarking = false;
+	_gc = new GarbageCollector(this);
+
 	_heap.push_back(0);
 
 	_clonesSegId = 0;
@@ -48,14 +54,23 @@ SegManager::SegManager(ResourceManager *resMan, ScriptPatcher *scriptPatcher)
 	_bitmapSegId = 0;
 #endif
 
+	// Caches start with epoch 0, so they are stale until first used
+	_sendCacheEpoch = 1;
+	_sendCacheEnabled = true;
+	resetSendCacheStats();
+
 	createClassTable();
 }
 
 SegManager::~SegManager() {
 	resetSegMan();
+	delete _gc;
 }
 
 void SegManager::resetSegMan() {
+	// Marked references are meaningless for the new segments
+	_gc->cancel();
+
 	// Free memory
 	for (uint i = 0; i < _heap.size(); i++) {
 		if (_heap[i])
@@ -167,6 +182,7 @@ void SegManager::deallocate(SegmentId seg) {
 	if (mobj->getType() == SEG_TYPE_SCRIPT) {
 		Script *scr = (Script *)mobj;
 		_scriptSegMap.erase(scr->getScriptNumber());
+		invalidateSendCaches();
 		if (scr->getLocalsSegment()) {
 			// Check if the locals segment has already been deallocated.
 			// If the locals block has been stored in a segment with an ID
@@ -196,6 +212,26 @@ void SegManager::deallocateScript(int script_nr) {
 	deallocate(getScriptSegment(script_nr));
 }
 
+void SegManager::recordGCWrite(reg_t addr) {
+	_gc->writeBarrier(addr);
+}
+
+void SegManager::invalidateSendCaches() {
+	// Skip 0, which marks caches that have never been used
+	if (++_sendCacheEpoch == 0)
+		_sendCacheEpoch = 1;
+	_sendCacheStats.invalidations++;
+}
+
+void SegManager::setSendCacheEnabled(bool enabled) {
+	_sendCacheEnabled = enabled;
+	invalidateSendCaches();
+}
+
+void SegManager::resetSendCacheStats() {
+	memset(&_sendCacheStats, 0, sizeof(_sendCacheStats));
+}
+
 Script *SegManager::getScript(const SegmentId seg) {
 	SegmentId actualSegment = getActualSegment(seg);
 	if (actualSegment < 1 || (uint)actualSegment >= _heap.size()) {
@@ -505,6 +541,7 @@ List *SegManager::allocateList(reg_t *addr) {
 	offset = table->allocEntry();
 
 	*addr = make_reg(_listsSegId, offset);
+	writeBarrier(*addr);
 	return &table->at(offset);
 }
 
@@ -519,6 +556,7 @@ Node *SegManager::allocateNode(reg_t *addr) {
 	offset = table->allocEntry();
 
 	*addr = make_reg(_nodesSegId, offset);
+	writeBarrier(*addr);
 	return &table->at(offset);
 }
 
@@ -545,6 +583,7 @@ List *SegManager::lookupList(reg_t addr) {
 		return NULL;
 	}
 
+	writeBarrier(addr);
 	return &(lt[addr.getOffset()]);
 }
 
@@ -569,6 +608,7 @@ Node *SegManager::lookupNode(reg_t addr, bool stopOnDiscarded) {
 		return NULL;
 	}
 
+	writeBarrier(addr);
 	return &(nt[addr.getOffset()]);
 }
 
@@ -582,6 +622,10 @@ SegmentRef SegManager::dereference(reg_t pointer) {
 	}
 
 	SegmentObj *mobj = _heap[pointer.getSegment()];
+#ifdef ENABLE_SCI32
+	if (mobj->getType() == SEG_TYPE_ARRAY)
+		writeBarrier(pointer);
+#endif
 	return mobj->dereference(pointer);
 }
 
@@ -946,6 +990,7 @@ SciArray *SegManager::allocateArray(SciArrayType type, uint16 size, reg_t *addr)
 	offset = table->allocEntry();
 
 	*addr = make_reg(_arraysSegId, offset);
+	writeBarrier(*addr);
 
 	SciArray *array = &table->at(offset);
 	array->setType(type);
@@ -962,6 +1007,7 @@ SciArray *SegManager::lookupArray(reg_t addr) {
 	if (!arrayTable.isValidEntry(addr.getOffset()))
 		error("Attempt to use non-array %04x:%04x as array", PRINT_REG(addr));
 
+	writeBarrier(addr);
 	return &(arrayTable[addr.getOffset()]);
 }
 
@@ -1088,6 +1134,7 @@ int SegManager::instantiateScript(int scriptNum, bool applyScriptPatches) {
 			return segmentId;
 		} else {
 			scr->freeScript(true);
+			invalidateSendCaches();
 		}
 	} else {
 		scr = allocateScript(scriptNum, &segmentId);
@@ -1100,10 +1147,48 @@ int SegManager::instantiateScript(int scriptNum, bool applyScriptPatches) {
 #ifdef ENABLE_SCI32
 	g_sci->_guestAdditions->instantiateScriptHook(*scr);
 #endif
+	queueScriptResources(*scr);
 
 	return segmentId;
 }
 
+void SegManager::queueScriptResources(const Script &script) {
+	// Selectors are not mapped yet while the kernel loads the scripts it
+	// needs to find them
+	if (!_resMan->isPrefetchEnabled() || !g_sci->getKernel() || SELECTOR(view) <= 0)
+		return;
+
+	const uint16 scriptNr = script.getScriptNumber();
+	_resMan->queuePrefetch(ResourceId(kResourceTypePic, scriptNr));
+	_resMan->queuePrefetch(ResourceId(kResourceTypeMessage, scriptNr));
+
+	const struct {
+		Selector selector;
+		ResourceType type;
+	} references[] = {
+		{ SELECTOR(view),    kResourceTypeView },
+		{ SELECTOR(picture), kResourceTypePic },
+		{ SELECTOR(number),  kResourceTypeSound }
+	};
+
+	const ObjMap &objects = script.getObjectMap();
+	for (ObjMap::const_iterator it = objects.begin(); it != objects.end(); ++it) {
+		const Object &obj = it->_value;
+		for (int i = 0; i < ARRAYSIZE(references); ++i) {
+			if (references[i].selector <= 0)
+				continue;
+
+			const int index = obj.locateVarSelector(this, references[i].selector);
+			if (index < 0)
+				continue;
+
+			const reg_t value = obj.getVariable(index);
+			if (value.isNumber())
+				_resMan->queuePrefetch(ResourceId(references[i].type, value.toUint16()));
+		}
+	}
+}
+
 void SegManager::uninstantiateScript(int script_nr) {
 	SegmentId segmentId = getScriptSegment(script_nr);
 	Script *scr = getScriptIfLoaded(segmentId);
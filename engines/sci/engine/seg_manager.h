@@ -45,6 +45,7 @@ enum ScriptLoadType {
 };
 
 class Script;
+class GarbageCollector;
 
 class SegManager : public Common::Serializable {
 	friend class Console;
@@ -128,6 +129,14 @@ public:
 private:
 	void uninstantiateScriptSci0(int script_nr);
 
+	/**
+	 * Queues the resources which a newly loaded script refers to for
+	 * prefetching: the views, pictures and sounds set in the properties of
+	 * its objects, and the picture and messages with the script's number,
+	 * which rooms usually use.
+	 */
+	void queueScriptResources(const Script &script);
+
 public:
 	// TODO: document this
 	reg_t getClassAddress(int classnr, ScriptLoadType lock, uint16 callerSegment, bool applyScriptPatches = true);
@@ -463,6 +472,31 @@ public:
 
 	const Common::Array<SegmentObj *> &getSegments() const { return _heap; }
 
+	/**
+	 * The inline caches of the sends are only valid for this epoch. It
+	 * changes whenever a script is unloaded, as the cached definitions and
+	 * methods may belong to it.
+	 */
+	uint32 getSendCacheEpoch() const { return _sendCacheEpoch; }
+	void invalidateSendCaches();
+	bool isSendCacheEnabled() const { return _sendCacheEnabled; }
+	void setSendCacheEnabled(bool enabled);
+	SendCacheStats &getSendCacheStats() { return _sendCacheStats; }
+	void resetSendCacheStats();
+
+	GarbageCollector *getGC() { return _gc; }
+	void setGCMarking(bool marking) { _gcMarking = marking; }
+
+	/**
+	 * Tells the incremental garbage collector that the references in the
+	 * given list, node or array may change. Every lookup of these goes
+	 * through here, as callers may write through the returned pointers.
+	 */
+	void writeBarrier(reg_t addr) {
+		if (_gcMarking)
+			recordGCWrite(addr);
+	}
+
 private:
 	Common::Array<SegmentObj *> _heap;
 	Common::Array<Class> _classTable; /**< Table of all classes */
@@ -486,11 +520,19 @@ private:
 	SegmentId _bitmapSegId;
 #endif
 
+	GarbageCollector *_gc;
+	bool _gcMarking; ///< Whether the collector is marking incrementally
+
+	uint32 _sendCacheEpoch;
+	bool _sendCacheEnabled;
+	SendCacheStats _sendCacheStats;
+
 public:
 	SegmentObj *allocSegment(SegmentObj *mem, SegmentId *segid);
 
 private:
 	void deallocate(SegmentId seg);
+	void recordGCWrite(reg_t addr);
 	void createClassTable();
 
 	SegmentId findFreeSegment() const;
@@ -371,4 +371,66 @@ SelectorType lookupSelector(SegManager *segMan, reg_t obj_location, Selector sel
 //	return _lookupSelector_function(segMan, obj, selectorId, fptr);
 }
 
+SelectorType lookupSelectorCached(SegManager *segMan, SendCache &cache, reg_t obj_location, Selector selectorId, ObjVarRef *varp, reg_t *fptr) {
+	const Object *obj = segMan->getObject(obj_location);
+	if (!obj || !segMan->isSendCacheEnabled())
+		return lookupSelector(segMan, obj_location, selectorId, varp, fptr);
+
+	SendCacheStats &stats = segMan->getSendCacheStats();
+	if (cache.epoch != segMan->getSendCacheEpoch()) {
+		cache.epoch = segMan->getSendCacheEpoch();
+		cache.count = 0;
+	}
+
+	const byte *definition = obj->getDefinition();
+	const reg_t superClass = obj->getSuperClassSelector();
+	// Clones keep the position of the object they were cloned from
+	const reg_t methodOwner = obj->getMethodCount() ? obj->getPos() : NULL_REG;
+	const uint32 count = MIN<uint32>(cache.count, kSendCacheEntries);
+	for (uint32 i = 0; i < count; ++i) {
+		const SendCache::Entry &entry = cache.entries[i];
+		if (entry.definition == definition && entry.selector == selectorId &&
+			entry.superClass == superClass && entry.methodOwner == methodOwner) {
+			++stats.hits;
+			if (entry.selectorType == kSelectorVariable) {
+				if (varp) {
+					varp->obj = obj_location;
+					varp->varindex = entry.varIndex;
+				}
+			} else if (fptr) {
+				*fptr = entry.method;
+			}
+			return entry.selectorType;
+		}
+	}
+
+	++stats.misses;
+	ObjVarRef var;
+	reg_t method = NULL_REG;
+	const SelectorType selectorType = lookupSelector(segMan, obj_location, selectorId, &var, &method);
+	if (selectorType == kSelectorNone)
+		return selectorType;
+
+	// Sends to more receiver types than the cache holds replace the entries
+	// in turn
+	if (cache.count >= kSendCacheEntries)
+		++stats.evictions;
+	SendCache::Entry &entry = cache.entries[cache.count++ % kSendCacheEntries];
+	entry.definition = definition;
+	entry.superClass = superClass;
+	entry.methodOwner = methodOwner;
+	entry.selector = selectorId;
+	entry.selectorType = selectorType;
+	entry.varIndex = var.varindex;
+	entry.method = method;
+
+	if (selectorType == kSelectorVariable) {
+		if (varp)
+			*varp = var;
+	} else if (fptr) {
+		*fptr = method;
+	}
+	return selectorType;
+}
+
 } // End of namespace Sci
@@ -262,7 +262,7 @@ static void _exec_varselectors(EngineState *s) {
 }
 
 
-ExecStack *send_selector(EngineState *s, reg_t send_obj, reg_t work_obj, StackPtr sp, int framesize, StackPtr argp) {
+ExecStack *send_selector(EngineState *s, reg_t send_obj, reg_t work_obj, StackPtr sp, int framesize, StackPtr argp, SendCache *cache) {
 	// send_obj and work_obj are equal for anything but 'super'
 	// Returns a pointer to the TOS exec_stack element
 	assert(s);
@@ -288,7 +288,9 @@ ExecStack *send_selector(EngineState *s, reg_t send_obj, reg_t work_obj, StackPt
 		g_sci->_guestAdditions->sendSelectorHook(send_obj, selector, argp);
 #endif
 
-		SelectorType selectorType = lookupSelector(s->_segMan, send_obj, selector, &varp, &funcp);
+		SelectorType selectorType = cache ?
+			lookupSelectorCached(s->_segMan, *cache, send_obj, selector, &varp, &funcp) :
+			lookupSelector(s->_segMan, send_obj, selector, &varp, &funcp);
 		if (selectorType == kSelectorNone)
 			error("Send to invalid selector 0x%x (%s) of object at %04x:%04x", 0xffff & selector, g_sci->getKernel()->getSelectorName(0xffff & selector).c_str(), PRINT_REG(send_obj));
 
@@ -657,10 +659,44 @@ void run_vm(EngineState *s) {
 			error("run_vm(): program counter gone astray, addr: %d, code buffer size: %d",
 			s->xs->addr.pc.getOffset(), scr->getBufSize());
 
-		// Get opcode
-		byte extOpcode;
-		s->xs->addr.pc.incOffset(readPMachineInstruction(scr->getBuf(s->xs->addr.pc.getOffset()), extOpcode, opparams));
+		// Get opcode, decoded on the first execution of the instruction
+		const DecodedInstruction &instruction = scr->getDecodedInstruction(s->xs->addr.pc.getOffset());
+		const byte extOpcode = instruction.extOpcode;
 		const byte opcode = extOpcode >> 1;
+		memcpy(opparams, instruction.opparams, sizeof(opparams));
+		const uint32 sendCache = instruction.sendCache;
+
+		OpcodeProfile *profile = g_sci->_debugState.opcodeProfile;
+		if (profile) {
+			++profile->opcodes[opcode];
+			if (profile->lastOpcode >= 0)
+				++profile->pairs[profile->lastOpcode][opcode];
+			profile->lastOpcode = opcode;
+			if (instruction.superType == kSuperInstructionPushRun)
+				++profile->pushRuns;
+			else if (instruction.superType == kSuperInstructionLoadPush)
+				++profile->loadPushes;
+		} else if (instruction.superType != kSuperInstructionNone && !g_sci->_debugState.debugging &&
+				!(g_sci->_debugState._activeBreakpointTypes & BREAK_ADDRESS)) {
+			// Run the whole sequence at once. This is skipped while debugging,
+			// so that every instruction can still be stepped through, and while
+			// profiling, so that every instruction gets counted.
+			s->xs->addr.pc.incOffset(instruction.superSize);
+			if (instruction.superType == kSuperInstructionPushRun) {
+				const int16 *values = scr->getFusedOperands(instruction.superOperands);
+				validate_stack_addr(s, s->xs->sp + instruction.superCount - 1);
+				for (uint i = 0; i < instruction.superCount; ++i)
+					*(s->xs->sp++) = make_reg(0, values[i]);
+			} else {
+				// ldi, push
+				s->r_acc = make_reg(0, opparams[0]);
+				PUSH32(s->r_acc);
+			}
+			s->scriptStepCounter += instruction.superCount;
+			continue;
+		}
+
+		s->xs->addr.pc.incOffset(instruction.size);
 		//debug("%s: %d, %d, %d, %d, acc = %04x:%04x, script %d, local script %d", opcodeNames[opcode], opparams[0], opparams[1], opparams[2], opparams[3], PRINT_REG(s->r_acc), scr->getScriptNumber(), local_script->getScriptNumber());
 
 #ifdef ABORT_ON_INFINITE_LOOP
@@ -882,10 +918,14 @@ void run_vm(EngineState *s) {
 		}
 
 		case op_callk: { // 0x21 (33)
-			// Run the garbage collector, if needed
-			if (s->gcCountDown-- <= 0) {
+			// Run the garbage collector, if needed. Incremental collections
+			// mark a few references before every kernel call, until done.
+			GarbageCollector *gc = s->_segMan->getGC();
+			if (gc->isMarking()) {
+				gc->step(s);
+			} else if (s->gcCountDown-- <= 0) {
 				s->gcCountDown = s->scriptGCInterval;
-				run_gc(s);
+				gc->start(s);
 			}
 
 			// Call kernel function
@@ -1000,7 +1040,8 @@ void run_vm(EngineState *s) {
 
 			s->xs->sp[1].incOffset(s->r_rest);
 			xs_new = send_selector(s, s->r_acc, s->r_acc, s_temp,
-									(int)(opparams[0] >> 1) + (uint16)s->r_rest, s->xs->sp);
+									(int)(opparams[0] >> 1) + (uint16)s->r_rest, s->xs->sp,
+									scr->getSendCache(sendCache));
 
 			if (xs_new && xs_new != s->xs)
 				s->_executionStackPosChanged = true;
@@ -1047,7 +1088,7 @@ void run_vm(EngineState *s) {
 			s->xs->sp[1].incOffset(s->r_rest);
 			xs_new = send_selector(s, s->xs->objp, s->xs->objp,
 									s_temp, (int)(opparams[0] >> 1) + (uint16)s->r_rest,
-									s->xs->sp);
+									s->xs->sp, scr->getSendCache(sendCache));
 
 			if (xs_new && xs_new != s->xs)
 				s->_executionStackPosChanged = true;
@@ -1076,7 +1117,7 @@ void run_vm(EngineState *s) {
 				s->xs->sp[1].incOffset(s->r_rest);
 				xs_new = send_selector(s, r_temp, s->xs->objp, s_temp,
 										(int)(opparams[1] >> 1) + (uint16)s->r_rest,
-										s->xs->sp);
+										s->xs->sp, scr->getSendCache(sendCache));
 
 				if (xs_new && xs_new != s->xs)
 					s->_executionStackPosChanged = true;
@@ -57,6 +57,42 @@ enum SelectorType {
 	kSelectorMethod
 };
 
+enum {
+	/** Number of lookups remembered by the inline cache of a send */
+	kSendCacheEntries = 4
+};
+
+/**
+ * Inline cache of the selector lookups done by one send instruction. The
+ * lookups are remembered by selector and type of the receiver. Receivers
+ * have the same type when they share their definition, superclass and
+ * methods. Every object has its own method table, so objects defining
+ * methods only share a type with their clones, while instances without
+ * methods of their own share it with the other instances of their class.
+ */
+struct SendCache {
+	struct Entry {
+		const byte *definition;
+		reg_t superClass;
+		reg_t methodOwner; ///< Object the receiver's methods come from, if it has any
+		Selector selector;
+		SelectorType selectorType;
+		int varIndex;   ///< Index of a variable selector
+		reg_t method;   ///< Address of a method selector
+	};
+
+	uint32 epoch;  ///< The entries are stale if this isn't the SegManager's epoch
+	uint32 count;  ///< Number of lookups cached so far, may exceed kSendCacheEntries
+	Entry entries[kSendCacheEntries];
+};
+
+struct SendCacheStats {
+	uint32 hits;
+	uint32 misses;
+	uint32 evictions;     ///< Entries replaced by sends to more receiver types
+	uint32 invalidations; ///< Flushes of all caches, when scripts are unloaded
+};
+
 struct Class {
 	int script; ///< number of the script the class is in, -1 for non-existing
 	reg_t reg; ///< offset; script-relative offset, segment: 0 if not instantiated
@@ -357,10 +393,11 @@ ExecStack *execute_method(EngineState *s, uint16 script, uint16 pubfunct,
  * 						[selector_number][argument_counter] and then
  * 						"argument_counter" word entries with the
  * 						parameter values.
+ * @param[in] cache		Inline cache of the send instruction, or NULL
  * @return				A pointer to the new execution stack TOS entry
  */
 ExecStack *send_selector(EngineState *s, reg_t send_obj, reg_t work_obj,
-	StackPtr sp, int framesize, StackPtr argp);
+	StackPtr sp, int framesize, StackPtr argp, SendCache *cache = NULL);
 
 
 /**
@@ -400,6 +437,13 @@ void script_debug(EngineState *s);
 SelectorType lookupSelector(SegManager *segMan, reg_t obj, Selector selectorid,
 		ObjVarRef *varp, reg_t *fptr);
 
+/**
+ * Same as lookupSelector(), but looks the selector up in the given inline
+ * cache first, and adds it to the cache if it was not there.
+ */
+SelectorType lookupSelectorCached(SegManager *segMan, SendCache &cache,
+		reg_t obj, Selector selectorid, ObjVarRef *varp, reg_t *fptr);
+
 /**
  * Read a PMachine instruction from a memory buffer and return its length.
  *
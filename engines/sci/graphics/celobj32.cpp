@@ -20,6 +20,15 @@
  *
  */
 
+#if defined(__SSE2__)
+#define USE_SSE2_CEL_ROWS
+#include <emmintrin.h>
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#define USE_NEON_CEL_ROWS
+#include <arm_neon.h>
+#endif
+
+#include "sci/console.h"
 #include "sci/resource/resource.h"
 #include "sci/engine/features.h"
 #include "sci/engine/seg_manager.h"
@@ -34,6 +43,7 @@
 #include "graphics/larryScale.h"
 #include "common/config-manager.h"
 #include "common/gui_options.h"
+#include "common/system.h"
 
 namespace Sci {
 #pragma mark CelScaler
@@ -85,13 +95,16 @@ const CelScalerTable &CelScaler::getScalerTable(const Ratio &scaleX, const Ratio
 #pragma mark -
 #pragma mark CelObj
 bool CelObj::_drawBlackLines = false;
+bool CelObj::_rowRendering = true;
 
 void CelObj::init() {
 	CelObj::deinit();
 	_drawBlackLines = false;
+	_rowRendering = true;
 	_nextCacheId = 1;
 	_scaler = new CelScaler();
 	_cache = new CelCache(100);
+	_pixelCache = new CelPixelCache(kCelPixelCacheSize);
 }
 
 void CelObj::deinit() {
@@ -99,6 +112,91 @@ void CelObj::deinit() {
 	_scaler = nullptr;
 	delete _cache;
 	_cache = nullptr;
+	delete _pixelCache;
+	_pixelCache = nullptr;
+}
+
+#pragma mark -
+#pragma mark CelObj - Row kernels
+
+// The row kernels process 16 pixels at a time and leave the remaining pixels
+// of a row to the per-pixel code. Rows of cels are read from resources and
+// row buffers, so the loads are unaligned.
+#if defined(USE_SSE2_CEL_ROWS)
+#define USE_SIMD_CEL_ROWS
+
+typedef __m128i CelRowVec;
+
+inline CelRowVec rowLoad(const byte *p) { return _mm_loadu_si128((const __m128i *)p); }
+inline void rowStore(byte *p, CelRowVec v) { _mm_storeu_si128((__m128i *)p, v); }
+inline CelRowVec rowSet(byte x) { return _mm_set1_epi8((char)x); }
+inline CelRowVec rowEq(CelRowVec a, CelRowVec b) { return _mm_cmpeq_epi8(a, b); }
+inline CelRowVec rowOr(CelRowVec a, CelRowVec b) { return _mm_or_si128(a, b); }
+inline CelRowVec rowXor(CelRowVec a, CelRowVec b) { return _mm_xor_si128(a, b); }
+// ~a & b
+inline CelRowVec rowAndNot(CelRowVec a, CelRowVec b) { return _mm_andnot_si128(a, b); }
+inline CelRowVec rowSelect(CelRowVec mask, CelRowVec a, CelRowVec b) { return _mm_or_si128(_mm_and_si128(mask, a), _mm_andnot_si128(mask, b)); }
+inline bool rowAny(CelRowVec mask) { return _mm_movemask_epi8(mask) != 0; }
+
+// a >= b, unsigned; SSE2 has no unsigned byte comparisons
+inline CelRowVec rowAtLeast(CelRowVec a, CelRowVec b) { return _mm_cmpeq_epi8(_mm_subs_epu8(b, a), _mm_setzero_si128()); }
+
+inline CelRowVec rowReverse(CelRowVec v) {
+	v = _mm_shuffle_epi32(v, _MM_SHUFFLE(0, 1, 2, 3));
+	v = _mm_shufflelo_epi16(v, _MM_SHUFFLE(2, 3, 0, 1));
+	v = _mm_shufflehi_epi16(v, _MM_SHUFFLE(2, 3, 0, 1));
+	return _mm_or_si128(_mm_slli_epi16(v, 8), _mm_srli_epi16(v, 8));
+}
+
+#elif defined(USE_NEON_CEL_ROWS)
+#define USE_SIMD_CEL_ROWS
+
+typedef uint8x16_t CelRowVec;
+
+inline CelRowVec rowLoad(const byte *p) { return vld1q_u8(p); }
+inline void rowStore(byte *p, CelRowVec v) { vst1q_u8(p, v); }
+inline CelRowVec rowSet(byte x) { return vdupq_n_u8(x); }
+inline CelRowVec rowEq(CelRowVec a, CelRowVec b) { return vceqq_u8(a, b); }
+inline CelRowVec rowOr(CelRowVec a, CelRowVec b) { return vorrq_u8(a, b); }
+inline CelRowVec rowXor(CelRowVec a, CelRowVec b) { return veorq_u8(a, b); }
+inline CelRowVec rowAndNot(CelRowVec a, CelRowVec b) { return vbicq_u8(b, a); }
+inline CelRowVec rowSelect(CelRowVec mask, CelRowVec a, CelRowVec b) { return vbslq_u8(mask, a, b); }
+inline CelRowVec rowAtLeast(CelRowVec a, CelRowVec b) { return vcgeq_u8(a, b); }
+
+inline bool rowAny(CelRowVec mask) {
+	const uint64x2_t m = vreinterpretq_u64_u8(mask);
+	return (vgetq_lane_u64(m, 0) | vgetq_lane_u64(m, 1)) != 0;
+}
+
+inline CelRowVec rowReverse(CelRowVec v) {
+	v = vrev64q_u8(v);
+	return vcombine_u8(vget_high_u8(v), vget_low_u8(v));
+}
+
+#endif
+
+#ifdef USE_SIMD_CEL_ROWS
+/**
+ * translateMacColor for 16 pixels: swaps colors 0 and 255.
+ */
+inline CelRowVec rowTranslateMacColor(CelRowVec pixels) {
+	return rowXor(pixels, rowOr(rowEq(pixels, rowSet(0)), rowEq(pixels, rowSet(255))));
+}
+#endif
+
+/**
+ * Copies `width` pixels from `source` to `target` in reverse order.
+ */
+inline void reverseRow(byte *target, const byte *source, const int16 width) {
+	int16 x = 0;
+#ifdef USE_SIMD_CEL_ROWS
+	for (; x + 16 <= width; x += 16) {
+		rowStore(target + x, rowReverse(rowLoad(source + width - 16 - x)));
+	}
+#endif
+	for (; x < width; ++x) {
+		target[x] = source[width - 1 - x];
+	}
 }
 
 #pragma mark -
@@ -149,6 +247,24 @@ struct SCALER_NoScale {
 			return *_row++;
 		}
 	}
+
+	/**
+	 * Reads the next `width` pixels. Unflipped rows are read in place; flipped
+	 * rows are reversed into `buffer`.
+	 */
+	inline const byte *readRow(byte *buffer, const int16 width) {
+		if (FLIP) {
+			assert(_row - width >= _rowEdge);
+			reverseRow(buffer, _row - width + 1, width);
+			_row -= width;
+			return buffer;
+		} else {
+			assert(_row + width <= _rowEdge);
+			const byte *row = _row;
+			_row += width;
+			return row;
+		}
+	}
 };
 
 template<bool FLIP, typename READER>
@@ -305,6 +421,20 @@ struct SCALER_Scale {
 		assert(_x >= _minX && _x <= _maxX);
 		return _row[_valuesX[_x++]];
 	}
+
+	/**
+	 * Reads the next `width` scaled pixels into `buffer`. SSE2 and NEON have
+	 * no byte gather, so this stays a plain table lookup.
+	 */
+	inline const byte *readRow(byte *buffer, const int16 width) {
+		assert(_x >= _minX && _x + width - 1 <= _maxX);
+		const int16 *valuesX = _valuesX + _x;
+		for (int16 i = 0; i < width; ++i) {
+			buffer[i] = _row[valuesX[i]];
+		}
+		_x += width;
+		return buffer;
+	}
 };
 
 template<bool FLIP, typename READER>
@@ -353,6 +483,8 @@ struct READER_Compressed {
 private:
 	const SciSpan<const byte> _resource;
 	byte _buffer[kCelScalerTableSize];
+	const byte *_pixels;
+	const int16 _sourceWidth;
 	uint32 _controlOffset;
 	uint32 _dataOffset;
 	uint32 _uncompressedDataOffset;
@@ -362,8 +494,15 @@ private:
 	const int16 _maxWidth;
 
 public:
-	READER_Compressed(const CelObj &celObj, const int16 maxWidth) :
+	/**
+	 * Reads the pixels from the cel pixel cache when possible, unless
+	 * `useCache` is false, in which case rows are always decompressed from
+	 * the resource.
+	 */
+	READER_Compressed(const CelObj &celObj, const int16 maxWidth, const bool useCache = true) :
 	_resource(celObj.getResPointer()),
+	_pixels(nullptr),
+	_sourceWidth(celObj._width),
 	_y(-1),
 	_sourceHeight(celObj._height),
 	_skipColor(celObj._skipColor),
@@ -374,10 +513,18 @@ public:
 		_dataOffset = celHeader.getUint32SEAt(24);
 		_uncompressedDataOffset = celHeader.getUint32SEAt(28);
 		_controlOffset = celHeader.getUint32SEAt(32);
+
+		if (useCache && CelObj::_pixelCache) {
+			_pixels = CelObj::_pixelCache->getPixels(celObj);
+		}
 	}
 
 	inline const byte *getRow(const int16 y) {
 		assert(y >= 0 && y < _sourceHeight);
+		if (_pixels) {
+			return _pixels + y * _sourceWidth;
+		}
+
 		if (y != _y) {
 			// compressed data segment for row
 			const uint32 rowOffset = _resource.getUint32SEAt(_controlOffset + y * sizeof(uint32));
@@ -435,6 +582,119 @@ public:
 	}
 };
 
+#pragma mark -
+#pragma mark CelPixelCache
+
+CelPixelCache::CelPixelCache(const uint32 maxSize) :
+	_newest(nullptr),
+	_oldest(nullptr),
+	_maxSize(maxSize),
+	_size(0) {}
+
+CelPixelCache::~CelPixelCache() {
+	clear();
+}
+
+const byte *CelPixelCache::getPixels(const CelObj &celObj) {
+	const CelInfo32 &info = celObj._info;
+	if (info.type != kCelTypeView && info.type != kCelTypePic) {
+		return nullptr;
+	}
+
+	EntryMap::iterator it = _entries.find(info);
+	if (it != _entries.end()) {
+		Entry *entry = it->_value;
+		if (entry != _newest) {
+			unlinkEntry(entry);
+			linkNewest(entry);
+		}
+		++_stats.hits;
+		return entry->pixels;
+	}
+
+	// A cel which would push out most of the cache is not worth keeping
+	const uint32 size = celObj._width * celObj._height;
+	if (size == 0 || size > _maxSize / 4) {
+		++_stats.uncached;
+		return nullptr;
+	}
+
+	++_stats.misses;
+	while (_oldest && _size + size > _maxSize) {
+		evict(_oldest);
+		++_stats.evictions;
+	}
+
+	Entry *entry = new Entry();
+	entry->info = info;
+	entry->pixels = new byte[size];
+	entry->size = size;
+
+	READER_Compressed reader(celObj, celObj._width, false);
+	for (int16 y = 0; y < celObj._height; ++y) {
+		memcpy(entry->pixels + y * celObj._width, reader.getRow(y), celObj._width);
+	}
+
+	_entries.setVal(info, entry);
+	_size += size;
+	linkNewest(entry);
+	return entry->pixels;
+}
+
+void CelPixelCache::clear() {
+	while (_oldest) {
+		evict(_oldest);
+	}
+}
+
+void CelPixelCache::setMaxSize(const uint32 maxSize) {
+	_maxSize = maxSize;
+	while (_oldest && _size > _maxSize) {
+		evict(_oldest);
+		++_stats.evictions;
+	}
+}
+
+void CelPixelCache::printStats(Console *con) const {
+	const uint32 lookups = _stats.hits + _stats.misses;
+	con->debugPrintf("Cel pixel cache: %u cels, %u of %u KB\n", getEntryCount(), _size / 1024, _maxSize / 1024);
+	con->debugPrintf("Hits: %u (%u%%), misses: %u, evictions: %u, too large: %u\n",
+		_stats.hits, lookups ? (uint)((uint64)_stats.hits * 100 / lookups) : 0,
+		_stats.misses, _stats.evictions, _stats.uncached);
+}
+
+void CelPixelCache::linkNewest(Entry *entry) {
+	entry->prev = nullptr;
+	entry->next = _newest;
+	if (_newest) {
+		_newest->prev = entry;
+	} else {
+		_oldest = entry;
+	}
+	_newest = entry;
+}
+
+void CelPixelCache::unlinkEntry(Entry *entry) {
+	if (entry->prev) {
+		entry->prev->next = entry->next;
+	} else {
+		_newest = entry->next;
+	}
+	if (entry->next) {
+		entry->next->prev = entry->prev;
+	} else {
+		_oldest = entry->prev;
+	}
+}
+
+void CelPixelCache::evict(Entry *entry) {
+	unlinkEntry(entry);
+	_entries.erase(entry->info);
+	_size -= entry->size;
+	delete[] entry->pixels;
+	delete entry;
+}
+
 #pragma mark -
 #pragma mark CelObj - Remappers
 
@@ -469,6 +729,21 @@ struct MAPPER_NoMD {
 			*target = translateMacColor(isMacSource, pixel);
 		}
 	}
+
+	inline void drawRow(byte *target, const byte *source, const int16 width, const uint8 skipColor, const bool isMacSource) const {
+		int16 x = 0;
+#ifdef USE_SIMD_CEL_ROWS
+		const CelRowVec skip = rowSet(skipColor);
+		for (; x + 16 <= width; x += 16) {
+			const CelRowVec pixels = rowLoad(source + x);
+			const CelRowVec colors = isMacSource ? rowTranslateMacColor(pixels) : pixels;
+			rowStore(target + x, rowSelect(rowEq(pixels, skip), rowLoad(target + x), colors));
+		}
+#endif
+		for (; x < width; ++x) {
+			draw(target + x, source[x], skipColor, isMacSource);
+		}
+	}
 };
 
 /**
@@ -479,6 +754,23 @@ struct MAPPER_NoMDNoSkip {
 	inline void draw(byte *target, const byte pixel, const uint8, const bool isMacSource) const {
 		*target = translateMacColor(isMacSource, pixel);
 	}
+
+	inline void drawRow(byte *target, const byte *source, const int16 width, const uint8 skipColor, const bool isMacSource) const {
+		if (!isMacSource) {
+			memcpy(target, source, width);
+			return;
+		}
+
+		int16 x = 0;
+#ifdef USE_SIMD_CEL_ROWS
+		for (; x + 16 <= width; x += 16) {
+			rowStore(target + x, rowTranslateMacColor(rowLoad(source + x)));
+		}
+#endif
+		for (; x < width; ++x) {
+			draw(target + x, source[x], skipColor, isMacSource);
+		}
+	}
 };
 
 /**
@@ -487,15 +779,49 @@ struct MAPPER_NoMDNoSkip {
  */
 struct MAPPER_Map {
 	inline void draw(byte *target, const byte pixel, const uint8 skipColor, const bool isMacSource) const {
+		drawPixel(*g_sci->_gfxRemap32, target, pixel, skipColor, isMacSource);
+	}
+
+	static inline void drawPixel(const GfxRemap32 &remap, byte *target, const byte pixel, const uint8 skipColor, const bool isMacSource) {
 		if (pixel != skipColor) {
 			// For some reason, SSCI never checks if the source pixel is *above*
 			// the range of remaps, so we do not either.
-			if (pixel < g_sci->_gfxRemap32->getStartColor()) {
+			if (pixel < remap.getStartColor()) {
 				*target = translateMacColor(isMacSource, pixel);
-			} else if (g_sci->_gfxRemap32->remapEnabled(pixel)) {
-				*target = g_sci->_gfxRemap32->remapColor(translateMacColor(isMacSource, pixel), *target);
+			} else if (remap.remapEnabled(pixel)) {
+				*target = remap.remapColor(translateMacColor(isMacSource, pixel), *target);
+			}
+		}
+	}
+
+	inline void drawRow(byte *target, const byte *source, const int16 width, const uint8 skipColor, const bool isMacSource) const {
+		const GfxRemap32 &remap = *g_sci->_gfxRemap32;
+		int16 x = 0;
+#ifdef USE_SIMD_CEL_ROWS
+		const uint8 remapStartColor = remap.getStartColor();
+		const CelRowVec skip = rowSet(skipColor);
+		const CelRowVec startColor = rowSet(remapStartColor);
+		for (; x + 16 <= width; x += 16) {
+			const CelRowVec pixels = rowLoad(source + x);
+			const CelRowVec isSkip = rowEq(pixels, skip);
+			const CelRowVec isRemap = rowAtLeast(pixels, startColor);
+			const CelRowVec colors = isMacSource ? rowTranslateMacColor(pixels) : pixels;
+			rowStore(target + x, rowSelect(rowOr(isSkip, isRemap), rowLoad(target + x), colors));
+
+			// Remapping looks up every pixel in the table of its remap color,
+			// which has to be done one pixel at a time
+			if (rowAny(rowAndNot(isSkip, isRemap))) {
+				for (int16 i = x; i < x + 16; ++i) {
+					if (source[i] >= remapStartColor) {
+						drawPixel(remap, target + i, source[i], skipColor, isMacSource);
+					}
+				}
 			}
 		}
+#endif
+		for (; x < width; ++x) {
+			drawPixel(remap, target + x, source[x], skipColor, isMacSource);
+		}
 	}
 };
 
@@ -511,6 +837,23 @@ struct MAPPER_NoMap {
 			*target = translateMacColor(isMacSource, pixel);
 		}
 	}
+
+	inline void drawRow(byte *target, const byte *source, const int16 width, const uint8 skipColor, const bool isMacSource) const {
+		int16 x = 0;
+#ifdef USE_SIMD_CEL_ROWS
+		const CelRowVec skip = rowSet(skipColor);
+		const CelRowVec startColor = rowSet(g_sci->_gfxRemap32->getStartColor());
+		for (; x + 16 <= width; x += 16) {
+			const CelRowVec pixels = rowLoad(source + x);
+			const CelRowVec keep = rowOr(rowEq(pixels, skip), rowAtLeast(pixels, startColor));
+			const CelRowVec colors = isMacSource ? rowTranslateMacColor(pixels) : pixels;
+			rowStore(target + x, rowSelect(keep, rowLoad(target + x), colors));
+		}
+#endif
+		for (; x < width; ++x) {
+			draw(target + x, source[x], skipColor, isMacSource);
+		}
+	}
 };
 
 void CelObj::draw(Buffer &target, const ScreenItem &screenItem, const Common::Rect &targetRect) const {
@@ -689,6 +1032,7 @@ void CelObj::submitPalette() const {
 
 int CelObj::_nextCacheId = 1;
 CelCache *CelObj::_cache = nullptr;
+CelPixelCache *CelObj::_pixelCache = nullptr;
 
 int CelObj::searchCache(const CelInfo32 &celInfo, int *const nextInsertIndex) const {
 	*nextInsertIndex = -1;
@@ -750,6 +1094,8 @@ struct RENDERER {
 		const int16 skipStride = target.w - targetRect.width();
 		const int16 targetWidth = targetRect.width();
 		const int16 targetHeight = targetRect.height();
+		// Holds flipped and scaled rows for the row kernels
+		byte rowBuffer[kCelScalerTableSize];
 		for (int16 y = 0; y < targetHeight; ++y) {
 			if (DRAW_BLACK_LINES && (y % 2) == 0) {
 				memset(targetPixel, 0, targetWidth);
@@ -759,8 +1105,13 @@ struct RENDERER {
 
 			_scaler.setTarget(targetRect.left, targetRect.top + y);
 
-			for (int16 x = 0; x < targetWidth; ++x) {
-				_mapper.draw(targetPixel++, _scaler.read(), _skipColor, _isMacSource);
+			if (CelObj::_rowRendering) {
+				_mapper.drawRow(targetPixel, _scaler.readRow(rowBuffer, targetWidth), targetWidth, _skipColor, _isMacSource);
+				targetPixel += targetWidth;
+			} else {
+				for (int16 x = 0; x < targetWidth; ++x) {
+					_mapper.draw(targetPixel++, _scaler.read(), _skipColor, _isMacSource);
+				}
 			}
 
 			targetPixel += skipStride;
@@ -908,6 +1259,211 @@ void CelObj::scaleDrawUncompNoMD(Buffer &target, const Ratio &scaleX, const Rati
 	}
 }
 
+#pragma mark -
+#pragma mark CelObj - Debugging
+
+enum CelMapperType {
+	kCelMapperNoMD,
+	kCelMapperNoMDNoSkip,
+	kCelMapperNoMap,
+	kCelMapperMap,
+	kNumCelMappers
+};
+
+void CelObj::drawWithMapper(Buffer &target, const int mapper, const Common::Rect &targetRect, const Ratio &scaleX, const Ratio &scaleY) const {
+	const Common::Point scaledPosition(targetRect.left, targetRect.top);
+	const bool uncompressed = _compressionType == kCelCompressionNone;
+
+	if (!scaleX.isOne() || !scaleY.isOne()) {
+		switch (mapper) {
+		case kCelMapperNoMD:
+			if (uncompressed) {
+				scaleDrawUncompNoMD(target, scaleX, scaleY, targetRect, scaledPosition);
+			} else {
+				scaleDrawNoMD(target, scaleX, scaleY, targetRect, scaledPosition);
+			}
+			break;
+		case kCelMapperNoMap:
+			if (uncompressed) {
+				scaleDrawUncomp(target, scaleX, scaleY, targetRect, scaledPosition);
+			} else {
+				scaleDraw(target, scaleX, scaleY, targetRect, scaledPosition);
+			}
+			break;
+		case kCelMapperMap:
+			if (uncompressed) {
+				scaleDrawUncompMap(target, scaleX, scaleY, targetRect, scaledPosition);
+			} else {
+				scaleDrawMap(target, scaleX, scaleY, targetRect, scaledPosition);
+			}
+			break;
+		default:
+			break;
+		}
+		return;
+	}
+
+	switch (mapper) {
+	case kCelMapperNoMD:
+		if (uncompressed) {
+			if (_drawMirrored) {
+				drawUncompHzFlipNoMD(target, targetRect, scaledPosition);
+			} else {
+				drawUncompNoFlipNoMD(target, targetRect, scaledPosition);
+			}
+		} else {
+			if (_drawMirrored) {
+				drawHzFlipNoMD(target, targetRect, scaledPosition);
+			} else {
+				drawNoFlipNoMD(target, targetRect, scaledPosition);
+			}
+		}
+		break;
+	case kCelMapperNoMDNoSkip:
+		if (uncompressed) {
+			if (_drawMirrored) {
+				drawUncompHzFlipNoMDNoSkip(target, targetRect, scaledPosition);
+			} else {
+				drawUncompNoFlipNoMDNoSkip(target, targetRect, scaledPosition);
+			}
+		}
+		break;
+	case kCelMapperNoMap:
+		if (uncompressed) {
+			if (_drawMirrored) {
+				drawUncompHzFlip(target, targetRect, scaledPosition);
+			} else {
+				drawUncompNoFlip(target, targetRect, scaledPosition);
+			}
+		} else {
+			if (_drawMirrored) {
+				drawHzFlip(target, targetRect, scaledPosition);
+			} else {
+				drawNoFlip(target, targetRect, scaledPosition);
+			}
+		}
+		break;
+	case kCelMapperMap:
+		if (uncompressed) {
+			if (_drawMirrored) {
+				drawUncompHzFlipMap(target, targetRect, scaledPosition);
+			} else {
+				drawUncompNoFlipMap(target, targetRect, scaledPosition);
+			}
+		} else {
+			if (_drawMirrored) {
+				drawHzFlipMap(target, targetRect, scaledPosition);
+			} else {
+				drawNoFlipMap(target, targetRect, scaledPosition);
+			}
+		}
+		break;
+	default:
+		break;
+	}
+}
+
+void CelObj::benchmarkRenderers(Console *con, const GuiResourceId viewId, const int iterations) {
+	static const char *const mapperNames[kNumCelMappers] = { "NoMD", "NoMDNoSkip", "NoMap", "Map" };
+	static const char *const scaleNames[] = { "1:1", "3:2", "2:3" };
+	const Ratio scales[ARRAYSIZE(scaleNames)] = { Ratio(), Ratio(3, 2), Ratio(2, 3) };
+
+	const int16 numLoops = CelObjView::getNumLoops(viewId);
+	if (numLoops == 0) {
+		con->debugPrintf("View %d not found\n", viewId);
+		return;
+	}
+
+	// The remap paths only differ from the others with an active remap, so
+	// turn one on for the highest remap color if the game has none there
+	GfxRemap32 &remap = *g_sci->_gfxRemap32;
+	const uint8 remapColor = remap.getEndColor();
+	const bool addedRemap = !remap.remapEnabled(remapColor);
+	if (addedRemap) {
+		remap.remapByPercent(remapColor, 50);
+	}
+
+	const bool rowRendering = _rowRendering;
+	uint32 pixelTimes[kNumCelMappers][2][ARRAYSIZE(scales)] = {};
+	uint32 rowTimes[kNumCelMappers][2][ARRAYSIZE(scales)] = {};
+	int mismatches[kNumCelMappers][2][ARRAYSIZE(scales)] = {};
+	int celCount = 0;
+
+	Buffer expected, actual;
+	for (int16 loopNo = 0; loopNo < numLoops; ++loopNo) {
+		const int16 numCels = CelObjView::getNumCels(viewId, loopNo);
+		for (int16 celNo = 0; celNo < numCels; ++celNo) {
+			CelObjView view(viewId, loopNo, celNo);
+			CelObj &celObj = view;
+
+			for (int mapper = 0; mapper < kNumCelMappers; ++mapper) {
+				if (mapper == kCelMapperNoMDNoSkip && celObj._compressionType != kCelCompressionNone) {
+					continue;
+				}
+
+				for (int flip = 0; flip < 2; ++flip) {
+					celObj._drawMirrored = flip != 0;
+
+					for (int scale = 0; scale < ARRAYSIZE(scales); ++scale) {
+						const Common::Rect targetRect(
+							MIN<int>((celObj._width * scales[scale]).toInt(), kCelScalerTableSize),
+							MIN<int>((celObj._height * scales[scale]).toInt(), kCelScalerTableSize));
+						if (targetRect.isEmpty()) {
+							continue;
+						}
+
+						expected.create(targetRect.width(), targetRect.height(), Graphics::PixelFormat::createFormatCLUT8());
+						actual.create(targetRect.width(), targetRect.height(), Graphics::PixelFormat::createFormatCLUT8());
+
+						for (int pass = 0; pass < 2; ++pass) {
+							_rowRendering = pass != 0;
+							Buffer &target = _rowRendering ? actual : expected;
+							const uint32 start = g_system->getMillis();
+							for (int i = 0; i < iterations; ++i) {
+								// Something to remap and to show through the
+								// skip pixels
+								byte *pixels = (byte *)target.getPixels();
+								for (int j = 0; j < target.w * target.h; ++j) {
+									pixels[j] = (byte)(j * 7);
+								}
+								celObj.drawWithMapper(target, mapper, targetRect, scales[scale], scales[scale]);
+							}
+							(_rowRendering ? rowTimes : pixelTimes)[mapper][flip][scale] += g_system->getMillis() - start;
+						}
+
+						if (memcmp(expected.getPixels(), actual.getPixels(), targetRect.width() * targetRect.height())) {
+							con->debugPrintf("Different pixels in loop %d cel %d, %s%s %s\n", loopNo, celNo,
+								mapperNames[mapper], flip ? " mirrored" : "", scaleNames[scale]);
+							++mismatches[mapper][flip][scale];
+						}
+
+						expected.free();
+						actual.free();
+					}
+				}
+			}
+			++celCount;
+		}
+	}
+
+	_rowRendering = rowRendering;
+	if (addedRemap) {
+		remap.remapOff(remapColor);
+	}
+
+	con->debugPrintf("View %d, %d cels, %d iterations:\n", viewId, celCount, iterations);
+	for (int mapper = 0; mapper < kNumCelMappers; ++mapper) {
+		for (int flip = 0; flip < 2; ++flip) {
+			for (int scale = 0; scale < ARRAYSIZE(scales); ++scale) {
+				con->debugPrintf(" %-10s %-8s %s: by pixel %u ms, by row %u ms, %d different\n",
+					mapperNames[mapper], flip ? "mirrored" : "", scaleNames[scale],
+					pixelTimes[mapper][flip][scale], rowTimes[mapper][flip][scale],
+					mismatches[mapper][flip][scale]);
+			}
+		}
+	}
+}
+
 #pragma mark -
 #pragma mark CelObjView
 
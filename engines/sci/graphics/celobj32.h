@@ -23,6 +23,7 @@
 #ifndef SCI_GRAPHICS_CELOBJ32_H
 #define SCI_GRAPHICS_CELOBJ32_H
 
+#include "common/hashmap.h"
 #include "common/rational.h"
 #include "common/rect.h"
 #include "sci/resource/resource.h"
@@ -152,6 +153,113 @@ struct CelCacheEntry {
 
 typedef Common::Array<CelCacheEntry> CelCache;
 
+#pragma mark -
+#pragma mark CelPixelCache
+
+class Console;
+
+enum {
+	/**
+	 * The default maximum size of the cel pixel cache, in bytes.
+	 */
+	kCelPixelCacheSize = 8 * 1024 * 1024
+};
+
+/**
+ * A cache of the decompressed pixels of compressed view and pic cels. Without
+ * it, RLE cels are decompressed again every time they are drawn, which adds up
+ * when the same few cels are cycled by an animation on every frame. The least
+ * recently used cels are dropped when the cache grows over its size limit.
+ */
+class CelPixelCache {
+public:
+	struct Stats {
+		uint32 hits;
+		uint32 misses;
+		uint32 evictions;
+
+		/**
+		 * The number of cels which were too large to be cached and were
+		 * decompressed by rows instead.
+		 */
+		uint32 uncached;
+
+		Stats() : hits(0), misses(0), evictions(0), uncached(0) {}
+	};
+
+	CelPixelCache(const uint32 maxSize);
+	~CelPixelCache();
+
+	/**
+	 * Returns the decompressed pixels of the given compressed cel, one row of
+	 * `celObj._width` pixels after the other, decompressing and caching them
+	 * first if needed. Returns null if the cel cannot be cached.
+	 *
+	 * The pixels are valid until the next call.
+	 */
+	const byte *getPixels(const CelObj &celObj);
+
+	/**
+	 * Drops all cached cels.
+	 */
+	void clear();
+
+	/**
+	 * Sets the maximum size of the cached pixels, in bytes, and drops cels
+	 * until the cache fits it.
+	 */
+	void setMaxSize(const uint32 maxSize);
+
+	uint32 getMaxSize() const { return _maxSize; }
+	uint32 getSize() const { return _size; }
+	uint getEntryCount() const { return _entries.size(); }
+	const Stats &getStats() const { return _stats; }
+	void resetStats() { _stats = Stats(); }
+
+	void printStats(Console *con) const;
+
+private:
+	struct Entry {
+		CelInfo32 info;
+		byte *pixels;
+		uint32 size;
+		Entry *prev;
+		Entry *next;
+	};
+
+	struct CelInfoHash {
+		uint operator()(const CelInfo32 &info) const {
+			return (info.resourceId << 12) ^ (info.loopNo << 6) ^ info.celNo ^ (info.type << 28);
+		}
+	};
+
+	struct CelInfoEqualTo {
+		bool operator()(const CelInfo32 &a, const CelInfo32 &b) const {
+			return a.type == b.type && a.resourceId == b.resourceId && a.loopNo == b.loopNo && a.celNo == b.celNo;
+		}
+	};
+
+	typedef Common::HashMap<CelInfo32, Entry *, CelInfoHash, CelInfoEqualTo> EntryMap;
+
+	/**
+	 * The cached cels, by their view or pic, loop, and cel numbers.
+	 */
+	EntryMap _entries;
+
+	/**
+	 * The most and least recently used cels.
+	 */
+	Entry *_newest, *_oldest;
+
+	uint32 _maxSize;
+	uint32 _size;
+	Stats _stats;
+
+	void linkNewest(Entry *entry);
+	void unlinkEntry(Entry *entry);
+	void evict(Entry *entry);
+};
+
 #pragma mark -
 #pragma mark CelScaler
 
@@ -266,6 +374,13 @@ protected:
 public:
 	static CelScaler *_scaler;
 
+	/**
+	 * When true, cels are drawn one row at a time by row kernels, which use
+	 * SSE2 or NEON where available. When false, cels are drawn pixel by
+	 * pixel, like in SSCI.
+	 */
+	static bool _rowRendering;
+
 	/**
 	 * The basic identifying information for this cel. This information
 	 * effectively acts as a composite key for a cel object, and any cel object
@@ -451,6 +566,23 @@ private:
 	// SSCI includes versions of the above functions with priority parameters
 	// which are not actually used in SCI32
 
+#pragma mark -
+#pragma mark CelObj - Debugging
+public:
+	/**
+	 * Draws every cel of the given view through each combination of pixel
+	 * mapper, mirroring and scaling, both pixel by pixel and by rows. Prints
+	 * the time taken by each and any differences between their output.
+	 */
+	static void benchmarkRenderers(Console *con, const GuiResourceId viewId, const int iterations);
+
+private:
+	/**
+	 * Draws the cel with the given pixel mapper, whether or not the cel has
+	 * remap pixels or the current remap state would select it.
+	 */
+	void drawWithMapper(Buffer &target, const int mapper, const Common::Rect &targetRect, const Ratio &scaleX, const Ratio &scaleY) const;
+
 #pragma mark -
 #pragma mark CelObj - Caching
 protected:
@@ -466,6 +598,13 @@ protected:
 	 */
 	static CelCache *_cache;
 
+public:
+	/**
+	 * A cache of the decompressed pixels of compressed view and pic cels.
+	 */
+	static CelPixelCache *_pixelCache;
+
+protected:
 	/**
 	 * Searches the cel cache for a CelObj matching the provided CelInfo32. If
 	 * not found, -1 is returned. `nextInsertIndex` will receive the index of
@@ -480,35 +480,49 @@ void GfxFrameout::frameOut(const bool shouldShowBits, const Common::Rect &eraseR
 		robotPlayer.doRobot();
 	}
 
-	// SSCI allocated these as static arrays of 100 pointers to
-	// ScreenItemList / RectList
-	ScreenItemListList screenItemLists;
-	EraseListList eraseLists;
-
-	screenItemLists.resize(_planes.size());
-	eraseLists.resize(_planes.size());
-
 	if (g_sci->_gfxRemap32->getRemapCount() > 0 && _remapOccurred) {
 		remapMarkRedraw();
 	}
 
-	calcLists(screenItemLists, eraseLists, eraseRect);
+	// When nothing changed since the last frame, all of the draw and erase
+	// lists would come out empty, so there is nothing to calculate or draw
+	const bool hasChanges = !eraseRect.isEmpty() || hasPendingChanges();
 
-	for (ScreenItemListList::iterator list = screenItemLists.begin(); list != screenItemLists.end(); ++list) {
-		list->sort();
-	}
+	if (hasChanges) {
+		// SSCI allocated these as static arrays of 100 pointers to
+		// ScreenItemList / RectList
+		_screenItemLists.resize(_planes.size());
+		_eraseLists.resize(_planes.size());
 
-	for (ScreenItemListList::iterator list = screenItemLists.begin(); list != screenItemLists.end(); ++list) {
-		for (DrawList::iterator drawItem = list->begin(); drawItem != list->end(); ++drawItem) {
-			(*drawItem)->screenItem->getCelObj().submitPalette();
+		calcLists(_screenItemLists, _eraseLists, eraseRect);
+
+		for (ScreenItemListList::iterator list = _screenItemLists.begin(); list != _screenItemLists.end(); ++list) {
+			list->sort();
 		}
+
+		for (ScreenItemListList::iterator list = _screenItemLists.begin(); list != _screenItemLists.end(); ++list) {
+			for (DrawList::iterator drawItem = list->begin(); drawItem != list->end(); ++drawItem) {
+				(*drawItem)->screenItem->getCelObj().submitPalette();
+			}
+		}
+	} else {
+		++_frameStats.staticFrames;
 	}
 
 	_remapOccurred = _palette->updateForFrame();
 
-	for (PlaneList::size_type i = 0; i < _planes.size(); ++i) {
-		drawEraseList(eraseLists[i], *_planes[i]);
-		drawScreenItemList(screenItemLists[i]);
+	if (hasChanges) {
+		for (PlaneList::size_type i = 0; i < _planes.size(); ++i) {
+			drawEraseList(_eraseLists[i], *_planes[i]);
+			drawScreenItemList(_screenItemLists[i]);
+		}
+
+		// The draw lists point to screen items which may be deleted before
+		// the next frame
+		for (PlaneList::size_type i = 0; i < _planes.size(); ++i) {
+			_eraseLists[i].clear();
+			_screenItemLists[i].clear();
+		}
 	}
 
 	if (robotIsActive) {
@@ -524,6 +538,11 @@ void GfxFrameout::frameOut(const bool shouldShowBits, const Common::Rect &eraseR
 	if (robotIsActive) {
 		robotPlayer.frameNowVisible();
 	}
+
+	++_frameStats.frames;
+	_lastFrameStats = _frameStats;
+	_totalFrameStats.add(_frameStats);
+	_frameStats = FrameOutStats();
 }
 
 void GfxFrameout::palMorphFrameOut(const int8 *styleRanges, PlaneShowStyle *showStyle) {
@@ -927,13 +946,23 @@ void GfxFrameout::calcLists(ScreenItemListList &drawLists, EraseListList &eraseL
 
 		if (!plane._screenRect.isEmpty()) {
 			if (plane._redrawAllCount) {
+				++_frameStats.planesCalculated;
+				_frameStats.itemsConsidered += plane._screenItemList.size();
 				plane.redrawAll(visiblePlane, _planes, drawLists[planeIndex], eraseLists[planeIndex]);
 			} else {
 				if (visiblePlane == nullptr) {
 					error("Missing visible plane for source plane %04x:%04x", PRINT_REG(plane._object));
 				}
 
-				plane.calcLists(*visiblePlane, _planes, drawLists[planeIndex], eraseLists[planeIndex]);
+				if (eraseLists[planeIndex].size() == 0 && !plane.hasScreenItemChanges()) {
+					// Without anything to erase or any changed screen items,
+					// Plane::calcLists would not add anything to the lists
+					++_frameStats.planesSkipped;
+				} else {
+					++_frameStats.planesCalculated;
+					_frameStats.itemsConsidered += plane._screenItemList.size();
+					plane.calcLists(*visiblePlane, _planes, drawLists[planeIndex], eraseLists[planeIndex]);
+				}
 			}
 		} else {
 			plane.decrementScreenItemArrayCounts(visiblePlane, false);
@@ -987,6 +1016,21 @@ void GfxFrameout::calcLists(ScreenItemListList &drawLists, EraseListList &eraseL
 	}
 }
 
+bool GfxFrameout::hasPendingChanges() const {
+	for (PlaneList::const_iterator it = _planes.begin(); it != _planes.end(); ++it) {
+		const Plane &plane = **it;
+		if (
+			plane._created || plane._updated || plane._deleted ||
+			plane._moved || plane._priorityChanged || plane._redrawAllCount ||
+			plane.hasScreenItemChanges()
+		) {
+			return true;
+		}
+	}
+
+	return false;
+}
+
 void GfxFrameout::drawEraseList(const RectList &eraseList, const Plane &plane) {
 	if (plane._type != kPlaneTypeColored) {
 		return;
@@ -997,6 +1041,7 @@ void GfxFrameout::drawEraseList(const RectList &eraseList, const Plane &plane) {
 		mergeToShowList(*eraseList[i], _showList, _overdrawThreshold);
 		_currentBuffer.fillRect(*eraseList[i], plane._back);
 	}
+	_frameStats.rectsDrawn += eraseListSize;
 }
 
 void GfxFrameout::drawScreenItemList(const DrawList &screenItemList) {
@@ -1008,6 +1053,7 @@ void GfxFrameout::drawScreenItemList(const DrawList &screenItemList) {
 		CelObj &celObj = *screenItem._celObj;
 		celObj.draw(_currentBuffer, screenItem, drawItem.rect, screenItem._mirrorX ^ celObj._mirrorX);
 	}
+	_frameStats.rectsDrawn += drawListSize;
 }
 
 void GfxFrameout::mergeToShowList(const Common::Rect &drawRect, RectList &showList, const int overdrawThreshold) {
@@ -1104,6 +1150,8 @@ void GfxFrameout::showBits() {
 			continue;
 		}
 
+		_frameStats.pixelsShown += rounded.width() * rounded.height();
+
 #ifdef USE_RGB_COLOR
 		if (g_system->getScreenFormat() != _currentBuffer.format) {
 			// This happens (at least) when playing a video in Shivers with
@@ -1450,6 +1498,35 @@ void GfxFrameout::printPlaneListInternal(Console *con, const PlaneList &planeLis
 	}
 }
 
+void GfxFrameout::FrameOutStats::add(const FrameOutStats &other) {
+	frames += other.frames;
+	staticFrames += other.staticFrames;
+	planesCalculated += other.planesCalculated;
+	planesSkipped += other.planesSkipped;
+	itemsConsidered += other.itemsConsidered;
+	rectsDrawn += other.rectsDrawn;
+	pixelsShown += other.pixelsShown;
+}
+
+void GfxFrameout::printFrameOutStats(Console *con) const {
+	con->debugPrintf("Last frame: %u planes calculated, %u planes skipped, %u items considered, %u rects drawn, %u pixels shown%s\n",
+		_lastFrameStats.planesCalculated, _lastFrameStats.planesSkipped,
+		_lastFrameStats.itemsConsidered, _lastFrameStats.rectsDrawn,
+		(uint)_lastFrameStats.pixelsShown, _lastFrameStats.staticFrames ? " (static)" : "");
+
+	const uint32 frames = MAX<uint32>(_totalFrameStats.frames, 1);
+	con->debugPrintf("%u frames, %u static: %u planes calculated, %u planes skipped, %u items considered, %u rects drawn, %u pixels shown per frame\n",
+		_totalFrameStats.frames, _totalFrameStats.staticFrames,
+		_totalFrameStats.planesCalculated / frames, _totalFrameStats.planesSkipped / frames,
+		_totalFrameStats.itemsConsidered / frames, _totalFrameStats.rectsDrawn / frames,
+		(uint)(_totalFrameStats.pixelsShown / frames));
+}
+
+void GfxFrameout::resetFrameOutStats() {
+	_lastFrameStats = FrameOutStats();
+	_totalFrameStats = FrameOutStats();
+}
+
 void GfxFrameout::printPlaneList(Console *con) const {
 	printPlaneListInternal(con, _planes);
 }
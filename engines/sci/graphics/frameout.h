@@ -346,6 +346,20 @@ private:
 	 */
 	PlaneList _visiblePlanes;
 
+	/**
+	 * The draw and erase lists of the planes, kept between frames by
+	 * `frameOut` so that their storage does not need to be allocated again on
+	 * every frame.
+	 */
+	ScreenItemListList _screenItemLists;
+	EraseListList _eraseLists;
+
+	/**
+	 * Returns true if any plane or screen item has been changed since the last
+	 * frame, i.e. if `calcLists` may produce any draw or erase rects.
+	 */
+	bool hasPendingChanges() const;
+
 	/**
 	 * Calculates the location and dimensions of dirty rects over the entire
 	 * screen for rendering the next frame. The draw and erase lists in
@@ -431,12 +445,42 @@ private:
 #pragma mark -
 #pragma mark Debugging
 public:
+	/**
+	 * Rendering counters, reported by the `frameout_stats` debugger command.
+	 */
+	struct FrameOutStats {
+		uint32 frames;
+		/** Frames without any plane or screen item changes. */
+		uint32 staticFrames;
+		uint32 planesCalculated;
+		/** Unchanged planes, for which the list calculation was skipped. */
+		uint32 planesSkipped;
+		uint32 itemsConsidered;
+		uint32 rectsDrawn;
+		uint64 pixelsShown;
+
+		FrameOutStats() :
+			frames(0), staticFrames(0), planesCalculated(0), planesSkipped(0),
+			itemsConsidered(0), rectsDrawn(0), pixelsShown(0) {}
+
+		void add(const FrameOutStats &other);
+	};
+
+	void printFrameOutStats(Console *con) const;
+	void resetFrameOutStats();
 	void printPlaneList(Console *con) const;
 	void printVisiblePlaneList(Console *con) const;
 	void printPlaneListInternal(Console *con, const PlaneList &planeList) const;
 	void printPlaneItemList(Console *con, const reg_t planeObject) const;
 	void printVisiblePlaneItemList(Console *con, const reg_t planeObject) const;
 	void printPlaneItemListInternal(Console *con, const ScreenItemList &screenItemList) const;
+
+private:
+	/**
+	 * Counters of the frame being rendered, of the last rendered frame, and
+	 * of all frames since the last reset.
+	 */
+	FrameOutStats _frameStats, _lastFrameStats, _totalFrameStats;
 };
 
 } // End of namespace Sci
@@ -529,6 +529,17 @@ void Plane::calcLists(Plane &visiblePlane, const PlaneList &planeList, DrawList
 	decrementScreenItemArrayCounts(&visiblePlane, false);
 }
 
+bool Plane::hasScreenItemChanges() const {
+	for (ScreenItemList::const_iterator it = _screenItemList.begin(); it != _screenItemList.end(); ++it) {
+		const ScreenItem *item = *it;
+		if (item != nullptr && (item->_created || item->_updated || item->_deleted)) {
+			return true;
+		}
+	}
+
+	return false;
+}
+
 void Plane::decrementScreenItemArrayCounts(Plane *visiblePlane, const bool forceUpdate) {
 	const ScreenItemList::size_type screenItemCount = _screenItemList.size();
 	for (ScreenItemList::size_type i = 0; i < screenItemCount; ++i) {
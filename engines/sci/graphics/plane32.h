@@ -408,6 +408,13 @@ public:
 	 */
 	void decrementScreenItemArrayCounts(Plane *visiblePlane, const bool forceUpdate);
 
+	/**
+	 * Returns true if any screen item of this plane has been created, updated,
+	 * or deleted since the last frame. Planes without such changes and without
+	 * any erase rects produce empty draw and erase lists in `calcLists`.
+	 */
+	bool hasScreenItemChanges() const;
+
 	/**
 	 * This method is called from the highest priority plane to the lowest
 	 * priority plane.
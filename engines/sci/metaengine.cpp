@@ -332,6 +332,10 @@ bool SciEngine::hasFeature(EngineFeature f) const {
 }
 
 SaveStateList SciMetaEngine::listSaves(const char *target) const {
+	// A savegame of the running game may still be being written
+	if (g_sci)
+		g_sci->getSavegameWriter()->flush();
+
 	Common::SaveFileManager *saveFileMan = g_system->getSavefileManager();
 	Common::StringArray filenames;
 	Common::String pattern = target;
@@ -380,6 +384,8 @@ SaveStateList SciMetaEngine::listSaves(const char *target) const {
 
 SaveStateDescriptor SciMetaEngine::querySaveMetaInfos(const char *target, int slotNr) const {
 	const Common::String fileName = Common::String::format("%s.%03d", target, slotNr);
+	if (g_sci)
+		g_sci->getSavegameWriter()->flush();
 	Common::InSaveFile *in = g_system->getSavefileManager()->openForLoading(fileName);
 	SaveStateDescriptor descriptor(this, slotNr, "");
 
@@ -435,6 +441,8 @@ int SciMetaEngine::getMaximumSaveSlot() const { return 99; }
 
 void SciMetaEngine::removeSaveState(const char *target, int slot) const {
 	Common::String fileName = Common::String::format("%s.%03d", target, slot);
+	if (g_sci)
+		g_sci->getSavegameWriter()->flush();
 	g_system->getSavefileManager()->removeSavefile(fileName);
 }
 
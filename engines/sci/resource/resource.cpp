@@ -26,6 +26,7 @@
 #include "common/file.h"
 #include "common/fs.h"
 #include "common/macresman.h"
+#include "common/system.h"
 #include "common/textconsole.h"
 #include "common/translation.h"
 #ifdef ENABLE_SCI32
@@ -158,6 +159,53 @@ const char *getResourceTypeExtension(ResourceType restype) {
 		return "";
 }
 
+ResourceCategory getResourceCategory(ResourceType restype) {
+	switch (restype) {
+	case kResourceTypeView:
+	case kResourceTypePic:
+	case kResourceTypeFont:
+	case kResourceTypeCursor:
+	case kResourceTypeBitmap:
+	case kResourceTypePalette:
+	case kResourceTypeClut:
+	case kResourceTypeTGA:
+	case kResourceTypeMacIconBarPictN:
+	case kResourceTypeMacIconBarPictS:
+	case kResourceTypeMacPict:
+		return kResourceCategoryGraphics;
+	case kResourceTypeSound:
+	case kResourceTypePatch:
+	case kResourceTypeCdAudio:
+	case kResourceTypeAudio:
+	case kResourceTypeSync:
+	case kResourceTypeMap:
+	case kResourceTypeAudio36:
+	case kResourceTypeSync36:
+	case kResourceTypeRave:
+		return kResourceCategoryAudio;
+	case kResourceTypeScript:
+	case kResourceTypeHeap:
+	case kResourceTypeVocab:
+	case kResourceTypeText:
+	case kResourceTypeMessage:
+	case kResourceTypeTranslation:
+		return kResourceCategoryScript;
+	default:
+		return kResourceCategoryOther;
+	}
+}
+
+static const char *const s_resourceCategoryNames[] = {
+	"graphics", "audio", "script", "other"
+};
+
+const char *getResourceCategoryName(ResourceCategory category) {
+	if (category < ARRAYSIZE(s_resourceCategoryNames))
+		return s_resourceCategoryNames[category];
+	else
+		return "invalid";
+}
+
 static const ResourceType s_resTypeMapSci0[] = {
 	kResourceTypeView, kResourceTypePic, kResourceTypeScript, kResourceTypeText,          // 0x00-0x03
 	kResourceTypeSound, kResourceTypeMemory, kResourceTypeVocab, kResourceTypeFont,       // 0x04-0x07
@@ -213,6 +261,12 @@ Resource::Resource(ResourceManager *resMan, ResourceId id) : SciSpan<const byte>
 	_fileOffset = 0;
 	_status = kResStatusNoMalloc;
 	_lockers = 0;
+	_prefetched = false;
+	_pinned = false;
+	_evicted = false;
+	_lruPrev = nullptr;
+	_lruNext = nullptr;
+	_lruStamp = 0;
 	_source = nullptr;
 	_header = nullptr;
 	_headerSize = 0;
@@ -229,6 +283,7 @@ void Resource::unalloc() {
 	delete[] _data;
 	_data = nullptr;
 	_status = kResStatusNoMalloc;
+	_prefetched = false;
 }
 
 void Resource::writeToStream(Common::WriteStream *stream) const {
@@ -1005,13 +1060,21 @@ void ResourceManager::freeResourceSources() {
 }
 
 ResourceManager::ResourceManager(const bool detectionMode) :
-	_detectionMode(detectionMode) {}
+	_detectionMode(detectionMode),
+	_prefetchEnabled(!detectionMode) {}
 
 void ResourceManager::init() {
 	_maxMemoryLRU = 256 * 1024; // 256KiB
 	_memoryLocked = 0;
 	_memoryLRU = 0;
-	_LRU.clear();
+	for (int i = 0; i < kResourceCategoryCount; ++i)
+		_LRU[i] = ResourceLRU();
+	_pinnedLRU = ResourceLRU();
+	_lruStamp = 0;
+	resetResourceStats();
+	_prefetchQueue.clear();
+	_prefetchQueued.clear();
+	_prefetchStats = PrefetchStats();
 	_resMap.clear();
 	_audioMapSCI1 = NULL;
 #ifdef ENABLE_SCI32
@@ -1126,13 +1189,29 @@ ResourceManager::~ResourceManager() {
 	}
 }
 
+ResourceManager::ResourceLRU &ResourceManager::getLRU(const Resource *res) {
+	return res->_pinned ? _pinnedLRU : _LRU[getResourceCategory(res->getType())];
+}
+
 void ResourceManager::removeFromLRU(Resource *res) {
 	if (res->_status != kResStatusEnqueued) {
 		warning("resMan: trying to remove resource that isn't enqueued");
 		return;
 	}
-	_LRU.remove(res);
-	_memoryLRU -= res->size();
+	ResourceLRU &lru = getLRU(res);
+	if (res->_lruPrev)
+		res->_lruPrev->_lruNext = res->_lruNext;
+	else
+		lru.newest = res->_lruNext;
+	if (res->_lruNext)
+		res->_lruNext->_lruPrev = res->_lruPrev;
+	else
+		lru.oldest = res->_lruPrev;
+	res->_lruPrev = res->_lruNext = nullptr;
+	lru.size -= res->size();
+	--lru.count;
+	if (!res->_pinned)
+		_memoryLRU -= res->size();
 	res->_status = kResStatusAllocated;
 }
 
@@ -1141,8 +1220,19 @@ void ResourceManager::addToLRU(Resource *res) {
 		warning("resMan: trying to enqueue resource with state %d", res->_status);
 		return;
 	}
-	_LRU.push_front(res);
-	_memoryLRU += res->size();
+	ResourceLRU &lru = getLRU(res);
+	res->_lruPrev = nullptr;
+	res->_lruNext = lru.newest;
+	if (lru.newest)
+		lru.newest->_lruPrev = res;
+	else
+		lru.oldest = res;
+	lru.newest = res;
+	lru.size += res->size();
+	++lru.count;
+	res->_lruStamp = ++_lruStamp;
+	if (!res->_pinned)
+		_memoryLRU += res->size();
 #if SCI_VERBOSE_RESMAN
 	debug("Adding %s (%d bytes) to lru control: %d bytes total",
 	      res->_id.toString().c_str(), res->size,
@@ -1154,30 +1244,91 @@ void ResourceManager::addToLRU(Resource *res) {
 void ResourceManager::printLRU() {
 	int mem = 0;
 	int entries = 0;
-	Common::List<Resource *>::iterator it = _LRU.begin();
-	Resource *res;
-
-	while (it != _LRU.end()) {
-		res = *it;
-		debug("\t%s: %u bytes", res->_id.toString().c_str(), res->size());
-		mem += res->size();
-		++entries;
-		++it;
+
+	for (int i = 0; i < kResourceCategoryCount; ++i) {
+		for (Resource *res = _LRU[i].newest; res; res = res->_lruNext) {
+			debug("\t%s: %u bytes", res->_id.toString().c_str(), res->size());
+			mem += res->size();
+			++entries;
+		}
 	}
 
 	debug("Total: %d entries, %d bytes (mgr says %d)", entries, mem, _memoryLRU);
 }
 
-void ResourceManager::freeOldResources() {
-	while (_maxMemoryLRU < _memoryLRU) {
-		assert(!_LRU.empty());
-		Resource *goner = _LRU.back();
-		removeFromLRU(goner);
-		goner->unalloc();
+void ResourceManager::evictResource(Resource *res) {
+	removeFromLRU(res);
+	++_resourceStats[getResourceCategory(res->getType())].evictions;
+	if (res->_prefetched)
+		++_prefetchStats.wasted;
+	res->unalloc();
+	res->_evicted = true;
 #ifdef SCI_VERBOSE_RESMAN
-		debug("resMan-debug: LRU: Freeing %s (%d bytes)", goner->_id.toString().c_str(), goner->size);
+	debug("resMan-debug: LRU: Freeing %s (%d bytes)", res->_id.toString().c_str(), res->size);
 #endif
+}
+
+void ResourceManager::freeOldResources() {
+	// Categories with a budget of their own only give up their own resources
+	for (int i = 0; i < kResourceCategoryCount; ++i) {
+		ResourceLRU &lru = _LRU[i];
+		while (lru.budget && lru.size > lru.budget)
+			evictResource(lru.oldest);
 	}
+
+	// Then the least recently used resources of all categories go first
+	while (_maxMemoryLRU < _memoryLRU) {
+		Resource *goner = nullptr;
+		for (int i = 0; i < kResourceCategoryCount; ++i) {
+			Resource *oldest = _LRU[i].oldest;
+			if (oldest && (!goner || (int32)(oldest->_lruStamp - goner->_lruStamp) < 0))
+				goner = oldest;
+		}
+		assert(goner);
+		evictResource(goner);
+	}
+}
+
+bool ResourceManager::fitsIntoLRU(const Resource *res) const {
+	if (res->_pinned)
+		return true;
+
+	const ResourceLRU &lru = _LRU[getResourceCategory(res->getType())];
+	return _memoryLRU + (int)res->size() <= _maxMemoryLRU &&
+		(!lru.budget || lru.size + res->size() <= lru.budget);
+}
+
+void ResourceManager::setMaxMemoryLRU(const int maxMemory) {
+	_maxMemoryLRU = maxMemory;
+	freeOldResources();
+}
+
+void ResourceManager::setLRUBudget(const ResourceCategory category, const uint32 budget) {
+	_LRU[category].budget = budget;
+	freeOldResources();
+}
+
+bool ResourceManager::pinResource(const ResourceId &id, const bool pin) {
+	Resource *res = testResource(id);
+	if (!res)
+		return false;
+	if (res->_pinned == pin)
+		return true;
+
+	const bool enqueued = (res->_status == kResStatusEnqueued);
+	if (enqueued)
+		removeFromLRU(res);
+	res->_pinned = pin;
+	if (enqueued)
+		addToLRU(res);
+
+	freeOldResources();
+	return true;
+}
+
+void ResourceManager::resetResourceStats() {
+	for (int i = 0; i < kResourceCategoryCount; ++i)
+		_resourceStats[i] = ResourceStats();
 }
 
 Common::List<ResourceId> ResourceManager::listResources(ResourceType type, int mapNumber) {
@@ -1216,9 +1367,30 @@ Resource *ResourceManager::findResource(ResourceId id, bool lock) {
 	if (!retval)
 		return NULL;
 
-	if (retval->_status == kResStatusNoMalloc)
+	if (retval->_prefetched) {
+		retval->_prefetched = false;
+		++_prefetchStats.hits;
+	}
+
+	ResourceStats &stats = _resourceStats[getResourceCategory(retval->getType())];
+	++stats.requests;
+	if (retval->_status == kResStatusNoMalloc) {
+		const uint32 startTime = g_system->getMillis();
 		loadResource(retval);
-	else if (retval->_status == kResStatusEnqueued)
+		++_prefetchStats.stalls;
+		_prefetchStats.stallTime += g_system->getMillis() - startTime;
+
+		++stats.loads;
+		stats.loadedBytes += retval->size();
+		if (retval->_evicted) {
+			++stats.reloads;
+			retval->_evicted = false;
+		}
+	} else {
+		++stats.hits;
+	}
+
+	if (retval->_status == kResStatusEnqueued)
 		// The resource is removed from its current position
 		// in the LRU list because it has been requested
 		// again. Below, it will either be locked, or it
@@ -1251,6 +1423,55 @@ Resource *ResourceManager::findResource(ResourceId id, bool lock) {
 	}
 }
 
+void ResourceManager::queuePrefetch(const ResourceId &id) {
+	if (!_prefetchEnabled || _prefetchQueued.contains(id))
+		return;
+
+	Resource *res = testResource(id);
+	if (!res || res->_status != kResStatusNoMalloc)
+		return;
+
+	_prefetchQueue.push(id);
+	_prefetchQueued.setVal(id, true);
+	++_prefetchStats.queued;
+}
+
+void ResourceManager::prefetchResources(const uint32 deadline) {
+	while (!_prefetchQueue.empty() && g_system->getMillis() < deadline) {
+		const ResourceId id = _prefetchQueue.pop();
+		_prefetchQueued.erase(id);
+
+		Resource *res = testResource(id);
+		if (!res || res->_status != kResStatusNoMalloc)
+			continue;
+
+		loadResource(res);
+		if (res->_status != kResStatusAllocated || !res->data())
+			continue;
+
+		if (!fitsIntoLRU(res)) {
+			res->unalloc();
+			++_prefetchStats.skipped;
+			continue;
+		}
+
+		addToLRU(res);
+		res->_prefetched = true;
+		_resourceStats[getResourceCategory(res->getType())].loadedBytes += res->size();
+		++_prefetchStats.prefetched;
+		_prefetchStats.prefetchedBytes += res->size();
+		debugC(2, kDebugLevelResMan, "[resMan] Prefetched %s", id.toString().c_str());
+	}
+}
+
+void ResourceManager::setPrefetchEnabled(const bool enable) {
+	_prefetchEnabled = enable;
+	if (!enable) {
+		_prefetchQueue.clear();
+		_prefetchQueued.clear();
+	}
+}
+
 void ResourceManager::unlockResource(Resource *res) {
 	assert(res);
 
@@ -26,6 +26,7 @@
 #include "common/str.h"
 #include "common/list.h"
 #include "common/hashmap.h"
+#include "common/queue.h"
 
 #include "sci/graphics/helpers.h"		// for ViewType
 #include "sci/resource/decompressor.h"
@@ -131,6 +132,21 @@ enum ResourceType {
 const char *getResourceTypeName(ResourceType restype);
 const char *getResourceTypeExtension(ResourceType restype);
 
+/**
+ * Groups of resource types, each with its own LRU list and optional memory
+ * budget.
+ */
+enum ResourceCategory {
+	kResourceCategoryGraphics = 0, ///< Views, pictures, palettes, fonts and cursors
+	kResourceCategoryAudio,        ///< Sounds, synth patches, digital audio and lip sync data
+	kResourceCategoryScript,       ///< Scripts, heaps, vocabularies, texts and messages
+	kResourceCategoryOther,
+	kResourceCategoryCount
+};
+
+ResourceCategory getResourceCategory(ResourceType restype);
+const char *getResourceCategoryName(ResourceCategory category);
+
 enum ResVersion {
 	kResVersionUnknown,
 	kResVersionSci0Sci1Early,
@@ -298,6 +314,12 @@ protected:
 	int32 _fileOffset; /**< Offset in file */
 	ResourceStatus _status;
 	uint16 _lockers; /**< Number of places where this resource was locked */
+	bool _prefetched; /**< Loaded by the prefetcher and not requested since */
+	bool _pinned; /**< Never freed by the LRU, see ResourceManager::pinResource */
+	bool _evicted; /**< Freed by the LRU and not loaded again since */
+	Resource *_lruPrev; /**< The next more recently used resource in the LRU list */
+	Resource *_lruNext; /**< The next less recently used resource in the LRU list */
+	uint32 _lruStamp; /**< When the resource was last put into the LRU list */
 	ResourceSource *_source;
 	ResourceManager *_resMan;
 
@@ -391,6 +413,84 @@ public:
 	 */
 	Common::List<ResourceId> listResources(ResourceType type, int mapNumber = -1);
 
+	/**
+	 * Queues a resource to be loaded ahead of its use. Resources which do not
+	 * exist or are already loaded are ignored.
+	 */
+	void queuePrefetch(const ResourceId &id);
+
+	/**
+	 * Loads queued resources until the given time (in milliseconds, as
+	 * returned by OSystem::getMillis) has passed or the queue is empty.
+	 * Prefetched resources are put under LRU control, but only while they
+	 * fit into the LRU memory limit, so that prefetching never pushes out
+	 * resources which were actually used.
+	 */
+	void prefetchResources(const uint32 deadline);
+
+	void setPrefetchEnabled(const bool enable);
+	bool isPrefetchEnabled() const { return _prefetchEnabled; }
+	uint getPrefetchQueueSize() const { return _prefetchQueue.size(); }
+
+	struct PrefetchStats {
+		uint32 queued;
+		uint32 prefetched;
+		uint32 prefetchedBytes;
+		uint32 hits;      ///< Prefetched resources which were requested later
+		uint32 wasted;    ///< Prefetched resources which were freed unused
+		uint32 skipped;   ///< Queued resources which did not fit into the LRU
+		uint32 stalls;    ///< Resources which were loaded on request
+		uint32 stallTime; ///< Time spent loading resources on request, in ms
+
+		PrefetchStats() : queued(0), prefetched(0), prefetchedBytes(0), hits(0), wasted(0), skipped(0), stalls(0), stallTime(0) {}
+	};
+
+	const PrefetchStats &getPrefetchStats() const { return _prefetchStats; }
+	void resetPrefetchStats() { _prefetchStats = PrefetchStats(); }
+
+	/**
+	 * Sets the maximum amount of memory for all unlocked resources, in bytes.
+	 */
+	void setMaxMemoryLRU(const int maxMemory);
+	int getMaxMemoryLRU() const { return _maxMemoryLRU; }
+	int getMemoryLRU() const { return _memoryLRU; }
+	int getMemoryLocked() const { return _memoryLocked; }
+
+	/**
+	 * Sets the maximum amount of memory for the unlocked resources of the
+	 * given category, in bytes. When it is exceeded, the least recently used
+	 * resources of the category are freed, even when there is memory left
+	 * under the overall limit. 0 removes the budget.
+	 */
+	void setLRUBudget(const ResourceCategory category, const uint32 budget);
+	uint32 getLRUBudget(const ResourceCategory category) const { return _LRU[category].budget; }
+	uint32 getLRUMemory(const ResourceCategory category) const { return _LRU[category].size; }
+	uint getLRUCount(const ResourceCategory category) const { return _LRU[category].count; }
+	uint32 getPinnedMemory() const { return _pinnedLRU.size; }
+	uint getPinnedCount() const { return _pinnedLRU.count; }
+
+	/**
+	 * Pins a resource, so that it stays in memory once it is loaded, even when
+	 * it is not locked, or unpins it. Pinned resources do not count against
+	 * the memory limits of the LRU.
+	 * @return false if the resource does not exist
+	 */
+	bool pinResource(const ResourceId &id, const bool pin);
+
+	struct ResourceStats {
+		uint32 requests;
+		uint32 hits;      ///< Requests for resources which were in memory
+		uint32 loads;
+		uint32 reloads;   ///< Loads of resources which the LRU had freed before
+		uint32 evictions;
+		uint64 loadedBytes; ///< Bytes of resource data read and decompressed
+
+		ResourceStats() : requests(0), hits(0), loads(0), reloads(0), evictions(0), loadedBytes(0) {}
+	};
+
+	const ResourceStats &getResourceStats(const ResourceCategory category) const { return _resourceStats[category]; }
+	void resetResourceStats();
+
 	/**
 	 * Returns if there are any resources of the specified type.
 	 */
@@ -489,7 +589,29 @@ protected:
 	SourcesList _sources;
 	int _memoryLocked;	///< Amount of resource bytes in locked memory
 	int _memoryLRU;		///< Amount of resource bytes under LRU control
-	Common::List<Resource *> _LRU; ///< Last Resource Used list
+
+	/**
+	 * An intrusive list of unlocked resources, from the most to the least
+	 * recently used.
+	 */
+	struct ResourceLRU {
+		Resource *newest;
+		Resource *oldest;
+		uint32 size;   ///< Amount of resource bytes in the list
+		uint count;
+		uint32 budget; ///< Maximum size of the list, 0 for no limit of its own
+
+		ResourceLRU() : newest(nullptr), oldest(nullptr), size(0), count(0), budget(0) {}
+	};
+
+	ResourceLRU _LRU[kResourceCategoryCount]; ///< Last Resource Used lists, by category
+	ResourceLRU _pinnedLRU; ///< Unlocked pinned resources, which are never freed
+	uint32 _lruStamp; ///< Stamp of the resource which was put into an LRU list last
+	ResourceStats _resourceStats[kResourceCategoryCount];
+	bool _prefetchEnabled;
+	Common::Queue<ResourceId> _prefetchQueue; ///< Resources to load ahead of their use
+	Common::HashMap<ResourceId, bool, ResourceIdHash> _prefetchQueued; ///< Resources in the prefetch queue
+	PrefetchStats _prefetchStats;
 	ResourceMap _resMap;
 	Common::List<Common::File *> _volumeFiles; ///< list of opened volume files
 	ResourceSource *_audioMapSCI1; ///< Currently loaded audio map for SCI1
@@ -635,6 +757,18 @@ protected:
 	void printLRU();
 	void addToLRU(Resource *res);
 	void removeFromLRU(Resource *res);
+	ResourceLRU &getLRU(const Resource *res);
+
+	/**
+	 * Frees a resource under LRU control to make room for others.
+	 */
+	void evictResource(Resource *res);
+
+	/**
+	 * Determines whether a resource can be put under LRU control without
+	 * freeing other resources.
+	 */
+	bool fitsIntoLRU(const Resource *res) const;
 
 	ResourceCompression getViewCompression();
 	ViewType detectViewType();
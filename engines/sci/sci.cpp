@@ -37,6 +37,7 @@
 #include "sci/engine/guest_additions.h"
 #include "sci/engine/message.h"
 #include "sci/engine/object.h"
+#include "sci/engine/savegame.h"
 #include "sci/engine/state.h"
 #include "sci/engine/kernel.h"
 #include "sci/engine/script.h"	// for script_adjust_opcode_formats
@@ -128,6 +129,7 @@ SciEngine::SciEngine(OSystem *syst, const ADGameDescription *desc, SciGameId gam
 	_vocabulary(nullptr),
 	_vocabularyLanguage(1), // we load english vocabulary on startup
 	_eventMan(nullptr),
+	_savegameWriter(nullptr),
 	_gameObjectAddress(),
 	_console(nullptr),
 	_rng("sci"),
@@ -136,6 +138,8 @@ SciEngine::SciEngine(OSystem *syst, const ADGameDescription *desc, SciGameId gam
 	assert(g_sci == nullptr);
 	g_sci = this;
 
+	_savegameWriter = new SavegameWriter();
+
 	const Common::FSNode gameDataDir(ConfMan.get("path"));
 
 	SearchMan.addSubDirectoryMatching(gameDataDir, "actors");	// KQ6 hi-res portraits
@@ -200,6 +204,9 @@ SciEngine::SciEngine(OSystem *syst, const ADGameDescription *desc, SciGameId gam
 }
 
 SciEngine::~SciEngine() {
+	// Finish a savegame which is still being written
+	delete _savegameWriter;
+
 #ifdef ENABLE_SCI32
 	delete _gfxControls32;
 	delete _gfxPaint32;
@@ -868,6 +875,11 @@ void SciEngine::sleep(uint32 msecs) {
 			g_sci->_gfxFrameout->updateScreen();
 		}
 #endif
+		// Use the idle time to write a pending savegame, then to load
+		// resources the current room will need
+		_savegameWriter->update(wakeUpTime - MIN<uint32>(msecs, 10));
+		_resMan->prefetchResources(wakeUpTime - MIN<uint32>(msecs, 10));
+
 		time = g_system->getMillis();
 		if (time + 10 < wakeUpTime) {
 			g_system->delayMillis(10);
@@ -911,6 +923,10 @@ void SciEngine::setLauncherLanguage() {
 }
 
 void SciEngine::pauseEngineIntern(bool pause) {
+	// The ScummVM menu may list or load the savegames
+	if (pause)
+		_savegameWriter->flush();
+
 	_mixer->pauseAll(pause);
 	if (_soundCmd)
 		_soundCmd->pauseAll(pause);
@@ -58,6 +58,7 @@ class SoundCommandParser;
 class EventManager;
 class SegManager;
 class ScriptPatcher;
+class SavegameWriter;
 class Sync;
 
 class GfxAnimate;
@@ -175,6 +176,7 @@ public:
 	inline EngineState *getEngineState() const { return _gamestate; }
 	inline Vocabulary *getVocabulary() const { return _vocabulary; }
 	inline EventManager *getEventManager() const { return _eventMan; }
+	inline SavegameWriter *getSavegameWriter() const { return _savegameWriter; }
 	inline reg_t getGameObject() const { return _gameObjectAddress; } // Gets the game object VM address
 
 	Common::RandomSource &getRNG() { return _rng; }
@@ -328,6 +330,7 @@ private:
 	Vocabulary *_vocabulary;
 	int16 _vocabularyLanguage;
 	EventManager *_eventMan;
+	SavegameWriter *_savegameWriter; /**< Writes savegames in the background */
 	reg_t _gameObjectAddress; /**< Pointer to the game object */
 	Console *_console;
 	Common::RandomSource _rng;
@@ -97,6 +97,9 @@ ScummDebugger::ScummDebugger(ScummEngine *s)
 	registerCmd("imuse",     WRAP_METHOD(ScummDebugger, Cmd_IMuse));
 
 	registerCmd("resetcursors",    WRAP_METHOD(ScummDebugger, Cmd_ResetCursors));
+
+	registerCmd("stripcache", WRAP_METHOD(ScummDebugger, Cmd_StripCache));
+	registerCmd("stripbench", WRAP_METHOD(ScummDebugger, Cmd_StripBenchmark));
 }
 
 ScummDebugger::~ScummDebugger() {
@@ -845,4 +848,48 @@ bool ScummDebugger::Cmd_ResetCursors(int argc, const char **argv) {
 	return false;
 }
 
+bool ScummDebugger::Cmd_StripCache(int argc, const char **argv) {
+	Gdi *gdi = _vm->_gdi;
+
+	if (argc == 2 && !strcmp(argv[1], "reset")) {
+		gdi->resetStripCacheStats();
+	} else if (argc == 2 && (!strcmp(argv[1], "on") || !strcmp(argv[1], "off"))) {
+		gdi->setStripCacheEnabled(!strcmp(argv[1], "on"));
+	} else if (argc == 3 && !strcmp(argv[1], "rows")) {
+		gdi->setRowDecoding(!strcmp(argv[2], "on"));
+	} else if (argc != 1) {
+		debugPrintf("Usage: %s [on | off | rows on|off | reset]\n", argv[0]);
+		return true;
+	}
+
+	const StripCacheStats &stats = gdi->getStripCacheStats();
+	debugPrintf("Strip cache: %s, row decoding: %s\n",
+		gdi->isStripCacheEnabled() ? "on" : "off", gdi->isRowDecoding() ? "on" : "off");
+	debugPrintf("Strips: %u hits, %u misses, %u not cacheable\n", stats.hits, stats.misses, stats.uncached);
+	debugPrintf("Z-plane masks: %u hits, %u misses\n", stats.maskHits, stats.maskMisses);
+	debugPrintf("Invalidations: %u\n", stats.invalidations);
+	return true;
+}
+
+bool ScummDebugger::Cmd_StripBenchmark(int argc, const char **argv) {
+	const int iterations = (argc > 1) ? atoi(argv[1]) : 20;
+	if (!_vm->_roomResource || iterations <= 0) {
+		debugPrintf("Usage: %s [<iterations>], in a room\n", argv[0]);
+		return true;
+	}
+
+	const byte *room = _vm->getResourceAddress(_vm->_game.heversion >= 70 ? rtRoomImage : rtRoom, _vm->_roomResource);
+	StripBenchmark result;
+	if (!_vm->_gdi->benchmarkStrips(room + _vm->_IM00_offs, _vm->_virtscr[kMainVirtScreen].h, iterations, result)) {
+		debugPrintf("This game does not use the strip codecs\n");
+		return true;
+	}
+
+	debugPrintf("Room %d, %u strips, %u of them with row decoders, %u decoded differently\n",
+		_vm->_roomResource, result.strips, result.rowStrips, result.mismatches);
+	debugPrintf("Decoding the room %d times: original %u ms, by rows %u ms, from the strip cache %u ms\n",
+		iterations, result.originalTime, result.rowTime, result.cachedTime);
+	return true;
+}
+
 } // End of namespace Scumm
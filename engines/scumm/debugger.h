@@ -69,6 +69,9 @@ private:
 
 	bool Cmd_ResetCursors(int argc, const char **argv);
 
+	bool Cmd_StripCache(int argc, const char **argv);
+	bool Cmd_StripBenchmark(int argc, const char **argv);
+
 	void printBox(int box);
 	void drawBox(int box);
 };
@@ -20,6 +20,14 @@
  *
  */
 
+#if defined(__SSE2__)
+#define USE_SSE2_STRIP_ROWS
+#include <emmintrin.h>
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#define USE_NEON_STRIP_ROWS
+#include <arm_neon.h>
+#endif
+
 #include "common/system.h"
 #include "scumm/actor.h"
 #include "scumm/charset.h"
@@ -215,6 +223,15 @@ Gdi::Gdi(ScummEngine *vm) : _vm(vm) {
 	_zbufferDisabled = false;
 	_objectMode = false;
 	_distaff = false;
+
+	_roomBackground = false;
+	_stripCache.smap = nullptr;
+	_stripCache.numStrips = 0;
+	_stripCache.height = 0;
+	memset(_stripCache.palette, 0, sizeof(_stripCache.palette));
+	_stripCacheEnabled = true;
+	resetStripCacheStats();
+	_rowDecoding = true;
 }
 
 Gdi::~Gdi() {
@@ -275,6 +292,7 @@ void Gdi::init() {
 }
 
 void Gdi::roomChanged(byte *roomptr) {
+	invalidateStripCache();
 }
 
 void GdiNES::roomChanged(byte *roomptr) {
@@ -1031,7 +1049,7 @@ void ScummEngine::redrawBGStrip(int start, int num) {
 	else
 		room = getResourceAddress(rtRoom, _roomResource);
 
-	_gdi->drawBitmap(room + _IM00_offs, &_virtscr[kMainVirtScreen], s, 0, _roomWidth, _virtscr[kMainVirtScreen].h, s, num, 0);
+	_gdi->drawBitmap(room + _IM00_offs, &_virtscr[kMainVirtScreen], s, 0, _roomWidth, _virtscr[kMainVirtScreen].h, s, num, Gdi::dbRoomBackground);
 }
 
 void ScummEngine::restoreBackground(Common::Rect rect, byte backColor) {
@@ -1854,6 +1872,12 @@ void Gdi::drawBitmap(const byte *ptr, VirtScreen *vs, int x, const int y, const
 	_objectMode = (flag & dbObjectMode) == dbObjectMode;
 	prepareDrawBitmap(ptr, vs, x, y, width, height, stripnr, numstrip);
 
+	// The strips of the room background are the same every time, unless the
+	// room palette was changed in the meantime
+	_roomBackground = (flag & dbRoomBackground) && _stripCacheEnabled && y == 0 && _vm->_bytesPerPixel == 1;
+	if (_roomBackground)
+		validateStripCache(smap_ptr, MAX(_vm->_roomWidth, (int)vs->w) / 8, height);
+
 	sx = x - vs->xstart / 8;
 	if (sx < 0) {
 		numstrip -= -sx;
@@ -1930,6 +1954,25 @@ void Gdi::drawBitmap(const byte *ptr, VirtScreen *vs, int x, const int y, const
 
 bool Gdi::drawStrip(byte *dstPtr, VirtScreen *vs, int x, int y, const int width, const int height,
 					int stripnr, const byte *smap_ptr) {
+	const byte *src = getStripData(smap_ptr, stripnr);
+
+	// Indy4 Amiga always uses the room or verb palette map to match colors to
+	// the currently setup palette, thus we need to select it over here too.
+	// Done like the original interpreter.
+	if (_vm->_game.platform == Common::kPlatformAmiga && _vm->_game.id == GID_INDY4) {
+		if (vs->number == kVerbVirtScreen)
+			_roomPalette = _vm->_verbPalette;
+		else
+			_roomPalette = _vm->_roomPalette;
+	}
+
+	if (_roomBackground)
+		return drawCachedStrip(dstPtr, vs->pitch, stripnr, src, height);
+
+	return decompressBitmap(dstPtr, vs->pitch, src, height);
+}
+
+const byte *Gdi::getStripData(const byte *smap_ptr, int stripnr) const {
 	// Do some input verification and make sure the strip/strip offset
 	// are actually valid. Normally, this should never be a problem,
 	// but if e.g. a savegame gets corrupted, we can easily get into
@@ -1957,17 +2000,150 @@ bool Gdi::drawStrip(byte *dstPtr, VirtScreen *vs, int x, int y, const int width,
 	}
 	assertRange(0, offset, smapLen-1, "screen strip");
 
-	// Indy4 Amiga always uses the room or verb palette map to match colors to
-	// the currently setup palette, thus we need to select it over here too.
-	// Done like the original interpreter.
-	if (_vm->_game.platform == Common::kPlatformAmiga && _vm->_game.id == GID_INDY4) {
-		if (vs->number == kVerbVirtScreen)
-			_roomPalette = _vm->_verbPalette;
-		else
-			_roomPalette = _vm->_roomPalette;
+	return smap_ptr + offset;
+}
+
+/**
+ * Draws a strip of the room background from the strip cache, or decodes it
+ * and adds it to the cache. Only strips which cover all their pixels can be
+ * cached: transparent strips show what was drawn before them, and EGA strips
+ * may repeat pixels of the strip to their left.
+ */
+bool Gdi::drawCachedStrip(byte *dst, int dstPitch, int stripnr, const byte *src, int height) {
+	if (stripnr < 0 || stripnr >= _stripCache.numStrips)
+		return decompressBitmap(dst, dstPitch, src, height);
+
+	byte *pixels = &_stripCache.pixels[stripnr * 8 * height];
+	if (_stripCache.decoded[stripnr] & 1) {
+		_stripCacheStats.hits++;
+		blit(dst, dstPitch, pixels, 8, 8, height, 1);
+		return false;
 	}
 
-	return decompressBitmap(dstPtr, vs->pitch, smap_ptr + offset, height);
+	const bool transpStrip = decompressBitmap(dst, dstPitch, src, height);
+	if (transpStrip || (_vm->_game.features & GF_16COLOR) || *src == 10 || *src == 149) {
+		_stripCacheStats.uncached++;
+		return transpStrip;
+	}
+
+	_stripCacheStats.misses++;
+	blit(pixels, 8, dst, dstPitch, 8, height, 1);
+	_stripCache.decoded[stripnr] |= 1;
+	return false;
+}
+
+byte *Gdi::getCachedMask(int stripnr, int zplane, int height) {
+	if (stripnr < 0 || stripnr >= _stripCache.numStrips)
+		return nullptr;
+
+	const uint size = zplane * _stripCache.numStrips * height;
+	if (_stripCache.masks.size() < size)
+		_stripCache.masks.resize(size);
+	return &_stripCache.masks[((zplane - 1) * _stripCache.numStrips + stripnr) * height];
+}
+
+void Gdi::validateStripCache(const byte *smap_ptr, int numStrips, int height) {
+	if (_stripCache.smap == smap_ptr && _stripCache.numStrips == numStrips && _stripCache.height == height &&
+		!memcmp(_stripCache.palette, _vm->_roomPalette, sizeof(_stripCache.palette)))
+		return;
+
+	invalidateStripCache();
+	_stripCache.smap = smap_ptr;
+	_stripCache.numStrips = numStrips;
+	_stripCache.height = height;
+	memcpy(_stripCache.palette, _vm->_roomPalette, sizeof(_stripCache.palette));
+	_stripCache.pixels.resize(numStrips * 8 * height);
+	_stripCache.decoded.resize(numStrips);
+}
+
+void Gdi::invalidateStripCache() {
+	if (_stripCache.smap)
+		_stripCacheStats.invalidations++;
+
+	_stripCache.smap = nullptr;
+	_stripCache.numStrips = 0;
+	_stripCache.height = 0;
+	_stripCache.pixels.clear();
+	_stripCache.masks.clear();
+	_stripCache.decoded.clear();
+}
+
+void Gdi::setStripCacheEnabled(bool enable) {
+	_stripCacheEnabled = enable;
+	if (!enable)
+		invalidateStripCache();
+}
+
+void Gdi::resetStripCacheStats() {
+	memset(&_stripCacheStats, 0, sizeof(_stripCacheStats));
+}
+
+/**
+ * Decodes all strips of a room image with the original decoders and with the
+ * row decoders, and compares the results. Then times decoding the strips both
+ * ways, and drawing them from the strip cache, into a buffer as wide as the
+ * room. Returns false if the game does not use these codecs.
+ */
+bool Gdi::benchmarkStrips(const byte *ptr, int height, int iterations, StripBenchmark &result) {
+	memset(&result, 0, sizeof(result));
+	if (_vm->_game.version <= 2 || _vm->_game.heversion >= 70 || _vm->_bytesPerPixel != 1 ||
+		_vm->_game.platform == Common::kPlatformNES || _vm->_game.platform == Common::kPlatformPCEngine)
+		return false;
+
+	const byte *smap_ptr = ptr;
+	if (!(_vm->_game.features & GF_SMALL_HEADER) && _vm->_game.version != 8) {
+		smap_ptr = _vm->findResource(MKTAG('S','M','A','P'), ptr);
+		assert(smap_ptr);
+	}
+
+	// EGA strips may read the pixel to the left of the first strip
+	const int numStrips = _vm->_roomWidth / 8;
+	const int pitch = numStrips * 8;
+	Common::Array<byte> original(pitch * height + 8), rows(pitch * height + 8), cache(pitch * height);
+	const uint32 vertStripNextInc = _vertStripNextInc;
+	const bool rowDecoding = _rowDecoding;
+	_vertStripNextInc = height * pitch - 1;
+
+	for (int strip = 0; strip < numStrips; strip++) {
+		const byte *src = getStripData(smap_ptr, strip);
+		const int codec = *src / 10, shift = *src % 10;
+		if (!(_vm->_game.features & GF_16COLOR) && shift >= 4 && shift <= 8 && codec != 5 && codec != 7 && codec != 9 && codec != 11 && codec <= 12)
+			result.rowStrips++;
+		result.strips++;
+
+		_rowDecoding = false;
+		decompressBitmap(&original[8 + strip * 8], pitch, src, height);
+		_rowDecoding = true;
+		decompressBitmap(&rows[8 + strip * 8], pitch, src, height);
+		for (int y = 0; y < height; y++) {
+			if (memcmp(&original[8 + y * pitch + strip * 8], &rows[8 + y * pitch + strip * 8], 8)) {
+				result.mismatches++;
+				break;
+			}
+		}
+		blit(&cache[strip * 8 * height], 8, &original[8 + strip * 8], pitch, 8, height, 1);
+	}
+
+	for (int mode = 0; mode < 2; mode++) {
+		_rowDecoding = (mode == 1);
+		const uint32 start = g_system->getMillis();
+		for (int i = 0; i < iterations; i++) {
+			for (int strip = 0; strip < numStrips; strip++)
+				decompressBitmap(&rows[8 + strip * 8], pitch, getStripData(smap_ptr, strip), height);
+		}
+		(mode == 1 ? result.rowTime : result.originalTime) = g_system->getMillis() - start;
+	}
+
+	const uint32 start = g_system->getMillis();
+	for (int i = 0; i < iterations; i++) {
+		for (int strip = 0; strip < numStrips; strip++)
+			blit(&rows[8 + strip * 8], pitch, &cache[strip * 8 * height], 8, 8, height, 1);
+	}
+	result.cachedTime = g_system->getMillis() - start;
+
+	_rowDecoding = rowDecoding;
+	_vertStripNextInc = vertStripNextInc;
+	return true;
 }
 
 bool GdiNES::drawStrip(byte *dstPtr, VirtScreen *vs, int x, int y, const int width, const int height,
@@ -2045,6 +2221,17 @@ void Gdi::decodeMask(int x, int y, const int width, const int height,
 			if (!zplane_list[i])
 				continue;
 
+			mask_ptr = getMaskBuffer(x, y, i);
+
+			// The masks of the room background are cached with its strips
+			byte *cached = _roomBackground ? getCachedMask(stripnr, i, height) : nullptr;
+			if (cached && (_stripCache.decoded[stripnr] & (1 << i))) {
+				_stripCacheStats.maskHits++;
+				for (int h = 0; h < height; h++)
+					mask_ptr[h * _numStrips] = cached[h];
+				continue;
+			}
+
 			if (_vm->_game.features & GF_OLD_BUNDLE)
 				offs = READ_LE_UINT16(zplane_list[i] + stripnr * 2);
 			else if (_vm->_game.features & GF_OLD256)
@@ -2056,8 +2243,6 @@ void Gdi::decodeMask(int x, int y, const int width, const int height,
 			else
 				offs = READ_LE_UINT16(zplane_list[i] + stripnr * 2 + 8);
 
-			mask_ptr = getMaskBuffer(x, y, i);
-
 			if (offs) {
 				z_plane_ptr = zplane_list[i] + offs;
 
@@ -2072,6 +2257,13 @@ void Gdi::decodeMask(int x, int y, const int width, const int height,
 					for (int h = 0; h < height; h++)
 						mask_ptr[h * _numStrips] = 0;
 			}
+
+			if (cached) {
+				_stripCacheStats.maskMisses++;
+				for (int h = 0; h < height; h++)
+					cached[h] = mask_ptr[h * _numStrips];
+				_stripCache.decoded[stripnr] |= 1 << i;
+			}
 		}
 	}
 }
@@ -3468,6 +3660,109 @@ void Gdi::drawStrip3DO(byte *dst, int dstPitch, const byte *src, int height, con
 }
 
 
+#pragma mark -
+#pragma mark --- Row decoders ---
+#pragma mark -
+
+// The strips of the common codecs can be decoded by rows instead of writing
+// their pixels one by one: the codec decodes the color indices of the whole
+// strip into a buffer, which is then mapped through the room palette and
+// stored a row of 8 pixels at a time. Only 8 bit strips of screen height
+// are decoded this way.
+static const int kMaxRowDecodingHeight = 480;
+
+// Turns the 8 columns of a strip into rows: src holds the columns one after
+// the other, as drawStripBasicV() decodes them, dst receives rows of 8 bytes
+static void transposeStrip(byte *dst, const byte *src, int height) {
+	int y = 0;
+#if defined(USE_SSE2_STRIP_ROWS)
+	for (; y + 8 <= height; y += 8) {
+		const byte *col = src + y;
+		const __m128i c01 = _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i *)col), _mm_loadl_epi64((const __m128i *)(col + height)));
+		const __m128i c23 = _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i *)(col + 2 * height)), _mm_loadl_epi64((const __m128i *)(col + 3 * height)));
+		const __m128i c45 = _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i *)(col + 4 * height)), _mm_loadl_epi64((const __m128i *)(col + 5 * height)));
+		const __m128i c67 = _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i *)(col + 6 * height)), _mm_loadl_epi64((const __m128i *)(col + 7 * height)));
+		// Columns 0-3 and 4-7 of rows 0-3 and 4-7
+		const __m128i lo03 = _mm_unpacklo_epi16(c01, c23);
+		const __m128i hi03 = _mm_unpackhi_epi16(c01, c23);
+		const __m128i lo47 = _mm_unpacklo_epi16(c45, c67);
+		const __m128i hi47 = _mm_unpackhi_epi16(c45, c67);
+		__m128i *rows = (__m128i *)(dst + y * 8);
+		_mm_storeu_si128(rows, _mm_unpacklo_epi32(lo03, lo47));
+		_mm_storeu_si128(rows + 1, _mm_unpackhi_epi32(lo03, lo47));
+		_mm_storeu_si128(rows + 2, _mm_unpacklo_epi32(hi03, hi47));
+		_mm_storeu_si128(rows + 3, _mm_unpackhi_epi32(hi03, hi47));
+	}
+#elif defined(USE_NEON_STRIP_ROWS)
+	for (; y + 8 <= height; y += 8) {
+		const byte *col = src + y;
+		const uint8x8x2_t c01 = vzip_u8(vld1_u8(col), vld1_u8(col + height));
+		const uint8x8x2_t c23 = vzip_u8(vld1_u8(col + 2 * height), vld1_u8(col + 3 * height));
+		const uint8x8x2_t c45 = vzip_u8(vld1_u8(col + 4 * height), vld1_u8(col + 5 * height));
+		const uint8x8x2_t c67 = vzip_u8(vld1_u8(col + 6 * height), vld1_u8(col + 7 * height));
+		// Columns 0-3 and 4-7 of rows 0-3 and 4-7
+		const uint16x8x2_t c03 = vzipq_u16(vreinterpretq_u16_u8(vcombine_u8(c01.val[0], c01.val[1])),
+		                                   vreinterpretq_u16_u8(vcombine_u8(c23.val[0], c23.val[1])));
+		const uint16x8x2_t c47 = vzipq_u16(vreinterpretq_u16_u8(vcombine_u8(c45.val[0], c45.val[1])),
+		                                   vreinterpretq_u16_u8(vcombine_u8(c67.val[0], c67.val[1])));
+		const uint32x4x2_t lo = vzipq_u32(vreinterpretq_u32_u16(c03.val[0]), vreinterpretq_u32_u16(c47.val[0]));
+		const uint32x4x2_t hi = vzipq_u32(vreinterpretq_u32_u16(c03.val[1]), vreinterpretq_u32_u16(c47.val[1]));
+		byte *rows = dst + y * 8;
+		vst1q_u8(rows, vreinterpretq_u8_u32(lo.val[0]));
+		vst1q_u8(rows + 16, vreinterpretq_u8_u32(lo.val[1]));
+		vst1q_u8(rows + 32, vreinterpretq_u8_u32(hi.val[0]));
+		vst1q_u8(rows + 48, vreinterpretq_u8_u32(hi.val[1]));
+	}
+#endif
+	for (; y < height; y++) {
+		for (int x = 0; x < 8; x++)
+			dst[y * 8 + x] = src[x * height + y];
+	}
+}
+
+// Stores the pixels of a row whose color index is not the transparent one
+static inline void blendStripRow(byte *dst, const byte *pixels, const byte *indices, byte transparentColor) {
+#if defined(USE_SSE2_STRIP_ROWS)
+	const __m128i transparent = _mm_cmpeq_epi8(_mm_loadl_epi64((const __m128i *)indices), _mm_set1_epi8((char)transparentColor));
+	const __m128i row = _mm_or_si128(_mm_and_si128(transparent, _mm_loadl_epi64((const __m128i *)dst)),
+	                                 _mm_andnot_si128(transparent, _mm_loadl_epi64((const __m128i *)pixels)));
+	_mm_storel_epi64((__m128i *)dst, row);
+#elif defined(USE_NEON_STRIP_ROWS)
+	const uint8x8_t transparent = vceq_u8(vld1_u8(indices), vdup_n_u8(transparentColor));
+	vst1_u8(dst, vbsl_u8(transparent, vld1_u8(dst), vld1_u8(pixels)));
+#else
+	for (int x = 0; x < 8; x++) {
+		if (indices[x] != transparentColor)
+			dst[x] = pixels[x];
+	}
+#endif
+}
+
+bool Gdi::useRowDecoding(int height) const {
+	// writeRoomColor() is only overridden for 16 bit graphics
+	return _rowDecoding && _vm->_bytesPerPixel == 1 && height <= kMaxRowDecodingHeight;
+}
+
+void Gdi::drawStripRows(byte *dst, int dstPitch, const byte *indices, int height, const bool transpCheck) const {
+	const byte *palette = _roomPalette;
+	const byte paletteMod = _paletteMod;
+	byte pixels[8];
+
+	do {
+		// Same as writeRoomColor()
+		for (int x = 0; x < 8; x++)
+			pixels[x] = palette[(indices[x] + paletteMod) & 0xFF];
+
+		if (transpCheck)
+			blendStripRow(dst, pixels, indices, _transparentColor);
+		else
+			memcpy(dst, pixels, 8);
+
+		indices += 8;
+		dst += dstPitch;
+	} while (--height);
+}
+
 #define READ_BIT (cl--, bit = bits & 1, bits >>= 1, bit)
 #define FILL_BITS do {              \
 		if (cl <= 8) {              \
@@ -3477,6 +3772,13 @@ void Gdi::drawStrip3DO(byte *dst, int dstPitch, const byte *src, int height, con
 	} while (0)
 
 void Gdi::drawStripComplex(byte *dst, int dstPitch, const byte *src, int height, const bool transpCheck) const {
+	if (useRowDecoding(height)) {
+		byte indices[8 * kMaxRowDecodingHeight];
+		decodeStripComplex(indices, src, 8 * height);
+		drawStripRows(dst, dstPitch, indices, height, transpCheck);
+		return;
+	}
+
 	byte color = *src++;
 	uint bits = *src++;
 	byte cl = 8;
@@ -3529,6 +3831,13 @@ void Gdi::drawStripComplex(byte *dst, int dstPitch, const byte *src, int height,
 }
 
 void Gdi::drawStripBasicH(byte *dst, int dstPitch, const byte *src, int height, const bool transpCheck) const {
+	if (useRowDecoding(height)) {
+		byte indices[8 * kMaxRowDecodingHeight];
+		decodeStripBasic(indices, src, 8 * height);
+		drawStripRows(dst, dstPitch, indices, height, transpCheck);
+		return;
+	}
+
 	byte color = *src++;
 	uint bits = *src++;
 	byte cl = 8;
@@ -3561,6 +3870,16 @@ void Gdi::drawStripBasicH(byte *dst, int dstPitch, const byte *src, int height,
 }
 
 void Gdi::drawStripBasicV(byte *dst, int dstPitch, const byte *src, int height, const bool transpCheck) const {
+	if (useRowDecoding(height)) {
+		// The same codec as drawStripBasicH(), by columns
+		byte columns[8 * kMaxRowDecodingHeight];
+		byte indices[8 * kMaxRowDecodingHeight];
+		decodeStripBasic(columns, src, 8 * height);
+		transposeStrip(indices, columns, height);
+		drawStripRows(dst, dstPitch, indices, height, transpCheck);
+		return;
+	}
+
 	byte color = *src++;
 	uint bits = *src++;
 	byte cl = 8;
@@ -3593,6 +3912,77 @@ void Gdi::drawStripBasicV(byte *dst, int dstPitch, const byte *src, int height,
 	} while (--x);
 }
 
+// The codecs of drawStripComplex() and drawStripBasicH/V(), decoding `count`
+// color indices into dst. The strips are 8 pixels wide, so their rows (or
+// columns) follow each other without gaps, and the decoders need not track
+// the end of a row.
+void Gdi::decodeStripComplex(byte *dst, const byte *src, int count) const {
+	byte *const end = dst + count;
+	byte color = *src++;
+	uint bits = *src++;
+	byte cl = 8;
+	byte bit;
+	byte incm, reps;
+
+	do {
+		FILL_BITS;
+		*dst++ = color;
+
+	againPos:
+		if (!READ_BIT) {
+		} else if (!READ_BIT) {
+			FILL_BITS;
+			color = bits & _decomp_mask;
+			bits >>= _decomp_shr;
+			cl -= _decomp_shr;
+		} else {
+			incm = (bits & 7) - 4;
+			cl -= 3;
+			bits >>= 3;
+			if (incm) {
+				color += incm;
+			} else {
+				FILL_BITS;
+				reps = bits & 0xFF;
+				do {
+					if (dst == end)
+						return;
+					*dst++ = color;
+				} while (--reps);
+				bits >>= 8;
+				bits |= (*src++) << (cl - 8);
+				goto againPos;
+			}
+		}
+	} while (dst != end);
+}
+
+void Gdi::decodeStripBasic(byte *dst, const byte *src, int count) const {
+	byte color = *src++;
+	uint bits = *src++;
+	byte cl = 8;
+	byte bit;
+	int8 inc = -1;
+
+	do {
+		FILL_BITS;
+		*dst++ = color;
+		if (!READ_BIT) {
+		} else if (!READ_BIT) {
+			FILL_BITS;
+			color = bits & _decomp_mask;
+			bits >>= _decomp_shr;
+			cl -= _decomp_shr;
+			inc = -1;
+		} else if (!READ_BIT) {
+			color += inc;
+		} else {
+			inc = -inc;
+			color += inc;
+		}
+	} while (--count);
+}
+
 #undef READ_BIT
 #undef FILL_BITS
 
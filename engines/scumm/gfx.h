@@ -24,6 +24,7 @@
 #define SCUMM_GFX_H
 
 #include "common/system.h"
+#include "common/array.h"
 #include "common/list.h"
 
 #include "graphics/surface.h"
@@ -202,6 +203,26 @@ struct ColorCycle {
 
 struct StripTable;
 
+/** Counters of the decoded strip cache, see Gdi::drawCachedStrip() */
+struct StripCacheStats {
+	uint32 hits;
+	uint32 misses;
+	uint32 uncached;	// transparent strips, which are decoded every time
+	uint32 maskHits;
+	uint32 maskMisses;
+	uint32 invalidations;
+};
+
+/** Results of Gdi::benchmarkStrips() */
+struct StripBenchmark {
+	uint32 strips;
+	uint32 rowStrips;	// strips of the codecs which have row decoders
+	uint32 mismatches;	// strips the row decoders decoded differently
+	uint32 originalTime;
+	uint32 rowTime;
+	uint32 cachedTime;
+};
+
 #define CHARSET_MASK_TRANSPARENCY	 0xFD
 #define CHARSET_MASK_TRANSPARENCY_32 0xFDFDFDFD
 
@@ -220,6 +241,30 @@ protected:
 	/** Flag which is true when an object is being rendered, false otherwise. */
 	bool _objectMode;
 
+	/** Flag which is true when the room background is being redrawn and its strips are cached. */
+	bool _roomBackground;
+
+	/**
+	 * Decoded strips of the room background, so that strips which scroll
+	 * back into view, or which are redrawn after an actor moved over them,
+	 * are not decoded again. The pixels of a strip are kept as rows of 8
+	 * bytes, the z-plane masks as one byte per row.
+	 */
+	struct StripCache {
+		const byte *smap;	// the image the strips were decoded from
+		int numStrips;
+		int height;
+		byte palette[256];	// the room palette they were decoded with
+		Common::Array<byte> pixels;
+		Common::Array<byte> masks;
+		Common::Array<uint16> decoded;	// bit 0 for the pixels, bit n for z-plane n
+	} _stripCache;
+	bool _stripCacheEnabled;
+	StripCacheStats _stripCacheStats;
+
+	/** Flag which is true when the common codecs are decoded by rows, see drawStripRows(). */
+	bool _rowDecoding;
+
 public:
 	/** Flag which is true when loading objects or titles for distaff, in PCEngine version of Loom. */
 	bool _distaff;
@@ -238,6 +283,11 @@ protected:
 	void drawStripBasicH(byte *dst, int dstPitch, const byte *src, int height, const bool transpCheck) const;
 	void drawStripBasicV(byte *dst, int dstPitch, const byte *src, int height, const bool transpCheck) const;
 
+	bool useRowDecoding(int height) const;
+	void decodeStripComplex(byte *dst, const byte *src, int count) const;
+	void decodeStripBasic(byte *dst, const byte *src, int count) const;
+	void drawStripRows(byte *dst, int dstPitch, const byte *indices, int height, const bool transpCheck) const;
+
 	void drawStripRaw(byte *dst, int dstPitch, const byte *src, int height, const bool transpCheck) const;
 	void unkDecode8(byte *dst, int dstPitch, const byte *src, int height) const;
 	void unkDecode9(byte *dst, int dstPitch, const byte *src, int height) const;
@@ -254,6 +304,13 @@ protected:
 
 	/* Misc */
 	int getZPlanes(const byte *smap_ptr, const byte *zplane_list[9], bool bmapImage) const;
+	const byte *getStripData(const byte *smap_ptr, int stripnr) const;
+
+	/* Decoded strip cache */
+	void validateStripCache(const byte *smap_ptr, int numStrips, int height);
+	void invalidateStripCache();
+	bool drawCachedStrip(byte *dst, int dstPitch, int stripnr, const byte *src, int height);
+	byte *getCachedMask(int stripnr, int zplane, int height);
 
 	virtual bool drawStrip(byte *dstPtr, VirtScreen *vs,
 					int x, int y, const int width, const int height,
@@ -290,10 +347,21 @@ public:
 
 	void resetBackground(int top, int bottom, int strip);
 
+	bool isStripCacheEnabled() const { return _stripCacheEnabled; }
+	void setStripCacheEnabled(bool enable);
+	const StripCacheStats &getStripCacheStats() const { return _stripCacheStats; }
+	void resetStripCacheStats();
+
+	bool isRowDecoding() const { return _rowDecoding; }
+	void setRowDecoding(bool enable) { _rowDecoding = enable; }
+
+	bool benchmarkStrips(const byte *ptr, int height, int iterations, StripBenchmark &result);
+
 	enum DrawBitmapFlags {
 		dbAllowMaskOr   = 1 << 0,
 		dbDrawMaskOnAll = 1 << 1,
-		dbObjectMode    = 2 << 2
+		dbObjectMode    = 2 << 2,
+		dbRoomBackground = 1 << 4
 	};
 };
 
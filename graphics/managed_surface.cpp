@@ -20,6 +20,14 @@
  *
  */
 
+#if defined(__SSE2__)
+#define USE_SSE2_BLIT
+#include <emmintrin.h>
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#define USE_NEON_BLIT
+#include <arm_neon.h>
+#endif
+
 #include "graphics/managed_surface.h"
 #include "common/algorithm.h"
 #include "common/textconsole.h"
@@ -680,6 +688,376 @@ void transBlit(const Surface &src, const Common::Rect &srcRect, ManagedSurface &
 	delete[] lookup;
 }
 
+static bool s_specializedBlits = true;
+#if defined(USE_SSE2_BLIT) || defined(USE_NEON_BLIT)
+static bool s_simdBlits = true;
+#endif
+
+bool setTransBlitKernels(bool specialized, bool simd) {
+	s_specializedBlits = specialized;
+#if defined(USE_SSE2_BLIT) || defined(USE_NEON_BLIT)
+	s_simdBlits = simd;
+	return true;
+#else
+	return false;
+#endif
+}
+
+namespace {
+
+/**
+ * Copy the pixels of a row which don't match the transparent color, keeping
+ * only the bits in colorMask. This matches what transBlitPixel does for
+ * formats without alpha.
+ */
+template<typename T>
+void keyedRow(const T *src, T *dest, int width, T transColor, T colorMask) {
+	for (int x = 0; x < width; ++x) {
+		const T srcVal = src[x];
+		if (srcVal != transColor)
+			dest[x] = srcVal & colorMask;
+	}
+}
+
+template<typename T>
+void keyedRowFlipped(const T *src, T *dest, int width, T transColor, T colorMask) {
+	for (int x = 0; x < width; ++x) {
+		const T srcVal = *src--;
+		if (srcVal != transColor)
+			dest[x] = srcVal & colorMask;
+	}
+}
+
+void keyedRowPalette(const byte *src, byte *dest, int width, byte transColor, const byte *lookup, bool flipped) {
+	const int step = flipped ? -1 : 1;
+	for (int x = 0; x < width; ++x, src += step) {
+		if (*src != transColor)
+			dest[x] = lookup[*src];
+	}
+}
+
+#if defined(USE_SSE2_BLIT)
+
+template<typename T>
+void keyedRowSimd(const T *src, T *dest, int width, T transColor, T colorMask) {
+	const int perVector = 16 / sizeof(T);
+	__m128i key, mask;
+	if (sizeof(T) == 1) {
+		key = _mm_set1_epi8((char)transColor);
+		mask = _mm_set1_epi8((char)colorMask);
+	} else if (sizeof(T) == 2) {
+		key = _mm_set1_epi16((short)transColor);
+		mask = _mm_set1_epi16((short)colorMask);
+	} else {
+		key = _mm_set1_epi32((int)transColor);
+		mask = _mm_set1_epi32((int)colorMask);
+	}
+
+	int x = 0;
+	for (; x + perVector <= width; x += perVector) {
+		const __m128i s = _mm_loadu_si128((const __m128i *)(src + x));
+		const __m128i d = _mm_loadu_si128((const __m128i *)(dest + x));
+		__m128i keyed;
+		if (sizeof(T) == 1)
+			keyed = _mm_cmpeq_epi8(s, key);
+		else if (sizeof(T) == 2)
+			keyed = _mm_cmpeq_epi16(s, key);
+		else
+			keyed = _mm_cmpeq_epi32(s, key);
+		const __m128i result = _mm_or_si128(_mm_and_si128(keyed, d), _mm_andnot_si128(keyed, _mm_and_si128(s, mask)));
+		_mm_storeu_si128((__m128i *)(dest + x), result);
+	}
+
+	keyedRow<T>(src + x, dest + x, width - x, transColor, colorMask);
+}
+
+#elif defined(USE_NEON_BLIT)
+
+void keyedRowSimd(const byte *src, byte *dest, int width, byte transColor, byte colorMask) {
+	const uint8x16_t key = vdupq_n_u8(transColor);
+	const uint8x16_t mask = vdupq_n_u8(colorMask);
+	int x = 0;
+	for (; x + 16 <= width; x += 16) {
+		const uint8x16_t s = vld1q_u8(src + x);
+		const uint8x16_t keyed = vceqq_u8(s, key);
+		vst1q_u8(dest + x, vbslq_u8(keyed, vld1q_u8(dest + x), vandq_u8(s, mask)));
+	}
+
+	keyedRow<byte>(src + x, dest + x, width - x, transColor, colorMask);
+}
+
+void keyedRowSimd(const uint16 *src, uint16 *dest, int width, uint16 transColor, uint16 colorMask) {
+	const uint16x8_t key = vdupq_n_u16(transColor);
+	const uint16x8_t mask = vdupq_n_u16(colorMask);
+	int x = 0;
+	for (; x + 8 <= width; x += 8) {
+		const uint16x8_t s = vld1q_u16((const uint16_t *)(src + x));
+		const uint16x8_t keyed = vceqq_u16(s, key);
+		vst1q_u16((uint16_t *)(dest + x), vbslq_u16(keyed, vld1q_u16((const uint16_t *)(dest + x)), vandq_u16(s, mask)));
+	}
+
+	keyedRow<uint16>(src + x, dest + x, width - x, transColor, colorMask);
+}
+
+void keyedRowSimd(const uint32 *src, uint32 *dest, int width, uint32 transColor, uint32 colorMask) {
+	const uint32x4_t key = vdupq_n_u32(transColor);
+	const uint32x4_t mask = vdupq_n_u32(colorMask);
+	int x = 0;
+	for (; x + 4 <= width; x += 4) {
+		const uint32x4_t s = vld1q_u32((const uint32_t *)(src + x));
+		const uint32x4_t keyed = vceqq_u32(s, key);
+		vst1q_u32((uint32_t *)(dest + x), vbslq_u32(keyed, vld1q_u32((const uint32_t *)(dest + x)), vandq_u32(s, mask)));
+	}
+
+	keyedRow<uint32>(src + x, dest + x, width - x, transColor, colorMask);
+}
+
+#endif
+
+/**
+ * Parameters of the 32bpp alpha kernel. Pixels are skipped when they are
+ * fully transparent or match the transparent color within keyMask, and
+ * copied when they are opaque. Only the remaining pixels are blended.
+ */
+struct AlphaRowParams {
+	const PixelFormat *format;
+	uint32 keyMask, keyColor;
+	uint32 alphaMask;
+	bool destTrans;
+	uint32 destTransColor;
+};
+
+inline void alphaPixel(uint32 srcVal, uint32 &destVal, const AlphaRowParams &p) {
+	if ((srcVal & p.keyMask) == p.keyColor)
+		return;
+
+	// As in transBlit, this is done even if the source pixel is fully transparent
+	if (p.destTrans && (destVal & ~p.alphaMask) == p.destTransColor)
+		// Remove transparent color on dest so it isn't alpha blended
+		destVal = 0;
+
+	const uint32 alpha = srcVal & p.alphaMask;
+	if (alpha == 0)
+		return;
+	if (alpha == p.alphaMask) {
+		destVal = srcVal;
+		return;
+	}
+
+	transBlitPixel<uint32, uint32>(srcVal, destVal, *p.format, *p.format, 0, 0xff, nullptr, nullptr);
+}
+
+void alphaRow(const uint32 *src, uint32 *dest, int width, bool flipped, const AlphaRowParams &p) {
+	const int step = flipped ? -1 : 1;
+	for (int x = 0; x < width; ++x, src += step)
+		alphaPixel(*src, dest[x], p);
+}
+
+#if defined(USE_SSE2_BLIT)
+
+void alphaRowSimd(const uint32 *src, uint32 *dest, int width, const AlphaRowParams &p) {
+	const __m128i keyMask = _mm_set1_epi32((int)p.keyMask);
+	const __m128i keyColor = _mm_set1_epi32((int)p.keyColor);
+	const __m128i alphaMask = _mm_set1_epi32((int)p.alphaMask);
+	const __m128i destTransMask = _mm_set1_epi32(p.destTrans ? (int)~p.alphaMask : 0);
+	const __m128i destTransColor = _mm_set1_epi32(p.destTrans ? (int)p.destTransColor : -1);
+	const __m128i zero = _mm_setzero_si128();
+
+	int x = 0;
+	for (; x + 4 <= width; x += 4) {
+		const __m128i s = _mm_loadu_si128((const __m128i *)(src + x));
+		const __m128i alpha = _mm_and_si128(s, alphaMask);
+		const __m128i keyed = _mm_cmpeq_epi32(_mm_and_si128(s, keyMask), keyColor);
+		const __m128i skip = _mm_or_si128(keyed, _mm_cmpeq_epi32(alpha, zero));
+		const __m128i copy = _mm_andnot_si128(keyed, _mm_cmpeq_epi32(alpha, alphaMask));
+
+		if (_mm_movemask_epi8(_mm_or_si128(skip, copy)) == 0xFFFF) {
+			// No pixel needs blending, but skipped pixels still clear the
+			// transparent color of the destination
+			const __m128i d = _mm_loadu_si128((const __m128i *)(dest + x));
+			const __m128i destKeyed = _mm_cmpeq_epi32(_mm_and_si128(d, destTransMask), destTransColor);
+			const __m128i keep = _mm_andnot_si128(_mm_or_si128(copy, _mm_andnot_si128(keyed, destKeyed)), d);
+			_mm_storeu_si128((__m128i *)(dest + x), _mm_or_si128(_mm_and_si128(copy, s), keep));
+		} else {
+			for (int i = 0; i < 4; ++i)
+				alphaPixel(src[x + i], dest[x + i], p);
+		}
+	}
+
+	alphaRow(src + x, dest + x, width - x, false, p);
+}
+
+#elif defined(USE_NEON_BLIT)
+
+void alphaRowSimd(const uint32 *src, uint32 *dest, int width, const AlphaRowParams &p) {
+	const uint32x4_t keyMask = vdupq_n_u32(p.keyMask);
+	const uint32x4_t keyColor = vdupq_n_u32(p.keyColor);
+	const uint32x4_t alphaMask = vdupq_n_u32(p.alphaMask);
+	const uint32x4_t destTransMask = vdupq_n_u32(p.destTrans ? ~p.alphaMask : 0);
+	const uint32x4_t destTransColor = vdupq_n_u32(p.destTrans ? p.destTransColor : 0xFFFFFFFF);
+	const uint32x4_t zero = vdupq_n_u32(0);
+
+	int x = 0;
+	for (; x + 4 <= width; x += 4) {
+		const uint32x4_t s = vld1q_u32((const uint32_t *)(src + x));
+		const uint32x4_t alpha = vandq_u32(s, alphaMask);
+		const uint32x4_t keyed = vceqq_u32(vandq_u32(s, keyMask), keyColor);
+		const uint32x4_t skip = vorrq_u32(keyed, vceqq_u32(alpha, zero));
+		const uint32x4_t copy = vbicq_u32(vceqq_u32(alpha, alphaMask), keyed);
+
+		const uint32x4_t handled = vorrq_u32(skip, copy);
+		const uint32x2_t handled2 = vand_u32(vget_low_u32(handled), vget_high_u32(handled));
+		if ((vget_lane_u32(handled2, 0) & vget_lane_u32(handled2, 1)) == 0xFFFFFFFF) {
+			// No pixel needs blending, but skipped pixels still clear the
+			// transparent color of the destination
+			const uint32x4_t d = vld1q_u32((const uint32_t *)(dest + x));
+			const uint32x4_t destKeyed = vceqq_u32(vandq_u32(d, destTransMask), destTransColor);
+			const uint32x4_t keep = vbicq_u32(d, vbicq_u32(destKeyed, keyed));
+			vst1q_u32((uint32_t *)(dest + x), vbslq_u32(copy, s, keep));
+		} else {
+			for (int i = 0; i < 4; ++i)
+				alphaPixel(src[x + i], dest[x + i], p);
+		}
+	}
+
+	alphaRow(src + x, dest + x, width - x, false, p);
+}
+
+#endif
+
+enum TransBlitKernel {
+	kKernelNone,
+	kKernelKeyed,
+	kKernelPalette,
+	kKernelAlpha
+};
+
+template<typename T>
+void keyedBlit(const Surface &src, const Common::Rect &srcRect, ManagedSurface &dest, const Common::Rect &destRect,
+		int x0, int x1, T transColor, T colorMask, bool flipped) {
+	for (int destY = MAX<int>(destRect.top, 0); destY < MIN<int>(destRect.bottom, dest.h); ++destY) {
+		const T *srcLine = (const T *)src.getBasePtr(srcRect.left, destY - destRect.top + srcRect.top);
+		T *destLine = (T *)dest.getBasePtr(destRect.left, destY);
+
+		if (flipped)
+			keyedRowFlipped<T>(srcLine + src.w - x0 - 1, destLine + x0, x1 - x0, transColor, colorMask);
+#if defined(USE_SSE2_BLIT) || defined(USE_NEON_BLIT)
+		else if (s_simdBlits)
+			keyedRowSimd(srcLine + x0, destLine + x0, x1 - x0, transColor, colorMask);
+#endif
+		else
+			keyedRow<T>(srcLine + x0, destLine + x0, x1 - x0, transColor, colorMask);
+	}
+}
+
+/**
+ * Blit using a specialized kernel, if one exists for the parameters. Only
+ * unscaled blits without a mask are handled, with the same results as the
+ * generic transBlit.
+ *
+ * @return true if the blit was done, false if transBlit must be used.
+ */
+bool transBlitSpecialized(const Surface &src, const Common::Rect &srcRect, ManagedSurface &dest, const Common::Rect &destRect,
+		uint transColor, bool flipped, uint overrideColor, uint srcAlpha, const uint32 *srcPalette,
+		const uint32 *dstPalette, const Surface *mask, bool maskOnly) {
+	if (!s_specializedBlits || mask || maskOnly)
+		return false;
+	if (SCALE_THRESHOLD * srcRect.width() / destRect.width() != SCALE_THRESHOLD ||
+			SCALE_THRESHOLD * srcRect.height() / destRect.height() != SCALE_THRESHOLD)
+		return false;
+
+	const PixelFormat &format = dest.format;
+	TransBlitKernel kernel = kKernelNone;
+	byte *lookup = nullptr;
+
+	if (src.format.bytesPerPixel == 1 && format.bytesPerPixel == 1) {
+		if (srcAlpha == 0 || overrideColor)
+			return false;
+
+		kernel = kKernelKeyed;
+		if (srcPalette && dstPalette) {
+			lookup = createPaletteLookup(srcPalette, dstPalette);
+			for (int i = 0; i < 256; ++i) {
+				if (lookup[i] != i) {
+					kernel = kKernelPalette;
+					break;
+				}
+			}
+		}
+	} else if (src.format == format && format.bytesPerPixel != 1 && srcAlpha == 0xff) {
+		if (format.aBits() == 0)
+			kernel = kKernelKeyed;
+		else if (format.bytesPerPixel == 4 && format.aBits() == 8 && format.rBits() == 8 &&
+				format.gBits() == 8 && format.bBits() == 8)
+			kernel = kKernelAlpha;
+	}
+
+	if (kernel == kKernelNone)
+		return false;
+
+	// Visible columns of the destination rect
+	const int x0 = MAX<int>(0, -destRect.left);
+	const int x1 = MIN<int>(destRect.width(), dest.w - destRect.left);
+
+	if (x0 < x1) {
+		switch (kernel) {
+		case kKernelKeyed:
+			if (format.bytesPerPixel == 1)
+				keyedBlit<byte>(src, srcRect, dest, destRect, x0, x1, (byte)transColor, 0xff, flipped);
+			else if (format.bytesPerPixel == 2)
+				keyedBlit<uint16>(src, srcRect, dest, destRect, x0, x1, (uint16)transColor,
+					(uint16)format.ARGBToColor(0, 0xff, 0xff, 0xff), flipped);
+			else
+				keyedBlit<uint32>(src, srcRect, dest, destRect, x0, x1, (uint32)transColor,
+					format.ARGBToColor(0, 0xff, 0xff, 0xff), flipped);
+			break;
+
+		case kKernelPalette:
+			for (int destY = MAX<int>(destRect.top, 0); destY < MIN<int>(destRect.bottom, dest.h); ++destY) {
+				const byte *srcLine = (const byte *)src.getBasePtr(srcRect.left, destY - destRect.top + srcRect.top);
+				byte *destLine = (byte *)dest.getBasePtr(destRect.left, destY);
+				keyedRowPalette(srcLine + (flipped ? src.w - x0 - 1 : x0), destLine + x0, x1 - x0,
+					(byte)transColor, lookup, flipped);
+			}
+			break;
+
+		case kKernelAlpha: {
+			AlphaRowParams p;
+			p.format = &format;
+			p.alphaMask = format.ARGBToColor(0xff, 0, 0, 0);
+			// As in transBlit, a non-zero transparent color is matched irrespective of alpha
+			p.keyMask = (transColor != (uint32)-1 && transColor > 0) ? ~p.alphaMask : 0xFFFFFFFF;
+			p.keyColor = transColor & p.keyMask;
+			p.destTrans = dest.hasTransparentColor();
+			p.destTransColor = dest.getTransparentColor() & ~p.alphaMask;
+
+			for (int destY = MAX<int>(destRect.top, 0); destY < MIN<int>(destRect.bottom, dest.h); ++destY) {
+				const uint32 *srcLine = (const uint32 *)src.getBasePtr(srcRect.left, destY - destRect.top + srcRect.top);
+				uint32 *destLine = (uint32 *)dest.getBasePtr(destRect.left, destY);
+
+				if (flipped)
+					alphaRow(srcLine + src.w - x0 - 1, destLine + x0, x1 - x0, true, p);
+#if defined(USE_SSE2_BLIT) || defined(USE_NEON_BLIT)
+				else if (s_simdBlits)
+					alphaRowSimd(srcLine + x0, destLine + x0, x1 - x0, p);
+#endif
+				else
+					alphaRow(srcLine + x0, destLine + x0, x1 - x0, false, p);
+			}
+			break;
+		}
+
+		default:
+			break;
+		}
+	}
+
+	delete[] lookup;
+	return true;
+}
+
+} // End of anonymous namespace
+
 #define HANDLE_BLIT(SRC_BYTES, DEST_BYTES, SRC_TYPE, DEST_TYPE) \
 	if (src.format.bytesPerPixel == SRC_BYTES && format.bytesPerPixel == DEST_BYTES) \
 		transBlit<SRC_TYPE, DEST_TYPE>(src, srcRect, *this, destRect, transColor, flipped, overrideColor, srcAlpha, srcPalette, dstPalette, mask, maskOnly); \
@@ -696,14 +1074,17 @@ void ManagedSurface::transBlitFromInner(const Surface &src, const Common::Rect &
 			error("Surface::transBlitFrom: mask dimensions do not match src");
 	}
 
-	HANDLE_BLIT(1, 1, byte, byte)
-	HANDLE_BLIT(1, 2, byte, uint16)
-	HANDLE_BLIT(1, 4, byte, uint32)
-	HANDLE_BLIT(2, 2, uint16, uint16)
-	HANDLE_BLIT(4, 4, uint32, uint32)
-	HANDLE_BLIT(2, 4, uint16, uint32)
-	HANDLE_BLIT(4, 2, uint32, uint16)
-	error("Surface::transBlitFrom: bytesPerPixel must be 1, 2, or 4");
+	if (!transBlitSpecialized(src, srcRect, *this, destRect, transColor, flipped, overrideColor, srcAlpha,
+			srcPalette, dstPalette, mask, maskOnly)) {
+		HANDLE_BLIT(1, 1, byte, byte)
+		HANDLE_BLIT(1, 2, byte, uint16)
+		HANDLE_BLIT(1, 4, byte, uint32)
+		HANDLE_BLIT(2, 2, uint16, uint16)
+		HANDLE_BLIT(4, 4, uint32, uint32)
+		HANDLE_BLIT(2, 4, uint16, uint32)
+		HANDLE_BLIT(4, 2, uint32, uint16)
+		error("Surface::transBlitFrom: bytesPerPixel must be 1, 2, or 4");
+	}
 
 	// Mark the affected area
 	addDirtyRect(destRect);
@@ -665,6 +665,17 @@ public:
 	 */
 	void setPalette(const uint32 *colors, uint start, uint num);
 };
+
+/**
+ * Select the code used by ManagedSurface::transBlitFrom. Unscaled blits
+ * without a mask use kernels specialized for the common pixel formats by
+ * default, which use SIMD when available for the current CPU.
+ *
+ * @param specialized Use the specialized kernels where possible.
+ * @param simd        Use the SIMD implementation of the specialized kernels.
+ * @return true if a SIMD implementation is available, false otherwise.
+ */
+bool setTransBlitKernels(bool specialized, bool simd);
 /** @} */
 } // End of namespace Graphics
 
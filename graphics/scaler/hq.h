@@ -32,6 +32,10 @@ public:
 	virtual uint increaseFactor() override;
 	virtual uint decreaseFactor() override;
 	virtual bool canDrawCursor() const override { return false; }
+#ifndef USE_NASM
+	// The NASM implementation keeps its loop state in static variables
+	virtual bool canScaleInBands() const override { return true; }
+#endif
 	virtual uint extraPixels() const override { return 1; }
 	virtual const char *getName() const override;
 	virtual const char *getPrettyName() const override;
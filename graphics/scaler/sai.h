@@ -30,6 +30,7 @@ public:
 	virtual uint increaseFactor() override;
 	virtual uint decreaseFactor() override;
 	virtual bool canDrawCursor() const override { return false; }
+	virtual bool canScaleInBands() const override { return true; }
 	virtual uint extraPixels() const override { return 2; }
 	virtual const char *getName() const override;
 	virtual const char *getPrettyName() const override;
@@ -44,6 +45,7 @@ public:
 	virtual uint increaseFactor() override;
 	virtual uint decreaseFactor() override;
 	virtual bool canDrawCursor() const override { return false; }
+	virtual bool canScaleInBands() const override { return true; }
 	virtual uint extraPixels() const override { return 2; }
 	virtual const char *getName() const override;
 	virtual const char *getPrettyName() const override;
@@ -58,6 +60,7 @@ public:
 	virtual uint increaseFactor() override;
 	virtual uint decreaseFactor() override;
 	virtual bool canDrawCursor() const override { return false; }
+	virtual bool canScaleInBands() const override { return true; }
 	virtual uint extraPixels() const override { return 2; }
 	virtual const char *getName() const override;
 	virtual const char *getPrettyName() const override;
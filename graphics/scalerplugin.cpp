@@ -21,6 +21,8 @@
 
 #include "graphics/scalerplugin.h"
 
+#include "common/util.h"
+
 void ScalerPluginObject::initialize(const Graphics::PixelFormat &format) {
 	_format = format;
 }
@@ -47,6 +49,16 @@ void Normal1x(const uint8 *srcPtr, uint32 srcPitch, uint8 *dstPtr, uint32 dstPit
 }
 } // End of anonymous namespace
 
+struct ScalerPluginObject::Band {
+	ScalerPluginObject *scaler;
+	const uint8 *srcPtr;
+	uint32 srcPitch;
+	uint8 *dstPtr;
+	uint32 dstPitch;
+	int width, height, x, y;
+	uint count;
+};
+
 void ScalerPluginObject::scale(const uint8 *srcPtr, uint32 srcPitch, uint8 *dstPtr,
 	                           uint32 dstPitch, int width, int height, int x, int y) {
 	if (_factor == 1) {
@@ -55,11 +67,33 @@ void ScalerPluginObject::scale(const uint8 *srcPtr, uint32 srcPitch, uint8 *dstP
 		} else {
 			Normal1x<uint32>(srcPtr, srcPitch, dstPtr, dstPitch, width, height);
 		}
+		return;
+	}
+
+	uint count = 1;
+	if (_bandRunner && canScaleInBands())
+		count = MIN<uint>(_bandRunner->getBandCount(), height / kMinBandHeight);
+
+	if (count > 1) {
+		Band band = { this, srcPtr, srcPitch, dstPtr, dstPitch, width, height, x, y, count };
+		_bandRunner->run(&scaleBand, &band, count);
 	} else {
 		scaleIntern(srcPtr, srcPitch, dstPtr, dstPitch, width, height, x, y);
 	}
 }
 
+void ScalerPluginObject::scaleBand(void *data, uint band) {
+	const Band *b = (const Band *)data;
+	const int y0 = (int)(b->height * band / b->count);
+	const int y1 = (int)(b->height * (band + 1) / b->count);
+
+	// The source rows around the band are read but not scaled, which
+	// provides the extraPixels() overlap between neighbouring bands.
+	b->scaler->scaleIntern(b->srcPtr + y0 * b->srcPitch, b->srcPitch,
+	                       b->dstPtr + y0 * b->scaler->_factor * b->dstPitch, b->dstPitch,
+	                       b->width, y1 - y0, b->x, b->y + y0);
+}
+
 SourceScaler::SourceScaler() : _width(0), _height(0), _oldSrc(NULL), _enable(false) {
 }
 
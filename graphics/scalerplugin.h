@@ -26,9 +26,35 @@
 #include "graphics/pixelformat.h"
 #include "graphics/surface.h"
 
+/**
+ * Executes the bands of a banded scale operation. Backends which own a
+ * pool of worker threads can provide an implementation to run the bands
+ * in parallel.
+ *
+ * @see ScalerPluginObject::setBandRunner
+ */
+class ScalerBandRunner {
+public:
+	typedef void (*BandFunc)(void *data, uint band);
+
+	virtual ~ScalerBandRunner() {}
+
+	/**
+	 * The number of bands the runner can execute in parallel.
+	 */
+	virtual uint getBandCount() const = 0;
+
+	/**
+	 * Call func(data, band) once for every band in [0, count) and return
+	 * after all calls have finished. The calls may run concurrently.
+	 */
+	virtual void run(BandFunc func, void *data, uint count) = 0;
+};
+
 class ScalerPluginObject : public PluginObject {
 public:
 
+	ScalerPluginObject() : _bandRunner(nullptr) {}
 	virtual ~ScalerPluginObject() {}
 
 	/**
@@ -110,6 +136,20 @@ public:
 	 */
 	virtual bool canDrawCursor() const = 0;
 
+	/**
+	 * Scalers which read the source and write only the destination rows
+	 * of the rect passed to scaleIntern, without touching any other
+	 * state, can scale independent horizontal bands concurrently. Each
+	 * band still reads up to extraPixels() rows of its neighbours.
+	 */
+	virtual bool canScaleInBands() const { return false; }
+
+	/**
+	 * Set the runner used to scale large rects in bands. The runner is
+	 * not owned by the scaler. Pass nullptr to always scale in one pass.
+	 */
+	void setBandRunner(ScalerBandRunner *runner) { _bandRunner = runner; }
+
 	/**
 	 * This value will be displayed on the GUI.
 	 */
@@ -158,6 +198,16 @@ protected:
 	uint _factor;
 	Common::Array<uint> _factors;
 	Graphics::PixelFormat _format;
+
+private:
+	struct Band;
+
+	/** The minimal number of source rows scaled by one band. */
+	static const int kMinBandHeight = 16;
+
+	static void scaleBand(void *data, uint band);
+
+	ScalerBandRunner *_bandRunner;
 };
 
 /**
@@ -690,3 +690,8 @@ void tglEnableDirtyRects(bool enable) {
 	TinyGL::GLContext *c = TinyGL::gl_get_context();
 	c->_enableDirtyRectangles = enable;
 }
+
+void tglEnableSimdSpans(bool enable) {
+	TinyGL::GLContext *c = TinyGL::gl_get_context();
+	c->fb->enableSimdSpans(enable);
+}
@@ -851,11 +851,21 @@ void tglPolygonOffset(TGLfloat factor, TGLfloat units);
 void tglSetShadowMaskBuf(unsigned char *buf);
 void tglSetShadowColor(unsigned char r, unsigned char g, unsigned char b);
 void tglEnableDirtyRects(bool enable);
+void tglEnableSimdSpans(bool enable);
 void tglDebug(int mode);
 
 namespace TinyGL {
 
+// Statistics about the last presented frame
+struct FrameStats {
+	unsigned int drawCalls;     // Draw calls issued for the frame
+	unsigned int executedCalls; // Draw calls executed, counting every dirty rectangle separately
+	unsigned int rectangles;    // Dirty rectangles redrawn
+	unsigned int presentTime;   // Time spent in tglPresentBuffer, in milliseconds
+};
+
 void tglPresentBuffer();
+void tglGetFrameStats(FrameStats &stats);
 
 } // end of namespace TinyGL
 
@@ -236,6 +236,7 @@ void glInit(void *zbuffer1, int textureSize) {
 	c->_drawCallAllocator[0].initialize(kDrawCallMemory);
 	c->_drawCallAllocator[1].initialize(kDrawCallMemory);
 	c->_enableDirtyRectangles = true;
+	memset(&c->_frameStats, 0, sizeof(c->_frameStats));
 
 	Graphics::Internal::tglBlitResetScissorRect();
 }
@@ -107,6 +107,7 @@ FrameBuffer::FrameBuffer(int width, int height, const Graphics::PixelBuffer &fra
 	_offsetStates = 0;
 	_offsetFactor = 0.0f;
 	_offsetUnits = 0.0f;
+	_enableSimdSpans = true;
 }
 
 FrameBuffer::FrameBuffer(int width, int height, const Graphics::PixelFormat &format) : _depthWrite(true), _enableScissor(false) {
@@ -137,6 +138,7 @@ FrameBuffer::FrameBuffer(int width, int height, const Graphics::PixelFormat &for
 	_offsetStates = 0;
 	_offsetFactor = 0.0f;
 	_offsetUnits = 0.0f;
+	_enableSimdSpans = true;
 }
 
 FrameBuffer::~FrameBuffer() {
@@ -478,6 +478,10 @@ struct FrameBuffer {
 		_enableScissor = false;
 	}
 
+	void enableSimdSpans(bool enable) {
+		_enableSimdSpans = enable;
+	}
+
 	Common::Rect _clipRectangle;
 	bool _enableScissor;
 	int xsize, ysize;
@@ -530,6 +534,9 @@ private:
 	template <bool kInterpRGB, bool kInterpZ, bool kDepthWrite, bool kEnableScissor>
 	void drawLine(const ZBufferPoint *p1, const ZBufferPoint *p2);
 
+	// Depth function to use for SIMD spans, or -1 if they cannot be used
+	int getSimdDepthFunc() const;
+
 	unsigned int *_zbuf;
 	bool _depthWrite;
 	Graphics::PixelBuffer pbuf;
@@ -544,6 +551,7 @@ private:
 	int _offsetStates;
 	float _offsetFactor;
 	float _offsetUnits;
+	bool _enableSimdSpans;
 };
 
 // memory.c
@@ -31,6 +31,7 @@
 #include "graphics/tinygl/gl.h"
 #include "common/debug.h"
 #include "common/math.h"
+#include "common/system.h"
 
 namespace TinyGL {
 
@@ -193,6 +194,8 @@ static void tglPresentBufferDirtyRects(TinyGL::GLContext *c) {
 		(*it1).rectangle.clip(c->renderRect);
 	}
 
+	c->_frameStats.rectangles = rectangles.size();
+
 	if (!rectangles.empty()) {
 		// Execute draw calls.
 		for (DrawCallIterator it = c->_drawCallsQueue.begin(); it != c->_drawCallsQueue.end(); ++it) {
@@ -201,6 +204,7 @@ static void tglPresentBufferDirtyRects(TinyGL::GLContext *c) {
 				Common::Rect dirtyRegion = (*itRect).rectangle;
 				if (dirtyRegion.intersects(drawCallRegion)) {
 					(*it)->execute(dirtyRegion, true);
+					c->_frameStats.executedCalls++;
 				}
 			}
 		}
@@ -246,6 +250,7 @@ static void tglPresentBufferSimple(TinyGL::GLContext *c) {
 		(*it)->execute(true);
 		delete *it;
 	}
+	c->_frameStats.executedCalls = c->_drawCallsQueue.size();
 
 	c->_drawCallsQueue.clear();
 
@@ -256,11 +261,23 @@ static void tglPresentBufferSimple(TinyGL::GLContext *c) {
 
 void tglPresentBuffer() {
 	TinyGL::GLContext *c = TinyGL::gl_get_context();
+	const uint32 startTime = g_system->getMillis();
+
+	c->_frameStats.drawCalls = c->_drawCallsQueue.size();
+	c->_frameStats.executedCalls = 0;
+	c->_frameStats.rectangles = 0;
+
 	if (c->_enableDirtyRectangles) {
 		tglPresentBufferDirtyRects(c);
 	} else {
 		tglPresentBufferSimple(c);
 	}
+
+	c->_frameStats.presentTime = g_system->getMillis() - startTime;
+}
+
+void tglGetFrameStats(FrameStats &stats) {
+	stats = TinyGL::gl_get_context()->_frameStats;
 }
 
 } // end of namespace TinyGL
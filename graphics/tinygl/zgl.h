@@ -408,6 +408,8 @@ struct GLContext {
 	Common::List<Graphics::DrawCall *> _previousFrameDrawCallsQueue;
 	int _currentAllocatorIndex;
 	LinearAllocator _drawCallAllocator[2];
+
+	FrameStats _frameStats;
 };
 
 extern GLContext *gl_ctx;
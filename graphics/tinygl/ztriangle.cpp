@@ -26,6 +26,14 @@
  * It also has modifications by the ResidualVM-team, which are covered under the GPLv2 (or later).
  */
 
+#if defined(__SSE2__)
+#define USE_SSE2_SPANS
+#include <emmintrin.h>
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#define USE_NEON_SPANS
+#include <arm_neon.h>
+#endif
+
 #include "common/endian.h"
 #include "graphics/tinygl/texelbuffer.h"
 #include "graphics/tinygl/zbuffer.h"
@@ -107,6 +115,221 @@ FORCEINLINE static void putPixelTextureMappingPerspective(FrameBuffer *buffer, i
 	}
 }
 
+#if defined(USE_SSE2_SPANS) || defined(USE_NEON_SPANS)
+
+// The SIMD span functions process four pixels at a time and produce exactly
+// the same output as the putPixel functions above. They only handle opaque
+// writes to 32 bits per pixel buffers, with the depth functions selected by
+// FrameBuffer::getSimdDepthFunc().
+
+#if defined(USE_SSE2_SPANS)
+
+typedef __m128i SpanVector;
+
+FORCEINLINE static SpanVector spanRamp(unsigned int value, int step) {
+	return _mm_set_epi32(value + 3 * step, value + 2 * step, value + step, value);
+}
+
+FORCEINLINE static SpanVector spanSplat(unsigned int value) {
+	return _mm_set1_epi32(value);
+}
+
+FORCEINLINE static SpanVector spanAdd(SpanVector a, SpanVector b) {
+	return _mm_add_epi32(a, b);
+}
+
+FORCEINLINE static SpanVector spanLoad(const unsigned int *p) {
+	return _mm_loadu_si128((const __m128i *)p);
+}
+
+FORCEINLINE static void spanStore(unsigned int *p, SpanVector value) {
+	_mm_storeu_si128((__m128i *)p, value);
+}
+
+template <int kDepthFunc>
+FORCEINLINE static SpanVector spanDepthMask(SpanVector zSrc, SpanVector zDst) {
+	if (kDepthFunc == TGL_ALWAYS)
+		return _mm_set1_epi32(-1);
+
+	// SSE2 only compares signed integers
+	const __m128i bias = _mm_set1_epi32((int)0x80000000);
+	zSrc = _mm_xor_si128(zSrc, bias);
+	zDst = _mm_xor_si128(zDst, bias);
+	if (kDepthFunc == TGL_LESS)
+		return _mm_cmpgt_epi32(zSrc, zDst);
+	return _mm_xor_si128(_mm_cmpgt_epi32(zDst, zSrc), _mm_set1_epi32(-1));
+}
+
+FORCEINLINE static bool spanAnyPass(SpanVector mask) {
+	return _mm_movemask_epi8(mask) != 0;
+}
+
+FORCEINLINE static SpanVector spanSelect(SpanVector mask, SpanVector a, SpanVector b) {
+	return _mm_or_si128(_mm_and_si128(mask, a), _mm_andnot_si128(mask, b));
+}
+
+FORCEINLINE static SpanVector spanChannel(SpanVector value, int bits, int loss, int shift) {
+	value = _mm_and_si128(_mm_srl_epi32(value, _mm_cvtsi32_si128(bits - 8)), _mm_set1_epi32(0xFF));
+	return _mm_sll_epi32(_mm_srl_epi32(value, _mm_cvtsi32_si128(loss)), _mm_cvtsi32_si128(shift));
+}
+
+FORCEINLINE static SpanVector spanOr(SpanVector a, SpanVector b) {
+	return _mm_or_si128(a, b);
+}
+
+#elif defined(USE_NEON_SPANS)
+
+typedef uint32x4_t SpanVector;
+
+FORCEINLINE static SpanVector spanRamp(unsigned int value, int step) {
+	const uint32 ramp[4] = { value, value + step, value + 2 * step, value + 3 * step };
+	return vld1q_u32(ramp);
+}
+
+FORCEINLINE static SpanVector spanSplat(unsigned int value) {
+	return vdupq_n_u32(value);
+}
+
+FORCEINLINE static SpanVector spanAdd(SpanVector a, SpanVector b) {
+	return vaddq_u32(a, b);
+}
+
+FORCEINLINE static SpanVector spanLoad(const unsigned int *p) {
+	return vld1q_u32((const uint32 *)p);
+}
+
+FORCEINLINE static void spanStore(unsigned int *p, SpanVector value) {
+	vst1q_u32((uint32 *)p, value);
+}
+
+template <int kDepthFunc>
+FORCEINLINE static SpanVector spanDepthMask(SpanVector zSrc, SpanVector zDst) {
+	if (kDepthFunc == TGL_ALWAYS)
+		return vdupq_n_u32(0xFFFFFFFF);
+	if (kDepthFunc == TGL_LESS)
+		return vcltq_u32(zDst, zSrc);
+	return vcleq_u32(zDst, zSrc);
+}
+
+FORCEINLINE static bool spanAnyPass(SpanVector mask) {
+	const uint32x2_t half = vorr_u32(vget_low_u32(mask), vget_high_u32(mask));
+	return (vget_lane_u32(half, 0) | vget_lane_u32(half, 1)) != 0;
+}
+
+FORCEINLINE static SpanVector spanSelect(SpanVector mask, SpanVector a, SpanVector b) {
+	return vbslq_u32(mask, a, b);
+}
+
+FORCEINLINE static SpanVector spanChannel(SpanVector value, int bits, int loss, int shift) {
+	value = vandq_u32(vshlq_u32(value, vdupq_n_s32(8 - bits)), vdupq_n_u32(0xFF));
+	return vshlq_u32(vshlq_u32(value, vdupq_n_s32(-loss)), vdupq_n_s32(shift));
+}
+
+FORCEINLINE static SpanVector spanOr(SpanVector a, SpanVector b) {
+	return vorrq_u32(a, b);
+}
+
+#endif
+
+// Gouraud shaded span; returns the number of pixels drawn, a multiple of four.
+template <int kDepthFunc, bool kDepthWrite>
+static int fillSpanSmooth(unsigned int *pp, unsigned int *pz, int count, const Graphics::PixelFormat &format,
+						  unsigned int &z, unsigned int &r, unsigned int &g, unsigned int &b, unsigned int &a,
+						  int dzdx, int drdx, int dgdx, int dbdx, int dadx) {
+	const int pixels = count & ~3;
+	if (!pixels)
+		return 0;
+
+	SpanVector vz = spanRamp(z, dzdx);
+	SpanVector vr = spanRamp(r, drdx);
+	SpanVector vg = spanRamp(g, dgdx);
+	SpanVector vb = spanRamp(b, dbdx);
+	SpanVector va = spanRamp(a, dadx);
+	const SpanVector dz = spanSplat(4 * dzdx);
+	const SpanVector dr = spanSplat(4 * drdx);
+	const SpanVector dg = spanSplat(4 * dgdx);
+	const SpanVector db = spanSplat(4 * dbdx);
+	const SpanVector da = spanSplat(4 * dadx);
+
+	for (int i = 0; i < pixels; i += 4) {
+		const SpanVector zDst = spanLoad(pz + i);
+		const SpanVector mask = spanDepthMask<kDepthFunc>(vz, zDst);
+		if (spanAnyPass(mask)) {
+			SpanVector color = spanChannel(va, ZB_POINT_ALPHA_BITS, format.aLoss, format.aShift);
+			color = spanOr(color, spanChannel(vr, ZB_POINT_RED_BITS, format.rLoss, format.rShift));
+			color = spanOr(color, spanChannel(vg, ZB_POINT_GREEN_BITS, format.gLoss, format.gShift));
+			color = spanOr(color, spanChannel(vb, ZB_POINT_BLUE_BITS, format.bLoss, format.bShift));
+			spanStore(pp + i, spanSelect(mask, color, spanLoad(pp + i)));
+			if (kDepthWrite)
+				spanStore(pz + i, spanSelect(mask, vz, zDst));
+		}
+		vz = spanAdd(vz, dz);
+		vr = spanAdd(vr, dr);
+		vg = spanAdd(vg, dg);
+		vb = spanAdd(vb, db);
+		va = spanAdd(va, da);
+	}
+
+	z += pixels * dzdx;
+	r += pixels * drdx;
+	g += pixels * dgdx;
+	b += pixels * dbdx;
+	a += pixels * dadx;
+	return pixels;
+}
+
+template <bool kDepthWrite>
+static int fillSpanSmooth(int depthFunc, unsigned int *pp, unsigned int *pz, int count, const Graphics::PixelFormat &format,
+						  unsigned int &z, unsigned int &r, unsigned int &g, unsigned int &b, unsigned int &a,
+						  int dzdx, int drdx, int dgdx, int dbdx, int dadx) {
+	switch (depthFunc) {
+	case TGL_LESS:
+		return fillSpanSmooth<TGL_LESS, kDepthWrite>(pp, pz, count, format, z, r, g, b, a, dzdx, drdx, dgdx, dbdx, dadx);
+	case TGL_LEQUAL:
+		return fillSpanSmooth<TGL_LEQUAL, kDepthWrite>(pp, pz, count, format, z, r, g, b, a, dzdx, drdx, dgdx, dbdx, dadx);
+	default:
+		return fillSpanSmooth<TGL_ALWAYS, kDepthWrite>(pp, pz, count, format, z, r, g, b, a, dzdx, drdx, dgdx, dbdx, dadx);
+	}
+}
+
+// Returns whether any of 'count' pixels, a multiple of four, passes the depth test.
+template <int kDepthFunc>
+static bool spanDepthTest(const unsigned int *pz, int count, unsigned int z, int dzdx) {
+	SpanVector vz = spanRamp(z, dzdx);
+	const SpanVector dz = spanSplat(4 * dzdx);
+	for (int i = 0; i < count; i += 4) {
+		if (spanAnyPass(spanDepthMask<kDepthFunc>(vz, spanLoad(pz + i))))
+			return true;
+		vz = spanAdd(vz, dz);
+	}
+	return false;
+}
+
+static bool spanDepthTest(int depthFunc, const unsigned int *pz, int count, unsigned int z, int dzdx) {
+	switch (depthFunc) {
+	case TGL_LESS:
+		return spanDepthTest<TGL_LESS>(pz, count, z, dzdx);
+	case TGL_LEQUAL:
+		return spanDepthTest<TGL_LEQUAL>(pz, count, z, dzdx);
+	default:
+		return true;
+	}
+}
+
+#endif
+
+int FrameBuffer::getSimdDepthFunc() const {
+#if defined(USE_SSE2_SPANS) || defined(USE_NEON_SPANS)
+	if (!_enableSimdSpans || pbuf.getFormat().bytesPerPixel != 4)
+		return -1;
+	if (!_depthTestEnabled)
+		return TGL_ALWAYS;
+	if (_depthFunc == TGL_LESS || _depthFunc == TGL_LEQUAL || _depthFunc == TGL_ALWAYS)
+		return _depthFunc;
+#endif
+	return -1;
+}
+
 template <bool kInterpRGB, bool kInterpZ, bool kInterpST, bool kInterpSTZ, int kDrawLogic, bool kDepthWrite, bool kAlphaTestEnabled, bool kEnableScissor, bool kBlendingEnabled>
 void FrameBuffer::fillTriangle(ZBufferPoint *p0, ZBufferPoint *p1, ZBufferPoint *p2) {
 	const Graphics::TexelBuffer *texture;
@@ -285,6 +508,10 @@ void FrameBuffer::fillTriangle(ZBufferPoint *p0, ZBufferPoint *p1, ZBufferPoint
 		pr1 = p0;
 		pr2 = p2;
 	}
+#if defined(USE_SSE2_SPANS) || defined(USE_NEON_SPANS)
+	const int simdDepthFunc = getSimdDepthFunc();
+#endif
+
 	nb_lines = p1->y - p0->y;
 	y = p0->y;
 	for (part = 0; part < 2; part++) {
@@ -367,7 +594,10 @@ void FrameBuffer::fillTriangle(ZBufferPoint *p0, ZBufferPoint *p1, ZBufferPoint
 		// we draw all the scan line of the part
 		while (nb_lines > 0) {
 			int x = x1;
-			{
+			// Nothing below the scissor rectangle can be drawn anymore
+			if (kEnableScissor && y >= _clipRectangle.bottom)
+				return;
+			if (!kEnableScissor || y >= _clipRectangle.top) {
 				if (kDrawLogic == DRAW_DEPTH_ONLY ||
 						(kDrawLogic == DRAW_FLAT && !(kInterpST || kInterpSTZ))) {
 					int pp;
@@ -491,6 +721,17 @@ void FrameBuffer::fillTriangle(ZBufferPoint *p0, ZBufferPoint *p1, ZBufferPoint
 					g = g1;
 					b = b1;
 					a = a1;
+#if defined(USE_SSE2_SPANS) || defined(USE_NEON_SPANS)
+					if (!kAlphaTestEnabled && !kBlendingEnabled && simdDepthFunc >= 0 &&
+							(!kEnableScissor || (x1 >= _clipRectangle.left && (x2 >> 16) < _clipRectangle.right))) {
+						const int pixels = fillSpanSmooth<kDepthWrite>(simdDepthFunc, (unsigned int *)pbuf.getRawBuffer(buf), pz, n + 1, pbuf.getFormat(),
+						                                               z, r, g, b, a, dzdx, drdx, dgdx, dbdx, dadx);
+						buf += pixels;
+						pz += pixels;
+						n -= pixels;
+						x += pixels;
+					}
+#endif
 					while (n >= 3) {
 						putPixelSmooth<kDepthWrite, kAlphaTestEnabled, kEnableScissor, kBlendingEnabled>(this, buf, pz, 0, x, y, z, r, g, b, a, dzdx, drdx, dgdx, dbdx, dadx);
 						putPixelSmooth<kDepthWrite, kAlphaTestEnabled, kEnableScissor, kBlendingEnabled>(this, buf, pz, 1, x, y, z, r, g, b, a, dzdx, drdx, dgdx, dbdx, dadx);
@@ -542,6 +783,20 @@ void FrameBuffer::fillTriangle(ZBufferPoint *p0, ZBufferPoint *p1, ZBufferPoint
 							fz += fndzdx;
 							zinv = (float)(1.0 / fz);
 						}
+#if defined(USE_SSE2_SPANS) || defined(USE_NEON_SPANS)
+						// Skip the texture lookups when the whole block is hidden
+						if (simdDepthFunc >= 0 && !spanDepthTest(simdDepthFunc, pz, NB_INTERP, z, dzdx)) {
+							z += NB_INTERP * dzdx;
+							s += NB_INTERP * dsdx;
+							t += NB_INTERP * dtdx;
+							if (kDrawLogic == DRAW_SMOOTH) {
+								a += NB_INTERP * dadx;
+								r += NB_INTERP * drdx;
+								g += NB_INTERP * dgdx;
+								b += NB_INTERP * dbdx;
+							}
+						} else
+#endif
 						for (int _a = 0; _a < NB_INTERP; _a++) {
 							putPixelTextureMappingPerspective<kDepthWrite, kInterpRGB, kDrawLogic == DRAW_SMOOTH, kAlphaTestEnabled, kEnableScissor, kBlendingEnabled>(this, buf, texture, wrapS, wrapT,
 							                           pz, _a, x, y, z, t, s, r, g, b, a, dzdx, dsdx, dtdx, drdx, dgdx, dbdx, dadx);
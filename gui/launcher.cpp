@@ -624,6 +624,7 @@ bool LauncherDialog::doGameDetection(const Common::String &path) {
 	// ...so let's determine a list of candidates, games that
 	// could be contained in the specified directory.
 	DetectionResults detectionResults = EngineMan.detectGames(files);
+	MD5Man.flushPersistent();
 
 	if (detectionResults.foundUnknownGames()) {
 		Common::U32String report = detectionResults.generateUnknownGameReport(false, 80);
@@ -20,6 +20,7 @@
  *
  */
 
+#include "engines/advancedDetector.h"
 #include "engines/metaengine.h"
 #include "common/algorithm.h"
 #include "common/config-manager.h"
@@ -251,6 +252,9 @@ void MassAddDialog::handleTickle() {
 	Common::U32String buf;
 
 	if (_scanStack.empty()) {
+		// Keep the hashes computed during the scan for the next detection run
+		MD5Man.flushPersistent();
+
 		// Enable the OK button
 		_okButton->setEnabled(true);
 
@@ -0,0 +1,228 @@
+#include <cxxtest/TestSuite.h>
+
+#include "audio/mixer.h"
+#include "audio/decoders/raw.h"
+#include "audio/rate.h"
+#include "common/system.h"
+
+#include "helper.h"
+#include "../null_osystem.h"
+
+class RateTestSuite : public CxxTest::TestSuite
+{
+private:
+	static void fillRandom(int16 *buf, uint len, uint32 &seed) {
+		for (uint i = 0; i < len; ++i) {
+			seed = seed * 1103515245 + 12345;
+			buf[i] = (int16)(seed >> 16);
+		}
+	}
+
+	void mixTestTemplate(bool stereo, uint frames, Audio::st_volume_t vol_l, Audio::st_volume_t vol_r) {
+		uint32 rnd = frames;
+		const uint inLen = frames * (stereo ? 2 : 1);
+		int16 *in = new int16[inLen];
+		int16 *outScalar = new int16[frames * 2];
+		int16 *outSimd = new int16[frames * 2];
+
+		fillRandom(in, inLen, rnd);
+		fillRandom(outScalar, frames * 2, rnd);
+		memcpy(outSimd, outScalar, frames * 2 * sizeof(int16));
+
+		Audio::setSimdMixing(false);
+		if (stereo)
+			Audio::mixStereoSamples(outScalar, in, frames, vol_l, vol_r);
+		else
+			Audio::mixMonoSamples(outScalar, in, frames, vol_l, vol_r);
+
+		Audio::setSimdMixing(true);
+		if (stereo)
+			Audio::mixStereoSamples(outSimd, in, frames, vol_l, vol_r);
+		else
+			Audio::mixMonoSamples(outSimd, in, frames, vol_l, vol_r);
+
+		TS_ASSERT_EQUALS(memcmp(outScalar, outSimd, frames * 2 * sizeof(int16)), 0);
+
+		delete[] in;
+		delete[] outScalar;
+		delete[] outSimd;
+	}
+
+	void converterTestTemplate(int inRate, int outRate, bool stereo, bool reverseStereo) {
+		int16 *out[2];
+
+		for (int simd = 0; simd < 2; ++simd) {
+			Audio::setSimdMixing(simd != 0);
+
+			Audio::SeekableAudioStream *s = createSineStream<int16>(inRate, 1, nullptr, false, stereo);
+			Audio::RateConverter *converter = Audio::makeRateConverter(inRate, outRate, stereo, reverseStereo);
+
+			out[simd] = new int16[outRate * 2];
+			memset(out[simd], 0, outRate * 2 * sizeof(int16));
+			// Use an odd chunk size, so that the scalar tails are exercised too
+			for (int pos = 0; pos < outRate; pos += 1021)
+				converter->flow(*s, out[simd] + pos * 2, MIN(1021, outRate - pos), 200, 120);
+
+			delete converter;
+			delete s;
+		}
+
+		TS_ASSERT_EQUALS(memcmp(out[0], out[1], outRate * 2 * sizeof(int16)), 0);
+
+		delete[] out[0];
+		delete[] out[1];
+	}
+
+	static Audio::SeekableAudioStream *createConstantStream(int rate, int seconds, int16 value) {
+		const int samples = rate * seconds;
+		int16 *data = (int16 *)malloc(samples * sizeof(int16));
+		for (int i = 0; i < samples; ++i)
+			data[i] = TO_BE_16(value);
+		return Audio::makeRawStream((const byte *)data, samples * sizeof(int16), rate, Audio::FLAG_16BITS);
+	}
+
+	uint32 benchmarkConverter(bool highQuality, int inRate, int outRate, bool stereo, int16 *out, int frames) {
+		Audio::SeekableAudioStream *s = createSineStream<int16>(inRate, 10, nullptr, false, stereo);
+		Audio::RateConverter *converter = Audio::makeRateConverter(inRate, outRate, stereo, false, highQuality);
+
+		const uint32 start = g_system->getMillis();
+		for (int pos = 0; pos < outRate * 10; pos += frames)
+			converter->flow(*s, out, frames, 256, 256);
+		const uint32 time = g_system->getMillis() - start;
+
+		delete converter;
+		delete s;
+		return time;
+	}
+
+	uint32 benchmarkMix(bool simd, bool stereo, const int16 *in, int16 *out, uint frames, int iterations) {
+		Audio::setSimdMixing(simd);
+
+		const uint32 start = g_system->getMillis();
+		for (int i = 0; i < iterations; ++i) {
+			if (stereo)
+				Audio::mixStereoSamples(out, in, frames, 200, 180);
+			else
+				Audio::mixMonoSamples(out, in, frames, 200, 180);
+		}
+		return g_system->getMillis() - start;
+	}
+
+public:
+	void test_mix_stereo() {
+		mixTestTemplate(true, 4096, 256, 256);
+		mixTestTemplate(true, 4093, 200, 13);
+		mixTestTemplate(true, 3, 1, 255);
+		mixTestTemplate(true, 1000, 0, 0);
+	}
+
+	void test_mix_mono() {
+		mixTestTemplate(false, 4096, 256, 256);
+		mixTestTemplate(false, 4093, 200, 13);
+		mixTestTemplate(false, 7, 1, 255);
+		mixTestTemplate(false, 1000, 0, 0);
+	}
+
+	void test_mix_large_volume() {
+		// Volumes above kMaxMixerVolume fall back to the scalar code
+		mixTestTemplate(true, 1024, 1000, 300);
+		mixTestTemplate(false, 1024, 300, 1000);
+	}
+
+	void test_converters() {
+		converterTestTemplate(22050, 22050, false, false);
+		converterTestTemplate(22050, 22050, true, false);
+		converterTestTemplate(22050, 22050, true, true);
+		converterTestTemplate(44100, 22050, false, false);
+		converterTestTemplate(44100, 22050, true, true);
+		converterTestTemplate(11025, 48000, false, false);
+		converterTestTemplate(11025, 48000, true, false);
+		converterTestTemplate(11025, 48000, true, true);
+	}
+
+	void test_polyphase_constant() {
+		// A constant signal must pass through unchanged once the filter is filled
+		static const int rates[][2] = { { 11025, 48000 }, { 22050, 44100 }, { 44100, 22050 }, { 48000, 44100 } };
+
+		for (int i = 0; i < ARRAYSIZE(rates); ++i) {
+			Audio::SeekableAudioStream *s = createConstantStream(rates[i][0], 1, 10000);
+			Audio::RateConverter *converter = Audio::makeRateConverter(rates[i][0], rates[i][1], false, false, true);
+
+			const int frames = rates[i][1] / 2;
+			int16 *out = new int16[frames * 2];
+			memset(out, 0, frames * 2 * sizeof(int16));
+			TS_ASSERT_EQUALS(converter->flow(*s, out, frames, 256, 256), frames);
+
+			for (int j = frames / 2; j < frames * 2; ++j)
+				TS_ASSERT_DELTA(out[j], 10000, 4);
+
+			delete[] out;
+			delete converter;
+			delete s;
+		}
+	}
+
+	void test_polyphase_sine_amplitude() {
+		// A tone well below the Nyquist frequency must keep its amplitude
+		Audio::SeekableAudioStream *s = createSineStream<int16>(11025, 1, nullptr, false, false);
+		Audio::RateConverter *converter = Audio::makeRateConverter(11025, 48000, false, false, true);
+
+		int16 *out = new int16[48000 * 2];
+		memset(out, 0, 48000 * 2 * sizeof(int16));
+		converter->flow(*s, out, 48000, 256, 256);
+
+		int16 peak = 0;
+		for (int j = 24000; j < 48000 * 2; ++j)
+			peak = MAX(peak, out[j]);
+		TS_ASSERT_DELTA(peak, 32767, 400);
+
+		delete[] out;
+		delete converter;
+		delete s;
+	}
+
+	// Only reports timings, so it is only run by 'make test-benchmark'
+	void test_polyphase_benchmark() {
+#ifdef TEST_BENCHMARKS
+		Common::install_null_g_system();
+
+		const int frames = 1024;
+		int16 *out = new int16[frames * 2];
+
+		for (int stereo = 0; stereo < 2; ++stereo) {
+			const uint32 linearTime = benchmarkConverter(false, 11025, 48000, stereo, out, frames);
+			const uint32 polyphaseTime = benchmarkConverter(true, 11025, 48000, stereo, out, frames);
+			TS_TRACE(Common::String::format("%s 11025 Hz to 48000 Hz, 10 seconds: linear %u ms, polyphase %u ms",
+				stereo ? "Stereo" : "Mono", linearTime, polyphaseTime).c_str());
+		}
+
+		delete[] out;
+#endif
+	}
+
+	// Only reports timings, so it is only run by 'make test-benchmark'
+	void test_mix_benchmark() {
+#ifdef TEST_BENCHMARKS
+		Common::install_null_g_system();
+
+		const uint frames = 4096;
+		const int iterations = 2000;
+		uint32 rnd = 1;
+		int16 *in = new int16[frames * 2];
+		int16 *out = new int16[frames * 2];
+		fillRandom(in, frames * 2, rnd);
+		memset(out, 0, frames * 2 * sizeof(int16));
+
+		for (int stereo = 0; stereo < 2; ++stereo) {
+			const uint32 scalarTime = benchmarkMix(false, stereo, in, out, frames, iterations);
+			const uint32 simdTime = benchmarkMix(true, stereo, in, out, frames, iterations);
+			TS_TRACE(Common::String::format("%s mixing of %d x %u frames: scalar %u ms, SIMD %u ms",
+				stereo ? "Stereo" : "Mono", iterations, frames, scalarTime, simdTime).c_str());
+		}
+
+		delete[] in;
+		delete[] out;
+		Audio::setSimdMixing(true);
+#endif
+	}
+};
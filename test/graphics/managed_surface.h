@@ -0,0 +1,221 @@
+#include <cxxtest/TestSuite.h>
+
+#include "graphics/managed_surface.h"
+#include "common/system.h"
+
+#include "../null_osystem.h"
+
+class ManagedSurfaceTestSuite : public CxxTest::TestSuite
+{
+private:
+	enum Kernels {
+		kGeneric,
+		kSpecialized,
+		kSimd
+	};
+
+	static void setKernels(Kernels kernels) {
+		Graphics::setTransBlitKernels(kernels != kGeneric, kernels == kSimd);
+	}
+
+	static uint32 nextRandom(uint32 &seed) {
+		seed = seed * 1103515245 + 12345;
+		return seed >> 8;
+	}
+
+	/**
+	 * Fill a surface with random pixels. Pixels come in runs, so that the
+	 * transparent color and the alpha values are not evenly mixed.
+	 */
+	static void fillSurface(Graphics::ManagedSurface &surf, uint32 &seed, uint32 transColor) {
+		const Graphics::PixelFormat &format = surf.format;
+		for (int y = 0; y < surf.h; ++y) {
+			for (int x = 0; x < surf.w; ++x) {
+				uint32 color = nextRandom(seed) & 0xFFFFFF;
+				if (format.bytesPerPixel == 1)
+					color &= 0xFF;
+
+				const uint run = (x / 8 + y) % 5;
+				if (run == 0)
+					color = transColor;
+
+				if (format.bytesPerPixel == 1) {
+					surf.setPixel(x, y, color);
+					continue;
+				}
+
+				if (run != 0 && format.aBits()) {
+					byte a = 0xff, r, g, b;
+					format.colorToRGB(color, r, g, b);
+					if (run == 1)
+						a = 0;
+					else if (run == 2)
+						a = nextRandom(seed) & 0xff;
+					color = format.ARGBToColor(a, r, g, b);
+				} else if (run != 0) {
+					// Include the bits which are not part of the format
+					color = nextRandom(seed) ^ (nextRandom(seed) << 16);
+				}
+				surf.setPixel(x, y, color);
+			}
+		}
+	}
+
+	static void fillPalette(Graphics::ManagedSurface &surf, uint32 seed) {
+		byte palette[256 * 3];
+		for (int i = 0; i < 256 * 3; ++i)
+			palette[i] = nextRandom(seed) & 0xff;
+		surf.setPalette(palette, 0, 256);
+	}
+
+	/**
+	 * Blit with all kernels and compare the results.
+	 *
+	 * @param palettes 0 for no palettes, 1 for identical palettes, 2 for different ones
+	 * @param destTransColor transparent color of the destination, used when destTrans is set
+	 */
+	void compareKernels(const Graphics::PixelFormat &format, uint32 transColor, int palettes, bool destTrans, uint32 destTransColor = 0) {
+		static const int positions[][2] = { { 0, 0 }, { 13, 7 }, { -21, -3 }, { 290, 180 }, { -5, 190 } };
+
+		Graphics::ManagedSurface src(67, 45, format);
+		Graphics::ManagedSurface dest[3];
+		uint32 seed = 1;
+
+		fillSurface(src, seed, transColor);
+		if (palettes)
+			fillPalette(src, 3);
+
+		for (int kernels = kGeneric; kernels <= kSimd; ++kernels) {
+			dest[kernels].create(320, 200, format);
+			uint32 destSeed = 2;
+			fillSurface(dest[kernels], destSeed, destTransColor);
+			if (palettes)
+				fillPalette(dest[kernels], palettes == 1 ? 3 : 4);
+			if (destTrans)
+				dest[kernels].setTransparentColor(destTransColor ? destTransColor : format.RGBToColor(0, 0, 0));
+
+			setKernels((Kernels)kernels);
+			for (int i = 0; i < ARRAYSIZE(positions); ++i) {
+				for (int flipped = 0; flipped < 2; ++flipped) {
+					const Common::Point pos(positions[i][0], positions[i][1]);
+					dest[kernels].transBlitFrom(src, Common::Rect(0, 0, src.w, src.h), pos, transColor, flipped != 0);
+					dest[kernels].transBlitFrom(src, Common::Rect(5, 3, 60, 40), pos + Common::Point(3, 5), transColor, flipped != 0);
+				}
+			}
+		}
+
+		for (int kernels = kSpecialized; kernels <= kSimd; ++kernels) {
+			for (int y = 0; y < dest[kGeneric].h; ++y) {
+				TS_ASSERT_EQUALS(memcmp(dest[kGeneric].getBasePtr(0, y), dest[kernels].getBasePtr(0, y),
+					dest[kGeneric].w * format.bytesPerPixel), 0);
+			}
+		}
+
+		setKernels(kSimd);
+	}
+
+	uint32 benchmarkBlit(Kernels kernels, const Graphics::PixelFormat &format, uint32 transColor, int iterations) {
+		Graphics::ManagedSurface src(64, 64, format);
+		Graphics::ManagedSurface dest(640, 480, format);
+		uint32 seed = 1;
+		fillSurface(src, seed, transColor);
+		fillSurface(dest, seed, 0);
+
+		setKernels(kernels);
+		const uint32 start = g_system->getMillis();
+		for (int i = 0; i < iterations; ++i)
+			dest.transBlitFrom(src, Common::Point((i * 37) % 600 - 20, (i * 23) % 440 - 20), transColor);
+		const uint32 time = g_system->getMillis() - start;
+		setKernels(kSimd);
+		return time;
+	}
+
+public:
+	void test_keyed_8bpp() {
+		compareKernels(Graphics::PixelFormat::createFormatCLUT8(), 0, 0, false);
+		compareKernels(Graphics::PixelFormat::createFormatCLUT8(), 0x1F3, 0, true);
+	}
+
+	void test_keyed_8bpp_palette() {
+		compareKernels(Graphics::PixelFormat::createFormatCLUT8(), 7, 1, false);
+		compareKernels(Graphics::PixelFormat::createFormatCLUT8(), 7, 2, false);
+	}
+
+	void test_keyed_16bpp() {
+		compareKernels(Graphics::PixelFormat(2, 5, 6, 5, 0, 11, 5, 0, 0), 0xF81F, 0, false);
+		compareKernels(Graphics::PixelFormat(2, 5, 5, 5, 0, 10, 5, 0, 0), 0, 0, true);
+	}
+
+	void test_keyed_32bpp() {
+		compareKernels(Graphics::PixelFormat(4, 8, 8, 8, 0, 16, 8, 0, 0), 0xFF00FF, 0, false);
+	}
+
+	void test_alpha_32bpp() {
+		compareKernels(Graphics::PixelFormat(4, 8, 8, 8, 8, 24, 16, 8, 0), 0, 0, false);
+		compareKernels(Graphics::PixelFormat(4, 8, 8, 8, 8, 24, 16, 8, 0), 0xFF00FF, 0, true);
+		compareKernels(Graphics::PixelFormat(4, 8, 8, 8, 8, 0, 8, 16, 24), 0x123456, 0, false);
+
+		const Graphics::PixelFormat format(4, 8, 8, 8, 8, 24, 16, 8, 0);
+		compareKernels(format, 0, 0, true, format.ARGBToColor(0x80, 0x20, 0x40, 0x60));
+	}
+
+	void test_alpha_32bpp_dest_trans() {
+		// Destination pixels matching the transparent color are cleared
+		// before blending, even under fully transparent source pixels
+		const Graphics::PixelFormat format(4, 8, 8, 8, 8, 24, 16, 8, 0);
+		const byte alphas[] = { 0, 0x80, 0xff, 0, 0, 0, 0, 0, 0x40, 0, 0xff, 0 };
+		const uint32 destKey = format.ARGBToColor(0xff, 0x20, 0x40, 0x60);
+		const uint32 other = format.ARGBToColor(0xff, 0x90, 0x90, 0x90);
+
+		Graphics::ManagedSurface src(ARRAYSIZE(alphas), 1, format);
+		for (int x = 0; x < src.w; ++x)
+			src.setPixel(x, 0, format.ARGBToColor(alphas[x], 0xc0, 0x10, 0x30));
+
+		Graphics::ManagedSurface dest[3];
+		for (int kernels = kGeneric; kernels <= kSimd; ++kernels) {
+			dest[kernels].create(src.w, 1, format);
+			for (int x = 0; x < src.w; ++x)
+				dest[kernels].setPixel(x, 0, x == 5 ? other : destKey);
+			dest[kernels].setTransparentColor(destKey);
+
+			setKernels((Kernels)kernels);
+			dest[kernels].transBlitFrom(src, Common::Point(0, 0));
+		}
+		setKernels(kSimd);
+
+		for (int x = 0; x < src.w; ++x) {
+			const uint32 expected = dest[kGeneric].getPixel(x, 0);
+			if (alphas[x] == 0)
+				TS_ASSERT_EQUALS(expected, x == 5 ? other : 0);
+			TS_ASSERT_EQUALS(dest[kSpecialized].getPixel(x, 0), expected);
+			TS_ASSERT_EQUALS(dest[kSimd].getPixel(x, 0), expected);
+		}
+	}
+
+	// Only reports timings, so it is only run by 'make test-benchmark'
+	void test_benchmark() {
+#ifdef TEST_BENCHMARKS
+		Common::install_null_g_system();
+
+		const struct {
+			const char *name;
+			Graphics::PixelFormat format;
+			uint32 transColor;
+		} cases[] = {
+			{ "8bpp keyed", Graphics::PixelFormat::createFormatCLUT8(), 0 },
+			{ "16bpp keyed", Graphics::PixelFormat(2, 5, 6, 5, 0, 11, 5, 0, 0), 0xF81F },
+			{ "32bpp keyed", Graphics::PixelFormat(4, 8, 8, 8, 0, 16, 8, 0, 0), 0xFF00FF },
+			{ "32bpp alpha", Graphics::PixelFormat(4, 8, 8, 8, 8, 24, 16, 8, 0), 0 }
+		};
+		const int iterations = 5000;
+
+		for (int i = 0; i < ARRAYSIZE(cases); ++i) {
+			const uint32 genericTime = benchmarkBlit(kGeneric, cases[i].format, cases[i].transColor, iterations);
+			const uint32 specializedTime = benchmarkBlit(kSpecialized, cases[i].format, cases[i].transColor, iterations);
+			const uint32 simdTime = benchmarkBlit(kSimd, cases[i].format, cases[i].transColor, iterations);
+			TS_TRACE(Common::String::format("%s, %d blits of 64x64: generic %u ms, specialized %u ms, SIMD %u ms",
+				cases[i].name, iterations, genericTime, specializedTime, simdTime).c_str());
+		}
+#endif
+	}
+};
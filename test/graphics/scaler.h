@@ -0,0 +1,158 @@
+#include <cxxtest/TestSuite.h>
+
+#include "graphics/scalerplugin.h"
+#include "graphics/scaler/dotmatrix.h"
+#include "graphics/scaler/normal.h"
+#include "graphics/scaler/pm.h"
+#include "graphics/scaler/sai.h"
+#include "graphics/scaler/scalebit.h"
+#include "graphics/scaler/tv.h"
+#ifdef USE_HQ_SCALERS
+#include "graphics/scaler/hq.h"
+#endif
+
+/**
+ * Runs the bands serially and in reverse order, so that any dependency
+ * between neighbouring bands shows up as a difference in the output.
+ */
+class ReverseBandRunner : public ScalerBandRunner {
+public:
+	ReverseBandRunner(uint bands) : _bands(bands), _calls(0) {}
+
+	virtual uint getBandCount() const override { return _bands; }
+
+	virtual void run(BandFunc func, void *data, uint count) override {
+		TS_ASSERT_LESS_THAN_EQUALS(count, _bands);
+		for (uint band = count; band-- > 0;)
+			func(data, band);
+		++_calls;
+	}
+
+	uint _bands;
+	uint _calls;
+};
+
+class ScalerTestSuite : public CxxTest::TestSuite
+{
+private:
+	static const int kWidth = 320;
+	static const int kHeight = 200;
+	static const int kPadding = 4;
+
+	void compareBands(ScalerPluginObject &scaler, const Graphics::PixelFormat &format, int x, int y, int width, int height) {
+		scaler.initialize(format);
+		TS_ASSERT(scaler.canScaleInBands());
+		TS_ASSERT_LESS_THAN_EQUALS(scaler.extraPixels(), (uint)kPadding);
+
+		const uint bpp = format.bytesPerPixel;
+		const uint srcPitch = (kWidth + kPadding * 2) * bpp;
+		byte *src = new byte[srcPitch * (kHeight + kPadding * 2)];
+		uint32 seed = 1;
+		for (uint i = 0; i < srcPitch * (kHeight + kPadding * 2); ++i) {
+			seed = seed * 1103515245 + 12345;
+			// Use few distinct values, so that the scalers find edges
+			src[i] = (seed >> 16) & 0xC3;
+		}
+		const byte *srcPtr = src + (kPadding + y) * srcPitch + (kPadding + x) * bpp;
+
+		const Common::Array<uint> &factors = scaler.getFactors();
+		for (uint i = 0; i < factors.size(); ++i) {
+			const uint factor = factors[i];
+			scaler.setFactor(factor);
+
+			const uint dstPitch = width * factor * bpp;
+			const uint dstSize = dstPitch * height * factor;
+			byte *serial = new byte[dstSize];
+			byte *banded = new byte[dstSize];
+			memset(serial, 0, dstSize);
+			memset(banded, 0, dstSize);
+
+			scaler.setBandRunner(nullptr);
+			scaler.scale(srcPtr, srcPitch, serial, dstPitch, width, height, x, y);
+
+			ReverseBandRunner runner(5);
+			scaler.setBandRunner(&runner);
+			scaler.scale(srcPtr, srcPitch, banded, dstPitch, width, height, x, y);
+			scaler.setBandRunner(nullptr);
+
+			TS_ASSERT_EQUALS(runner._calls, factor == 1 ? 0U : 1U);
+			TS_ASSERT_EQUALS(memcmp(serial, banded, dstSize), 0);
+
+			delete[] serial;
+			delete[] banded;
+		}
+
+		delete[] src;
+		scaler.deinitialize();
+	}
+
+	void compareBands(ScalerPluginObject &scaler) {
+		const Graphics::PixelFormat formats[] = {
+			Graphics::PixelFormat(2, 5, 6, 5, 0, 11, 5, 0, 0),
+			Graphics::PixelFormat(4, 8, 8, 8, 8, 24, 16, 8, 0)
+		};
+
+		for (int i = 0; i < ARRAYSIZE(formats); ++i) {
+			compareBands(scaler, formats[i], 0, 0, kWidth, kHeight);
+			// Odd rect, so that the bands have different heights
+			compareBands(scaler, formats[i], 17, 9, 150, 101);
+		}
+	}
+
+public:
+	void test_normal_bands() {
+		NormalPlugin scaler;
+		compareBands(scaler);
+	}
+
+	void test_advmame_bands() {
+		AdvMamePlugin scaler;
+		compareBands(scaler);
+	}
+
+	void test_sai_bands() {
+		SAIPlugin sai;
+		compareBands(sai);
+		SuperSAIPlugin superSai;
+		compareBands(superSai);
+		SuperEaglePlugin superEagle;
+		compareBands(superEagle);
+	}
+
+	void test_tv_bands() {
+		TVPlugin scaler;
+		compareBands(scaler);
+	}
+
+	void test_dotmatrix_bands() {
+		DotMatrixPlugin scaler;
+		compareBands(scaler);
+	}
+
+	void test_pm_bands() {
+		PMPlugin scaler;
+		compareBands(scaler);
+	}
+
+#if defined(USE_HQ_SCALERS) && !defined(USE_NASM)
+	void test_hq_bands() {
+		HQPlugin scaler;
+		compareBands(scaler);
+	}
+#endif
+
+	void test_small_rects_are_not_banded() {
+		NormalPlugin scaler;
+		scaler.initialize(Graphics::PixelFormat(2, 5, 6, 5, 0, 11, 5, 0, 0));
+		scaler.setFactor(2);
+
+		uint16 src[20 * 20];
+		uint16 dst[40 * 40];
+		memset(src, 0, sizeof(src));
+
+		ReverseBandRunner runner(4);
+		scaler.setBandRunner(&runner);
+		scaler.scale((const uint8 *)src, 20 * 2, (uint8 *)dst, 40 * 2, 20, 20, 0, 0);
+		TS_ASSERT_EQUALS(runner._calls, 0U);
+	}
+};
@@ -0,0 +1,124 @@
+#include <cxxtest/TestSuite.h>
+
+#include "graphics/tinygl/zgl.h"
+
+#include "../null_osystem.h"
+
+class TinyGLTestSuite : public CxxTest::TestSuite
+{
+private:
+	static const int kWidth = 320;
+	static const int kHeight = 200;
+
+	static float randomCoord(uint32 &seed, int range) {
+		seed = seed * 1103515245 + 12345;
+		// Let some vertices fall outside of the screen
+		return (float)((int)((seed >> 8) % (range + 80)) - 40);
+	}
+
+	static byte randomByte(uint32 &seed) {
+		seed = seed * 1103515245 + 12345;
+		return (byte)(seed >> 16);
+	}
+
+	static void drawScene(uint32 seed) {
+		byte texels[64 * 64 * 4];
+		for (int i = 0; i < ARRAYSIZE(texels); ++i)
+			texels[i] = randomByte(seed);
+		TGLuint texture;
+		tglGenTextures(1, &texture);
+		tglBindTexture(TGL_TEXTURE_2D, texture);
+		tglTexImage2D(TGL_TEXTURE_2D, 0, TGL_RGBA, 64, 64, 0, TGL_RGBA, TGL_UNSIGNED_BYTE, texels);
+
+		tglMatrixMode(TGL_PROJECTION);
+		tglLoadIdentity();
+		tglOrtho(0, kWidth, kHeight, 0, -1, 1);
+		tglMatrixMode(TGL_MODELVIEW);
+		tglLoadIdentity();
+
+		tglClearColor(0.f, 0.f, 0.5f, 1.f);
+		tglClear(TGL_COLOR_BUFFER_BIT | TGL_DEPTH_BUFFER_BIT);
+		tglEnable(TGL_DEPTH_TEST);
+		tglShadeModel(TGL_SMOOTH);
+		tglBlendFunc(TGL_SRC_ALPHA, TGL_ONE_MINUS_SRC_ALPHA);
+
+		for (int i = 0; i < 200; ++i) {
+			if (i % 3 == 0)
+				tglEnable(TGL_BLEND);
+			else
+				tglDisable(TGL_BLEND);
+			if (i % 4 == 1)
+				tglEnable(TGL_TEXTURE_2D);
+			else
+				tglDisable(TGL_TEXTURE_2D);
+			tglDepthFunc(i % 5 == 2 ? TGL_LEQUAL : TGL_LESS);
+
+			tglBegin(i % 10 == 0 ? TGL_LINE_LOOP : TGL_TRIANGLES);
+			for (int v = 0; v < 3; ++v) {
+				tglColor4ub(randomByte(seed), randomByte(seed), randomByte(seed), randomByte(seed));
+				tglTexCoord2f(randomByte(seed) / 128.f, randomByte(seed) / 128.f);
+				tglVertex3f(randomCoord(seed, kWidth), randomCoord(seed, kHeight), (float)(randomByte(seed) - 128) / 256.f);
+			}
+			tglEnd();
+		}
+
+		tglDisable(TGL_TEXTURE_2D);
+		tglDisable(TGL_BLEND);
+		tglDisable(TGL_DEPTH_TEST);
+		tglDeleteTextures(1, &texture);
+	}
+
+	static byte *renderScene(bool dirtyRects, bool simd = true) {
+		TinyGL::FrameBuffer *fb = new TinyGL::FrameBuffer(kWidth, kHeight, Graphics::PixelFormat(4, 8, 8, 8, 8, 0, 8, 16, 24));
+		TinyGL::glInit(fb, 256);
+		tglEnableDirtyRects(dirtyRects);
+		tglEnableSimdSpans(simd);
+
+		drawScene(1);
+		TinyGL::tglPresentBuffer();
+
+		TinyGL::FrameStats stats;
+		TinyGL::tglGetFrameStats(stats);
+		TS_ASSERT(stats.drawCalls > 0);
+		if (dirtyRects) {
+			TS_ASSERT(stats.rectangles > 0);
+		} else {
+			TS_ASSERT_EQUALS(stats.executedCalls, stats.drawCalls);
+		}
+
+		byte *pixels = new byte[kWidth * kHeight * 4];
+		memcpy(pixels, fb->getPixelBuffer(), kWidth * kHeight * 4);
+
+		TinyGL::glClose();
+		delete fb;
+		return pixels;
+	}
+
+public:
+	void test_dirty_rects() {
+		Common::install_null_g_system();
+
+		byte *reference = renderScene(false);
+		byte *dirtyRects = renderScene(true);
+
+		TS_ASSERT_EQUALS(memcmp(reference, dirtyRects, kWidth * kHeight * 4), 0);
+
+		delete[] reference;
+		delete[] dirtyRects;
+	}
+
+	void test_simd_spans() {
+		Common::install_null_g_system();
+
+		byte *scalar = renderScene(false, false);
+		byte *simd = renderScene(false, true);
+		byte *dirtyRectsSimd = renderScene(true, true);
+
+		TS_ASSERT_EQUALS(memcmp(scalar, simd, kWidth * kHeight * 4), 0);
+		TS_ASSERT_EQUALS(memcmp(scalar, dirtyRectsSimd, kWidth * kHeight * 4), 0);
+
+		delete[] scalar;
+		delete[] simd;
+		delete[] dirtyRectsSimd;
+	}
+};
@@ -30,6 +30,16 @@ endif
 
 TEST_LIBS +=	audio/libaudio.a math/libmath.a common/libcommon.a image/libimage.a graphics/libgraphics.a
 
+TESTS += $(srcdir)/test/graphics/managed_surface.h
+
+ifdef USE_TINYGL
+	TESTS += $(srcdir)/test/graphics/tinygl.h
+endif
+
+ifdef USE_SCALERS
+	TESTS += $(srcdir)/test/graphics/scaler.h
+endif
+
 ifeq ($(ENABLE_WINTERMUTE), STATIC_PLUGIN)
 	TESTS += $(srcdir)/test/engines/wintermute/*.h
 	TEST_LIBS += engines/wintermute/libwintermute.a
@@ -69,13 +79,19 @@ test: test/runner
 	./test/runner
 test/runner: test/runner.cpp $(TEST_LIBS) copy-dat
 	+$(QUIET_CXX)$(LD) $(TEST_CXXFLAGS) $(CPPFLAGS) $(TEST_CFLAGS) -o $@ test/runner.cpp $(TEST_LIBS) $(TEST_LDFLAGS)
+
+# Same tests, plus the benchmarks which only report timings
+test-benchmark: test/benchmark-runner
+	./test/benchmark-runner
+test/benchmark-runner: test/runner.cpp $(TEST_LIBS) copy-dat
+	+$(QUIET_CXX)$(LD) $(TEST_CXXFLAGS) -DTEST_BENCHMARKS $(CPPFLAGS) $(TEST_CFLAGS) -o $@ test/runner.cpp $(TEST_LIBS) $(TEST_LDFLAGS)
 test/runner.cpp: $(TESTS) $(srcdir)/test/module.mk
 	@mkdir -p test
 	$(srcdir)/test/cxxtest/cxxtestgen.py $(TEST_FLAGS) -o $@ $+
 
 clean: clean-test
 clean-test:
-	-$(RM) test/runner.cpp test/runner test/engine-data/encoding.dat
+	-$(RM) test/runner.cpp test/runner test/benchmark-runner test/engine-data/encoding.dat
 	-rmdir test/engine-data
 
 test/engine-data/encoding.dat: $(srcdir)/dists/engine-data/encoding.dat
@@ -84,4 +100,4 @@ test/engine-data/encoding.dat: $(srcdir)/dists/engine-data/encoding.dat
 
 copy-dat: test/engine-data/encoding.dat
 
-.PHONY: test clean-test copy-dat
+.PHONY: test test-benchmark clean-test copy-dat